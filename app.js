@@ -1,7 +1,15 @@
 'use strict'
 
-// C library API
-const ffi = require('ffi');
+// Parser jobs share the libuv threadpool with fs - One thread more than the parser may use keeps sendFile/unlink moving
+// (Must be set before the threadpool is first used)
+const os = require('os');
+const parserConcurrency = os.cpus().length;
+if (process.env.UV_THREADPOOL_SIZE === undefined) {
+    process.env.UV_THREADPOOL_SIZE = String(parserConcurrency + 1);
+}
+
+// C library API (Native addon built from parser/src by binding.gyp during npm install)
+const parser = require('./build/Release/vcardparser.node');
 
 // Express App (Routes)
 const express = require("express");
@@ -73,13 +81,16 @@ app.get('/uploads/:name', function (req, res) {
 //******************** Your code goes here ********************
 
 /**
- * sharedLib = parser library
- * Declare all functions of shared library here
+ * parser = parser library
+ * Every function parses on the libuv threadpool and returns a Promise of a Buffer of JSON (null where the C function returns NULL):
+ * getFileLog(file), getFileLogs([file, ...]) (Array of Buffers), getCardView(file), getFileDiagnostics(file), parseDirectory(dir, threads)
+ * Routes go through queueParse, so at most parserConcurrency parser threads run at once and the rest wait in a bounded queue
  */
-let sharedLib = ffi.Library('./parserlib.so', {
-    'getFileLog' : [ 'string', [ 'string' ] ],
-    'getCardView' : [ 'string', [ 'string' ] ]
-});
+
+//Parses waiting for a free slot. Once maxQueuedParses are waiting, new requests get 503 instead of a longer wait
+const maxQueuedParses = 256;
+let runningParses = 0;
+let queuedParses = [];
 
 //Returns JSON of all files in uploads directory
 app.get('/uploadDirectory', function (req, res) {
@@ -90,27 +101,158 @@ app.get('/uploadDirectory', function (req, res) {
 //Returns JSON of card view
 app.get('/cardView', function (req, res) {
     let currentFile = "uploads/" + req.query.file;
-    let currentCardView = sharedLib.getCardView(currentFile);
-    if (currentCardView != null) {
-        res.send(currentCardView);
+    //The diagnostics of an invalid file are read in the same slot
+    let parse = queueParse(req, function () {
+        return parser.getCardView(currentFile).then(function (currentCardView) {
+            if (currentCardView != null) {
+                return { cardView: currentCardView };
+            }
+            return parser.getFileDiagnostics(currentFile).then(function (diagnostics) {
+                return { diagnostics: diagnostics };
+            });
+        });
+    });
+    if (parse == null) {
+        sendBusy(res);
+        return;
     }
+
+    parse.then(function (result) {
+        if (result.cardView != null) {
+            res.type('json').send(result.cardView);
+            return;
+        }
+        res.status(400).type('json').send(result.diagnostics != null ? result.diagnostics : '[]');
+    }).catch(function (err) {
+        res.status(500).send(err.message);
+    });
 });
 
 //Returns JSON of file log
 app.get('/fileLog', function (req, res) {
     let currentFile = "uploads/" + req.query.file;
-    let currentFileLog = sharedLib.getFileLog(currentFile);
-    if (currentFileLog != null) {
-        res.send(currentFileLog);
+    //The diagnostics of an invalid file are read in the same slot
+    let parse = queueParse(req, function () {
+        return parser.getFileLog(currentFile).then(function (currentFileLog) {
+            if (currentFileLog != null) {
+                return { fileLog: currentFileLog };
+            }
+            return parser.getFileDiagnostics(currentFile).then(function (diagnostics) {
+                return { diagnostics: diagnostics };
+            });
+        });
+    });
+    if (parse == null) {
+        sendBusy(res);
+        return;
     }
-    else {
-        fs.unlinkSync(currentFile);
+
+    parse.then(function (result) {
+        if (result.fileLog != null) {
+            res.type('json').send(result.fileLog);
+            return;
+        }
+
+        //Keep a record of why the file was rejected before removing it
+        console.log('Removing invalid file ' + currentFile + ': ' + result.diagnostics);
+        fs.unlink(currentFile, function (err) {
+            //An overlapping request may have removed it already
+            if (err != null && err.code !== 'ENOENT') {
+                console.log('Could not remove ' + currentFile + ': ' + err.message);
+            }
+        });
+        res.status(400).type('json').send(result.diagnostics != null ? result.diagnostics : '[]');
+    }).catch(function (err) {
+        res.status(500).send(err.message);
+    });
+});
+
+//Returns JSON of the file logs of every file in the uploads directory
+app.get('/fileLogs', function (req, res) {
+    //Parse the whole directory with one thread per slot that is free when it starts
+    let parse = queueParse(req, function (slots) {
+        return parser.parseDirectory('uploads', slots);
+    }, true);
+    if (parse == null) {
+        sendBusy(res);
+        return;
     }
+
+    parse.then(function (directoryLog) {
+        if (directoryLog == null) {
+            res.send([]);
+            return;
+        }
+
+        //Invalid files are only left out - A listing must not remove files, some may still be being uploaded
+        let fileLogs = JSON.parse(directoryLog);
+        let validFileLogs = [];
+        for (let i in fileLogs) {
+            if (fileLogs[i].valid) {
+                validFileLogs.push(fileLogs[i]);
+            }
+        }
+        res.send(validFileLogs);
+    }).catch(function (err) {
+        res.status(500).send(err.message);
+    });
 });
 
 //Listen on given port number
 app.listen(portNum);
 
+/**
+ * queueParse: Runs a parser call once a slot is free (parserConcurrency slots, one per parser thread)
+ * Calls for requests whose client has gone away by then are skipped
+ * Param req: The request the call is for
+ * Param call: Function starting the parser call, returning its Promise. Called with the number of slots the call holds
+ * Param allFreeSlots: true to take every slot free when the call starts (For calls running their own threads), otherwise one
+ * Return: A Promise of the call's result, or null if the queue is full (Reply with sendBusy)
+ */
+function queueParse(req, call, allFreeSlots) {
+    if (runningParses >= parserConcurrency && queuedParses.length >= maxQueuedParses) {
+        return null;
+    }
+
+    return new Promise(function (resolve, reject) {
+        queuedParses.push({ req: req, call: call, allFreeSlots: allFreeSlots === true, resolve: resolve, reject: reject });
+        startQueuedParses();
+    });
+}
+
+/**
+ * startQueuedParses: Starts waiting parser calls while there are free slots
+ */
+function startQueuedParses() {
+    while (runningParses < parserConcurrency && queuedParses.length > 0) {
+        let job = queuedParses.shift();
+        if (job.req.socket != null && job.req.socket.destroyed) {
+            job.reject(new Error('Client closed the connection'));
+            continue;
+        }
+
+        let slots = job.allFreeSlots ? parserConcurrency - runningParses : 1;
+        runningParses += slots;
+        job.call(slots).then(function (result) {
+            runningParses -= slots;
+            startQueuedParses();
+            job.resolve(result);
+        }, function (err) {
+            runningParses -= slots;
+            startQueuedParses();
+            job.reject(err);
+        });
+    }
+}
+
+/**
+ * sendBusy: Turns a request away because the parse queue is full
+ * Param res: The response to send
+ */
+function sendBusy(res) {
+    res.status(503).set('Retry-After', '1').send('Server busy, try again shortly');
+}
+
 /**
  * getUploadDirectoryFiles: Retrieves all files from uploads directory and formats them into an array
  * Return: A new array of file names
@@ -120,6 +262,10 @@ function getUploadDirectoryFiles() {
     let files = fs.readdirSync('uploads');
     for (let i in files) {
         let name = files[i];
+        //Hidden files are cards still being written by the parser
+        if (name.startsWith('.')) {
+            continue;
+        }
 	fileList.push(name);
     }
     return fileList;
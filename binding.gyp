@@ -0,0 +1,28 @@
+{
+  "targets": [
+    {
+      "target_name": "vcardparser",
+      "sources": [
+        "parser/src/VCardAddon.c",
+        "parser/src/VCardParser.c",
+        "parser/src/HelperFunctions.c",
+        "parser/src/LinkedListAPI.c",
+        "parser/src/VCardTokenizer.c",
+        "parser/src/VCardArena.c",
+        "parser/src/VCardVector.c",
+        "parser/src/VCardBatch.c",
+        "parser/src/VCardStringBuilder.c",
+        "parser/src/VCardJSONReader.c",
+        "parser/src/VCardPropertyKind.c",
+        "parser/src/VCardDiagnostics.c",
+        "parser/src/VCardScanner.c",
+        "parser/src/VCardLazy.c",
+        "parser/src/VCardSerializer.c"
+      ],
+      "include_dirs": [ "parser/include" ],
+      "defines": [ "NAPI_VERSION=3" ],
+      "cflags_c": [ "-std=c11" ],
+      "libraries": [ "-lpthread" ]
+    }
+  ]
+}
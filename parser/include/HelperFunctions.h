@@ -14,22 +14,59 @@
 #include <ctype.h>
 #include "LinkedListAPI.h"
 #include "VCardParser.h"
+#include "VCardTokenizer.h"
+#include "VCardArena.h"
 
 /**
- * readFileToString: Takes in a file destination and converts the contents into one char*
- * @param fileName: Destination/Name of file to be converted
- * @return char*: A dynamically created string of the file content
+ * A file's contents, read onto the heap or mapped (See mapInputFile).
+ * contents[length] is always '\0', so the contents can also be scanned as a string.
+ * The contents are a private copy - They may be written to (The tokenizer unfolds lines in place), the file never changes
  */
-char* readFileToString(char* fileName);
+typedef struct inputFile {
+    char* contents;
+    size_t length;
+
+    //true if contents is a private mapping of the file rather than a heap buffer
+    bool mapped;
+} InputFile;
+
+/**
+ * openInputFile: Reads a whole file into a writable heap buffer with read() (A file truncated while it is read is read short)
+ * @param fileName: Destination/Name of file to be opened
+ * @param input: InputFile* to store the contents into
+ * @return bool: true on success, false if the file is empty or can not be read
+ */
+bool openInputFile(char* fileName, InputFile* input);
+
+/**
+ * mapInputFile: Maps a whole file copy-on-write instead of reading it, so only the pages written to cost memory.
+ * Falls back to openInputFile when the file can not be mapped, or fills its last page (Leaving no room for the '\0')
+ * NOTE: A mapped file that is truncated while it is in use raises SIGBUS - Only map files nothing else rewrites
+ * @param fileName: Destination/Name of file to be opened
+ * @param input: InputFile* to store the contents into
+ * @return bool: true on success, false if the file is empty or can not be read
+ */
+bool mapInputFile(char* fileName, InputFile* input);
 
 /**
- * split: Takes in a string, a length (Number of lines), and delimiters to tokenize the string and place into a 2d array
- * @param stringToSplit: String that will be tokenized
- * @param length: Number of lines added to the 2d array
- * @param delimiters: Delimiters used to break the line apart
- * @return char**: A 2d string array containing the contents of the tokenized string
+ * closeInputFile: Releases the contents of a file opened with openInputFile or mapInputFile
+ * @param input: InputFile* to release
  */
-char** split(char* stringToSplit, int* length, char* delimiters, bool whiteSpaceCheck);
+void closeInputFile(InputFile* input);
+
+/**
+ * What getFileLog shows of a card - Filled in by summarizeCard without building the Card
+ */
+typedef struct cardSummary {
+    //First value of the first FN property
+    char* fn;
+
+    //Number of properties besides the first FN (Including BDAY/ANNIVERSARY)
+    int propertyCount;
+
+    //Error validateCard would return for the card (Only meaningful if the card parsed)
+    VCardErrorCode validationError;
+} CardSummary;
 
 /**
  * verifyFileName: Verifies the fileName passed in is not NULL, and contains the correct extension (.vcf/.vcard)
@@ -40,27 +77,31 @@ bool verifyFileName(char* fileName);
 
 /**
  * initializeCard: Card* constructor
+ * @param arena: Arena* to allocate the card from, NULL to allocate it on the heap
  * @return Card*: An initialized Card* structure
  */
-Card* initializeCard();
+Card* initializeCard(Arena* arena);
 
 /**
  * createDateTime: DateTime* structure constructor
+ * @param arena: Arena* to allocate the DateTime from, NULL to allocate it on the heap
  * @return DateTime*: An initialized DateTime* structure
  */
-DateTime* createDateTime(int flexSize);
+DateTime* createDateTime(int flexSize, Arena* arena);
 
 /**
  * createParameter: Parameter* structure constructor
+ * @param arena: Arena* to allocate the Parameter from, NULL to allocate it on the heap
  * @return Parameter*: An initialized Parameter* structure
  */
-Parameter* createParameter(int flexSize);
+Parameter* createParameter(int flexSize, Arena* arena);
 
 /**
  * createProperty: Property* structure constructor
+ * @param arena: Arena* to allocate the Property (And its lists) from, NULL to allocate it on the heap
  * @return Property*: An initialized Property* structure
  */
-Property* createProperty();
+Property* createProperty(Arena* arena);
 
 /**
  * deepCopyDateTime: Creates a deep copy of a DateTime* structure
@@ -97,20 +138,6 @@ void stringUpper(char* string);
  */
 int numberOfCharacters(char* string, char toSearch);
 
-/**
- * verifyStringEndOfLines: Verifies that every \r is followed by a \n
- * @param string: char* String to search
- * @return bool: True on valid string, False on invalid string
- */
-bool verifyStringEndOfLines(char* string);
-
-/**
- * removeBackslash: Removes all backslashes before commas in a quotation enclosed section
- * Function also swaps all semi-colons inside quotes with a '^' character
- * @param string: char* String to remove backslashes from
- */
-void removeBackslash(char* string);
-
 /**
  * stringCaseCompare: strcasecmp implementation for portable C
  * @param string1: char* first string to be compared
@@ -120,99 +147,85 @@ void removeBackslash(char* string);
 int stringCaseCompare(const char* string1, const char* string2);
 
 /**
- * noParamOneValue: Handles the parsing on data lines with no parameters, but one value
- * @param mainCard: Card* structure to store property into
- * @param toStoreIn: Property* structure to store data into
- * @param sectionOfLine: char* section of the data line to be parsed
- * @param values: char* values of the data line to be parsed
- * @param groupSet: bool indicating if the data line has a group
- */
-void noParamOneValue(Card* mainCard, Property* toStoreIn, char* sectionOfLine, char* values, bool groupSet);
-
-/**
- * noParamMultipleValues: Handles the parsing on data lines with no parameters, but multiple values
- * @param mainCard: Card* structure to store property into
- * @param toStoreIn: Property* structure to store data into
- * @param sectionOfLine: char* section of the data line to be parsed
- * @param values: char* values of the data line to be parsed
- * @param groupSet: bool indicating if the data line has a group
- */
-void noParamMultipleValues(Card* mainCard, Property* toStoreIn, char* sectionOfLine, char* values, bool groupSet);
-
-/**
- * params: Handles the parsing on data lines with multiple parameters and possibly multiple values
- * @param mainCard: Card* structure to store property into
- * @param toStoreIn: Property* structure to store data into
- * @param parameters: List* of parameters to parse
- * @param sectionOfLine: char* section of the data line to be parsed
- * @param values: char* values of the data line to be parsed
- * @param groupSet: bool indicating if the data line has a group
+ * addParametersToProperty: Handles adding parameters to a property (From the property's arena if it has one)
+ * @param toStoreIn: Property* to store parameters into
+ * @param parameters: StringView parameter section of a content line
+ * @return VCardErrorCode: OK on valid parameters, INV_PROP otherwise
  */
-void params(Card* mainCard, Property* toStoreIn, List* parameters, char* sectionOfLine, char* values, bool groupSet);
+VCardErrorCode addParametersToProperty(Property* toStoreIn, StringView parameters);
 
 /**
- * addParametersToProperty: Handles adding parameters to a property
- * @param toStoreIn: Property* to store parameters into
- * @param parameters: List* list of parameters
+ * addValuesToProperty: Handles adding the ';' separated values to a property, unescaped (From the property's arena if it has one)
+ * @param toStoreIn: Property* to store values into
+ * @param values: StringView value section of a content line
  */
-VCardErrorCode addParametersToProperty(Property* toStoreIn, List* parameters);
+void addValuesToProperty(Property* toStoreIn, StringView values);
 
 /**
- * parseDate: Creates a DateTime* structure based on a Property* structure
- * @param currentProperty: Property* to be conv
- * @return DateTime*: A newly created DateTime* structure
+ * unescapeValue: Copies a value into a new string, undoing the RFC 6350 escapes (\n or \N, \, \; and \\)
+ * Any other backslash is kept as is
+ * @param value: StringView value as written in the file
+ * @param arena: Arena* to allocate the string from, NULL to allocate it on the heap
+ * @return char*: A NUL terminated, unescaped copy of the value
  */
-DateTime* parseDate(Property* currentProperty);
+char* unescapeValue(StringView value, Arena* arena);
 
 /**
- * groupCheck: Looks for a group in the line
- * @param line: char* Line to be parsed for a group
- * @return char*: If a group is found, returns the group, otherwise, returns NULL
+ * countPropertyValues: Counts the values addValuesToProperty would add for a value section
+ * @param values: StringView value section of a content line
+ * @return int: Number of values
  */
-char* groupCheck(char* line);
+int countPropertyValues(StringView values);
 
 /**
- * propertyCheck: Checks if a property is NULL or empty
- * @param line: char* Line to check property for
+ * createPropertyFromLine: Creates a Property* structure from a split content line
+ * @param line: const ContentLine* split line to convert
+ * @param newProperty: Property** to store the new Property* into (NULL on error)
+ * @param arena: Arena* to allocate the property from, NULL to allocate it on the heap
  * @return VCardErrorCode: OK on valid property, INV_PROP otherwise
  */
-VCardErrorCode propertyCheck(char* line);
+VCardErrorCode createPropertyFromLine(const ContentLine* line, Property** newProperty, Arena* arena);
 
 /**
- * verifyOnlyOnce: Makes sure that BEGIN/END/VERSION only happens once in the card
- * @param line: char* Line to be verified
- * @return bool: false on bad line, true on good line
+ * parseCard: Reads one card (BEGIN:VCARD to END:VCARD) from a tokenizer
+ * @param tokenizer: Tokenizer* positioned before the BEGIN:VCARD line
+ * @param newCardObject: Card** to store the new Card* into (NULL on error)
+ * @param options: const ParseOptions* to parse with, NULL for the defaults
+ * @return VCardErrorCode: OK on a valid card, the error encountered otherwise
  */
-bool verifyOnlyOnce(char* line);
+VCardErrorCode parseCard(Tokenizer* tokenizer, Card** newCardObject, const ParseOptions* options);
 
 /**
- * validateDateTime: Performs validations on a DateTime* structure
- * @param currentDateTime: DateTime* to be verified
- * @return bool: false on bad DateTime, true on good DateTime
+ * summarizeCard: Reads one card from a tokenizer, keeping only what getFileLog shows
+ * The card is validated along the way, but no Property or List is built for anything other than BDAY/ANNIVERSARY
+ * @param tokenizer: Tokenizer* positioned before the BEGIN:VCARD line
+ * @param summary: CardSummary* to store the summary and summary->validationError into (summary->fn is NULL on error)
+ * @return VCardErrorCode: OK if the card parsed, the same error parseCard would return otherwise
  */
-bool validateDateTime(DateTime* currentDateTime);
+VCardErrorCode summarizeCard(Tokenizer* tokenizer, CardSummary* summary);
 
 /**
- * writeProperty: Handles the writing to file for Property* structures
- * @param file: FILE* to write to
- * @param toWrite: Property* to be written
+ * createCardSummary: Summarizes the card in a file (See summarizeCard)
+ * @param fileName: Destination/Name of the file
+ * @param summary: CardSummary* to store the summary into (summary->fn must be freed on OK)
+ * @return VCardErrorCode: The same error createCard followed by validateCard would return
  */
-void writeProperty(FILE* file, Property* toWrite);
+VCardErrorCode createCardSummary(char* fileName, CardSummary* summary);
 
 /**
- * writeDateTime: Handles the writing to file for DateTime* properties
- * @param file: FILE* to write to
- * @param toWrite: DateTime* to be written
- * @param isAnniversary: bool true on Anniversary DateTime*, false otherwise
- * @param isBDay: bool true on BDay DateTime*, false otherwise
+ * parseDate: Creates a DateTime* structure based on a Property* structure
+ * The DateTime* is allocated from the property's arena if it has one
+ * @param currentProperty: Property* to be conv
+ * @return DateTime*: A newly created DateTime* structure
  */
-void writeDateTime(FILE* file, DateTime* toWrite, bool isAnniversary, bool isBDay);
+DateTime* parseDate(Property* currentProperty);
 
 /**
- * populatePropertyList: Populates a list with all valid Property* structure names
- * @param toPopulate: List* to populate
+ * validateDateTime: Performs validations on a DateTime* structure
+ * @param currentDateTime: DateTime* to be verified
+ * @return bool: false on bad DateTime, true on good DateTime
  */
-void populatePropertyList(List* toPopulate);
+bool validateDateTime(DateTime* currentDateTime);
 
 /**
  * errorCheckProperty: Handles the validation checks of a Property* structure
@@ -235,14 +248,6 @@ VCardErrorCode errorCheckDateTime(DateTime* toCheck);
  */
 VCardErrorCode checkPropertyValueCount(Property* toCheck);
 
-/**
- * listPropertyNameSearch: String search function for a List* - specifically designed for Property* name validation
- * @param validPropertyList: List* of valid property names
- * @param propertyName: char* Current name to search for
- * @return bool: true on found string, false otherwise
- */
-bool listPropertyNameSearch(List* validPropertyList, char* propertyName);
-
 /**
  * substring: Grabs a substring inside of a string given a startIndex
  * @param startIndex: int Index to start collecting characters from
@@ -267,4 +272,12 @@ char* getFileLog(char* fileName);
 
 char* getCardView(char* fileName);
 
+/**
+ * getFileDiagnostics: Retrieves every error found in a file's card, in JSON format
+ * The whole card is read even after the first error, so one call explains everything wrong with the file
+ * @param fileName: char* File to check
+ * @return char*: JSON array of diagnostics (See diagnosticsToJSON), [] if the card is valid
+ */
+char* getFileDiagnostics(char* fileName);
+
 #endif //ASSIGNMENT_1_HELPERFUNCTIONS_H
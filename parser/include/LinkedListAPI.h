@@ -12,10 +12,14 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <assert.h>
+#include "VCardVector.h"
+
+struct arena;
 
 /**
  * Node of a linked list. This list is doubly linked, meaning that it has points to both the node immediately in front 
  * of it, as well as the node immediately behind it.
+ * Lists store their data in an array - Nodes are only built on request, for code written against head/tail (See getListHead).
  **/
 typedef struct listNode{
     void* data;
@@ -25,17 +29,25 @@ typedef struct listNode{
 
 /**
  * Metadata head of the list. 
- * Contains no actual data but contains
+ * The list keeps the API of a doubly linked list, but stores its data contiguously in a Vector
+ * so traversals do not chase node pointers. It also contains
  * information about the list (head and tail) as well as the function pointers
  * for working with the abstracted list data.
  **/
 typedef struct listHead{
+    /*  First and last nodes of the chain getListHead builds, NULL until it is called.  Any change to the list drops
+        the chain - Read only, and only valid until the list changes
+    */
     Node* head;
     Node* tail;
     int length;
     void (*deleteData)(void* toBeDeleted);
     int (*compare)(const void* first,const void* second);
     char* (*printData)(void* toBePrinted);
+    //Data in list order (length is always equal to elements.length)
+    Vector elements;
+    //Arena the list, its nodes and its elements array live in. NULL for a heap list
+    struct arena* arena;
 } List;
 
 
@@ -45,7 +57,7 @@ typedef struct listHead{
  * The list implemntation is hidden from the user
  **/
 typedef struct iter{
-    Node* current;
+    VectorIterator position;
 } ListIterator;
 
 
@@ -62,6 +74,20 @@ typedef struct iter{
 List* initializeList(char* (*printFunction)(void* toBePrinted),void (*deleteFunction)(void* toBeDeleted),int (*compareFunction)(const void* first,const void* second));
 
 
+/** Function to initialize a list that lives in an arena.
+* The list struct and its elements array are allocated from the arena and are only freed when the arena is released.
+* Removing or clearing elements never frees them - their data is expected to live in the arena as well
+*@pre arena is not NULL, function pointer arguments must not be NULL
+*@post List structure has been allocated from the arena and initialized
+*@return Newly allocated List struct
+*@param arena - the arena to allocate the list from
+*@param printFunction - function pointer to print a single node of the list
+*@param deleteFunction - function pointer to delete a single piece of data from the list
+*@param compareFunction - function pointer to compare two nodes of the list in order to test for equality or order
+**/
+List* initializeListInArena(struct arena* arena, char* (*printFunction)(void* toBePrinted),void (*deleteFunction)(void* toBeDeleted),int (*compareFunction)(const void* first,const void* second));
+
+
 
 /**Function for creating a node for the linked list. 
 * This node contains abstracted (void *) data as well as previous and next
@@ -76,8 +102,8 @@ Node* initializeNode(void* data);
 
 
 
-/**Inserts a Node at the front of a linked list.  List metadata is updated
-* so that head and tail pointers are correct.
+/**Inserts data at the front of a list, moving the other elements back.  List metadata is updated
+* so that the length is correct.
 *@pre 'List' type must exist and be used in order to keep track of the linked list.
 *@param list pointer to the List struct
 *@param toBeAdded - a pointer to data that is to be added to the linked list
@@ -86,8 +112,8 @@ void insertFront(List* list, void* toBeAdded);
 
 
 
-/**Inserts a Node at the back of a linked list. 
-*List metadata is updated so that head and tail pointers are correct.
+/**Inserts data at the back of a list. 
+*List metadata is updated so that the length is correct.
 *@pre 'List' type must exist and be used in order to keep track of the linked list.
 *@param list pointer to the List struct
 *@param toBeAdded - a pointer to data that is to be added to the linked list
@@ -124,12 +150,11 @@ void insertSorted(List* list, void* toBeAdded);
 
 
 
-/** Removes data from from the list, deletes the node and frees the memory,
- * changes pointer values of surrounding nodes to maintain list structure.
+/** Removes data from from the list, closing the gap it leaves behind.
  * returns the data 
  * You can assume that the list contains no duplicates
  *@pre List must exist and have memory allocated to it
- *@post toBeDeleted will have its memory freed if it exists in the list.
+ *@post toBeDeleted has been removed from the list if it exists in the list. Its memory is not freed.
  *@param list - a pointer to the List struct
  *@param toBeDeleted - a pointer to data that is to be removed from the list
  *@return on success: void * pointer to data  on failure: NULL
@@ -166,11 +191,19 @@ returned string must be freed by the calling function.
 char* toString(List* list);
 
 
-/** Function for creating an iterator for the linked list. 
- * This node contains abstracted (void *) data as well as previous and next
- * pointers to connect to other nodes in the list
+/** Function for getting a list's elements as a chain of nodes, for code written against head/tail.
+* The chain is only built the first time it is asked for after the list changes
+*@pre List exists and is valid
+*@post list->head and list->tail hold the chain (From the list's arena, if it has one)
+*@return The first node, NULL if the list is empty
+*@param list - pointer to the List struct
+**/
+Node* getListHead(List* list);
+
+
+/** Function for creating an iterator for the list. 
  *@pre List exists and is valid
- *@post List remains unchanged.  The iterator has been allocated and points to the head of the list.
+ *@post List remains unchanged.  The iterator points to the head of the list.
  *@return The newly created iterator object.
  *@param list - pointer to the List struct to iterate over.
 **/
@@ -211,4 +244,4 @@ int getLength(List* list);
  **/
 void* findElement(List * list, bool (*customCompare)(const void* first,const void* second), const void* searchRecord);
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
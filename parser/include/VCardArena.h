@@ -0,0 +1,95 @@
+/**
+ * @file VCardArena.h
+ * @brief This file contains the VCard file's bump allocator definitions, used to give a Card one lifetime.
+ * @author ADD LATER
+ */
+
+#ifndef ASSIGNMENT_1_VCARDARENA_H
+#define ASSIGNMENT_1_VCARDARENA_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * One chunk of arena memory. Allocations are carved out of data front to back
+ */
+typedef struct arenaBlock {
+    struct arenaBlock* next;
+    size_t used;
+    size_t capacity;
+    max_align_t data[];
+} ArenaBlock;
+
+/**
+ * Function to run on a heap object when the arena owning it is released
+ */
+typedef struct arenaCleanup {
+    void (*cleanup)(void* data);
+    void* data;
+    struct arenaCleanup* next;
+} ArenaCleanup;
+
+/**
+ * A bump allocator. Nothing allocated from it is freed on its own - Everything is freed at once by releaseArena
+ */
+typedef struct arena {
+    //Block allocations are currently carved from (Older blocks follow through next)
+    ArenaBlock* blocks;
+
+    //Heap objects handed over to the arena
+    ArenaCleanup* cleanups;
+
+    //Size of every new block (Larger allocations get a block of their own)
+    size_t blockSize;
+} Arena;
+
+/**
+ * createArena: Arena* constructor
+ * @param blockSize: size_t Number of bytes to allocate at a time (0 for the default)
+ * @return Arena*: An empty arena
+ */
+Arena* createArena(size_t blockSize);
+
+/**
+ * arenaAlloc: Allocates memory from an arena, aligned for any type
+ * @param arena: Arena* to allocate from
+ * @param size: size_t Number of bytes to allocate
+ * @return void*: Uninitialized memory, valid until the arena is released
+ */
+void* arenaAlloc(Arena* arena, size_t size);
+
+/**
+ * arenaCalloc: Allocates zeroed memory from an arena
+ * @param arena: Arena* to allocate from
+ * @param size: size_t Number of bytes to allocate
+ * @return void*: Zeroed memory, valid until the arena is released
+ */
+void* arenaCalloc(Arena* arena, size_t size);
+
+/**
+ * arenaStringCopy: Copies length bytes into a new NUL terminated string in an arena
+ * @param arena: Arena* to allocate from
+ * @param string: const char* Bytes to copy (Need not be NUL terminated)
+ * @param length: size_t Number of bytes to copy
+ * @return char*: The copy, valid until the arena is released
+ */
+char* arenaStringCopy(Arena* arena, const char* string, size_t length);
+
+/**
+ * arenaAddCleanup: Hands a heap object over to an arena, cleanup(data) is called when the arena is released
+ * @param arena: Arena* to hand the object to
+ * @param cleanup: Function that frees the object
+ * @param data: void* Object to free
+ */
+void arenaAddCleanup(Arena* arena, void (*cleanup)(void* data), void* data);
+
+/**
+ * releaseArena: Runs the arena's cleanup functions and frees all of its memory, including the arena itself
+ * @param arena: Arena* to release. May be NULL
+ */
+void releaseArena(Arena* arena);
+
+#endif //ASSIGNMENT_1_VCARDARENA_H
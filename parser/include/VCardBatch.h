@@ -0,0 +1,27 @@
+/**
+ * @file VCardBatch.h
+ * @brief This file contains the VCard file's batch parsing definitions, used to parse whole directories at once.
+ * @author ADD LATER
+ */
+
+#ifndef ASSIGNMENT_1_VCARDBATCH_H
+#define ASSIGNMENT_1_VCARDBATCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+/**
+ * parseDirectory: Parses and validates every file in a directory on a pool of threads (Hidden files are skipped)
+ * Files are handed out to the threads in blocks, and a thread that runs out of files steals half of
+ * another thread's remaining block, so a few slow files do not hold up the whole directory
+ * ex. return value (Sorted by file name):
+ * [{"file":"a.vcf","valid":true,"indiname":"Simon Perreault","addiprops":"15"},{"file":"b.txt","valid":false}]
+ * @param path: char* Directory to parse
+ * @param nthreads: int Number of threads to use, 0 (Or less) to use one per online CPU
+ * @return char*: A dynamically created JSON array of the file logs, NULL if the directory can not be opened
+ */
+char* parseDirectory(char* path, int nthreads);
+
+#endif //ASSIGNMENT_1_VCARDBATCH_H
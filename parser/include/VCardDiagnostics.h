@@ -0,0 +1,75 @@
+/**
+ * @file VCardDiagnostics.h
+ * @brief This file contains the VCard file's parse diagnostics definitions, used to explain why a card was rejected.
+ * @author ADD LATER
+ */
+
+#ifndef ASSIGNMENT_1_VCARDDIAGNOSTICS_H
+#define ASSIGNMENT_1_VCARDDIAGNOSTICS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "VCardParser.h"
+#include "VCardTokenizer.h"
+
+/**
+ * One error found while parsing a card
+ */
+typedef struct diagnostic {
+    VCardErrorCode error;
+
+    //Physical line number (starting at 1) the offending content line starts on, 0 if the error is not tied to a line
+    int lineNumber;
+
+    //Byte offset of the offending content line from the start of the file
+    size_t byteOffset;
+
+    //Name of the offending property, NULL if the line could not be split into a name and values
+    char* propertyName;
+
+    //Static description of the error - Never freed
+    const char* reason;
+} Diagnostic;
+
+/**
+ * Errors found while parsing a card, in file order (Errors found after the whole card was read come last)
+ */
+typedef struct diagnostics {
+    Diagnostic* entries;
+    size_t count;
+    size_t capacity;
+} Diagnostics;
+
+/**
+ * initializeDiagnostics: Prepares an empty list of diagnostics
+ * @param diagnostics: Diagnostics* to initialize
+ */
+void initializeDiagnostics(Diagnostics* diagnostics);
+
+/**
+ * clearDiagnostics: Frees every diagnostic and empties the list
+ * @param diagnostics: Diagnostics* to clear
+ */
+void clearDiagnostics(Diagnostics* diagnostics);
+
+/**
+ * addDiagnostic: Records an error
+ * @param diagnostics: Diagnostics* to add to
+ * @param error: VCardErrorCode of the error
+ * @param line: const ContentLine* the error was found on, NULL if the error is not tied to a line
+ *              The property name is only recorded if the line was split with splitContentLine
+ * @param reason: const char* Static description of the error
+ */
+void addDiagnostic(Diagnostics* diagnostics, VCardErrorCode error, const ContentLine* line, const char* reason);
+
+/**
+ * diagnosticsToJSON: Converts diagnostics into a JSON array
+ * Each entry is {"error":"INV_PROP","line":3,"offset":42,"property":"TEL","reason":"..."} ("property" is null if unknown)
+ * @param diagnostics: const Diagnostics* to convert
+ * @return char*: A dynamically created JSON array
+ */
+char* diagnosticsToJSON(const Diagnostics* diagnostics);
+
+#endif //ASSIGNMENT_1_VCARDDIAGNOSTICS_H
@@ -0,0 +1,51 @@
+/**
+ * @file VCardJSONReader.h
+ * @brief This file contains the VCard file's single pass JSON reader definitions, used to import JSON.
+ * @author ADD LATER
+ */
+
+#ifndef ASSIGNMENT_1_VCARDJSONREADER_H
+#define ASSIGNMENT_1_VCARDJSONREADER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+/**
+ * Callbacks the reader makes as it walks a JSON document, in document order.
+ * Strings (And keys) are handed out unescaped, but not NUL terminated. They either point into the document or into
+ * the reader's scratch space, and are only valid during the callback.
+ * Every callback returns false to stop reading. Callbacks left NULL accept their value and ignore it
+ */
+typedef struct jsonHandler {
+    //Passed to every callback
+    void* context;
+
+    bool (*startObject)(void* context);
+    bool (*endObject)(void* context);
+    bool (*startArray)(void* context);
+    bool (*endArray)(void* context);
+
+    //Name of the object member whose value comes next
+    bool (*key)(void* context, const char* key, size_t length);
+
+    bool (*string)(void* context, const char* value, size_t length);
+
+    //The number as written in the document
+    bool (*number)(void* context, const char* text, size_t length);
+
+    bool (*boolean)(void* context, bool value);
+    bool (*null)(void* context);
+} JSONHandler;
+
+/**
+ * readJSON: Walks a JSON document once, reporting what it finds to a handler
+ * @param json: const char* Document to read
+ * @param length: size_t Number of bytes in the document
+ * @param handler: const JSONHandler* to report to
+ * @return bool: true if the document is well formed JSON and no callback stopped the reader, false otherwise
+ */
+bool readJSON(const char* json, size_t length, const JSONHandler* handler);
+
+#endif //ASSIGNMENT_1_VCARDJSONREADER_H
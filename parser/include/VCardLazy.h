@@ -0,0 +1,104 @@
+/**
+ * @file VCardLazy.h
+ * @brief This file contains the VCard file's lazy card definitions, used to read single properties without building the whole card.
+ * @author ADD LATER
+ */
+
+#ifndef ASSIGNMENT_1_VCARDLAZY_H
+#define ASSIGNMENT_1_VCARDLAZY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "VCardParser.h"
+#include "HelperFunctions.h"
+#include "VCardArena.h"
+
+/**
+ * Where one property's content line sits in the card's file contents. The property is only built on first access
+ */
+typedef struct lazyProperty {
+    //Byte range of the unfolded content line inside the file contents
+    size_t offset;
+    size_t length;
+
+    //Physical line number (starting at 1) the content line starts on
+    int lineNumber;
+
+    //Resolved from the name during the scan
+    PropertyKind kind;
+
+    //Built by cardGetProperty, NULL until then
+    Property* decoded;
+} LazyProperty;
+
+/**
+ * A card whose properties are only located by the scan. Values, parameters and groups are copied out of the file
+ * contents when a property is accessed, so properties that are never read (Large PHOTO/LOGO/SOUND/KEY values) cost nothing
+ */
+typedef struct lazyCard {
+    //Kept open for as long as the card lives - Folded lines were unfolded in place
+    InputFile input;
+
+    //Every property between VERSION and END:VCARD, in file order (FN, BDAY and ANNIVERSARY included)
+    LazyProperty* properties;
+    int propertyCount;
+
+    //Index of the first FN property
+    int fnIndex;
+
+    //Decoded properties are allocated from here and freed with the card
+    Arena* arena;
+} LazyCard;
+
+/**
+ * createLazyCard: Scans the card in a file, recording where each property is without building any of them
+ * Only the card's structure is checked (Line breaks and lengths, BEGIN/VERSION/END, a ':' on every line and an FN).
+ * Parameters are checked when a property is decoded, see cardGetProperty
+ * @param fileName: char* Destination/Name of the file
+ * @param newCard: LazyCard** to store the new LazyCard* into (NULL on error)
+ * @return VCardErrorCode: OK on a well formed card, the error createCard would return for the structure otherwise
+ */
+VCardErrorCode createLazyCard(char* fileName, LazyCard** newCard);
+
+/**
+ * deleteLazyCard: Frees a lazy card, every property decoded from it and its file contents
+ * @param card: LazyCard* to free (May be NULL)
+ */
+void deleteLazyCard(LazyCard* card);
+
+/**
+ * cardPropertyCount: Grabs the number of properties in a lazy card
+ * @param card: const LazyCard* to count
+ * @return int: Number of properties, FN/BDAY/ANNIVERSARY included
+ */
+int cardPropertyCount(const LazyCard* card);
+
+/**
+ * cardGetPropertyKind: Grabs the kind of a property without decoding it
+ * @param card: const LazyCard* holding the property
+ * @param index: int Index of the property (0 to cardPropertyCount - 1)
+ * @return PropertyKind: Kind of the property, PROP_UNRESOLVED if the index is out of range
+ */
+PropertyKind cardGetPropertyKind(const LazyCard* card, int index);
+
+/**
+ * cardFindProperty: Finds the next property of a kind without decoding anything
+ * @param card: const LazyCard* to search
+ * @param kind: PropertyKind to look for
+ * @param start: int Index to start searching from
+ * @return int: Index of the property, -1 if there is none
+ */
+int cardFindProperty(const LazyCard* card, PropertyKind kind, int start);
+
+/**
+ * cardGetProperty: Decodes a property on first access (Later calls return the same Property*)
+ * @param card: LazyCard* holding the property
+ * @param index: int Index of the property (0 to cardPropertyCount - 1)
+ * @return Property*: The property (Owned by the card - Do not free), NULL if the index is out of range or the property
+ *                    has malformed parameters
+ */
+Property* cardGetProperty(LazyCard* card, int index);
+
+#endif //ASSIGNMENT_1_VCARDLAZY_H
@@ -48,6 +48,18 @@ typedef struct param {
 } Parameter;
 
 
+/*	Known vCard property names (RFC 6350), resolved from Property names at parse time.
+	Every other name (Including x-names) is PROP_UNKNOWN.  PROP_UNRESOLVED is 0, so a zeroed Property is unresolved
+*/
+typedef enum propertyKind {
+	PROP_UNRESOLVED = 0, PROP_UNKNOWN,
+	PROP_BEGIN, PROP_END, PROP_SOURCE, PROP_KIND, PROP_XML, PROP_FN, PROP_N, PROP_NICKNAME, PROP_PHOTO, PROP_BDAY,
+	PROP_ANNIVERSARY, PROP_GENDER, PROP_ADR, PROP_TEL, PROP_EMAIL, PROP_IMPP, PROP_LANG, PROP_TZ, PROP_GEO, PROP_TITLE,
+	PROP_ROLE, PROP_LOGO, PROP_ORG, PROP_MEMBER, PROP_RELATED, PROP_CATEGORIES, PROP_NOTE, PROP_PRODID, PROP_REV,
+	PROP_SOUND, PROP_UID, PROP_CLIENTPIDMAP, PROP_URL, PROP_VERSION, PROP_KEY, PROP_FBURL, PROP_CALADRURI, PROP_CALURI,
+	PROPERTY_KIND_COUNT
+} PropertyKind;
+
 //Represents a generic vCard property
 typedef struct prop {
 	//Property name.  Must not be empty string.  Must not be NULL.
@@ -67,6 +79,11 @@ typedef struct prop {
 	*/
 	List*		values; 
 
+	/*	Kind of property the name describes, set by the parser.  Only a hint - propertyKind checks it against
+		the name, so a Property built by hand (Or renamed) is resolved from its name whatever this holds.
+	*/
+	PropertyKind	kind;
+
 } Property;
 
 
@@ -107,6 +124,61 @@ char* printCard(const Card* obj);
 char* printError(VCardErrorCode err);
 // *************************************************************************
 
+// ************* Card parser options ****************************************
+
+//Optional parser behaviour. A zeroed struct (Or a NULL pointer) gives the same result as createCard
+typedef struct parseOptions {
+	/*	Allocate the card and everything in it from a single arena. deleteCard then frees the whole card at once.
+		Meant for cards that are read and thrown away - Anything added to the card later must go through addProperty
+	*/
+	bool	useArena;
+
+	/*	Run validateCard's checks on each property as it is parsed, and stop at the first error without reading
+		the rest of the card.  The card is only returned if it is valid, so validateCard does not need to be called.
+		The error returned for an invalid card is the first one in file order, which may not be the one
+		validateCard would report first
+	*/
+	bool	validate;
+
+	/*	Keep parsing past errors instead of stopping at the first one.  Bad lines are skipped, and with validate set
+		every validation error is found too.  The first error is still returned and no card is created
+	*/
+	bool	collectErrors;
+
+	/*	Where to record each error found (Line, byte offset, property name and reason - See VCardDiagnostics.h).
+		May be NULL.  The caller initializes it and clears it
+	*/
+	struct diagnostics*	diagnostics;
+
+	/*	Drop properties that can not be parsed (Or fail validation, with validate set) instead of rejecting the card.
+		Dropped properties are still recorded in diagnostics.  Only errors that concern the card as a whole
+		(No BEGIN/END/FN, content after END:VCARD) still reject it
+	*/
+	bool	lenient;
+
+	/*	Where lenient mode keeps the unfolded text (char*) of every dropped line. May be NULL.  Create it with
+		initializeList(&printValue, &deleteValue, &compareValues) - The lines are not freed with the card
+	*/
+	List*	quarantine;
+
+	/*	Map the file instead of reading it onto the heap, so a large file costs no heap for its raw bytes.
+		WARNING: A file that is truncated while it is parsed raises SIGBUS and kills the process - Only set this
+		for files nothing else rewrites (Not uploads that may be replaced mid-parse).  Ignored by VCardReader
+	*/
+	bool	mapFile;
+} ParseOptions;
+
+/** Function for creating a Card object with optional parser behaviour
+ *@pre fileName is not NULL, has the correct extension
+ *@post newCardObject points to a new Card, or NULL on error
+ *@return the error code indicating success or the error encountered when parsing the file
+ *@param fileName - the name of the input file
+ *       newCardObject - a double pointer to a Card struct that needs to be allocated
+ *       options - a pointer to a ParseOptions struct. May be NULL
+ **/
+VCardErrorCode createCardWithOptions(char* fileName, Card** newCardObject, const ParseOptions* options);
+// *************************************************************************
+
 // ************* List helper functions - MUST be implemented *************** 
 void deleteProperty(void* toBeDeleted);
 int compareProperties(const void* first,const void* second);
@@ -205,6 +277,17 @@ char* dtToJSON(const DateTime* prop);
 DateTime* JSONtoDT(const char* str);
 
 
+/** Function for converting an entire Card struct into a JSON string
+ *  {"fn":<Property>,"birthday":<DateTime>,"anniversary":<DateTime>,"optionalProperties":[<Property>,...]}
+ *  Properties and DateTimes use the propToJSON/dtToJSON formats, missing dates are null
+ *@pre Card exists, is not null, and is valid
+ *@post Card has not been modified in any way, and a JSON string has been created
+ *@return newly allocated JSON string.  May be NULL.
+ *@param obj - a pointer to a Card struct
+ **/
+char* cardToJSON(const Card* obj);
+
+
 /** Function for creating a Card struct from an JSON string
  *@pre String is not null, and is valid
  *@post String has not been modified in any way, and a Card struct has been created
@@ -227,4 +310,139 @@ void addProperty(Card* card, const Property* toBeAdded);
 // *************************************************************************
 
 
+// ************* Multi-card reader functions ********************************
+
+//Reads the cards of a file holding any number of vCards, one card at a time
+typedef struct vCardReader VCardReader;
+
+/** Function for opening a file holding one or more vCards.
+ *  Only a fixed size window of the file is kept in memory, no matter how many cards it holds
+ *@pre fileName is not NULL, has the correct extension
+ *@post reader points to a new reader positioned before the first card, or NULL on error
+ *@return OK on success, INV_FILE if the file can not be opened
+ *@param fileName - the name of the input file
+ *       reader - a double pointer to a VCardReader struct that needs to be allocated
+ **/
+VCardErrorCode openVCardReader(const char* fileName, VCardReader** reader);
+
+/** Function for reading the next card out of a reader
+ *@pre reader was created by openVCardReader
+ *@post newCardObject points to the next card, or NULL at the end of the file or on error.
+ *      After an invalid card the reader skips ahead to the next BEGIN:VCARD, so reading can continue
+ *@return OK on success (Including the end of the file), or the error encountered in the current card
+ *@param reader - a pointer to a VCardReader struct
+ *       newCardObject - a double pointer to a Card struct that needs to be allocated
+ **/
+VCardErrorCode nextCard(VCardReader* reader, Card** newCardObject);
+
+/** Function for reading the next card out of a reader with optional parser behaviour (See ParseOptions)
+ *@pre reader was created by openVCardReader
+ *@post Same as nextCard.  With options->lenient set, bad properties of an export are dropped instead of the whole card
+ *@return OK on success (Including the end of the file), or the error encountered in the current card
+ *@param reader - a pointer to a VCardReader struct
+ *       newCardObject - a double pointer to a Card struct that needs to be allocated
+ *       options - a pointer to a ParseOptions struct. May be NULL
+ **/
+VCardErrorCode nextCardWithOptions(VCardReader* reader, Card** newCardObject, const ParseOptions* options);
+
+/** Function for closing a reader and freeing its memory. Cards already read are not affected
+ *@param reader - a pointer to a VCardReader struct. May be NULL
+ **/
+void closeVCardReader(VCardReader* reader);
+
+// *************************************************************************
+
+// ************* Card writer functions **************************************
+
+/** Function for rendering a Card object as vCard text without writing a file. writeCard writes the same text
+ *@pre Card object exists, and is not NULL
+ *@post Card has not been modified in any way.  out holds the card's text: values escaped and lines folded at 75 octets
+ *@return OK on success, WRITE_ERROR if the card is NULL
+ *@param obj - a pointer to a Card struct
+ *       out - a double pointer to the new NUL terminated text (NULL on error). Must be freed by the caller
+ *       length - a pointer to the length of the text
+ **/
+VCardErrorCode serializeCard(const Card* obj, char** out, size_t* length);
+
+//Optional writer behaviour. A zeroed struct (Or a NULL pointer) gives the same result as writeCard
+typedef struct writeOptions {
+	/*	Write the card to a hidden temporary file next to fileName, then rename it over fileName.  Anyone reading
+		fileName sees the old card or the new one, never part of one.  A failed write leaves fileName untouched
+	*/
+	bool	atomic;
+
+	/*	fsync the card before returning (With atomic set, the file before the rename and its directory after it),
+		so the card is not lost if the machine crashes.  Much slower - Each fsync waits for the disk
+	*/
+	bool	sync;
+} WriteOptions;
+
+/** Function for writing a Card object into a file with optional writer behaviour
+ *@pre Card object exists, and is not NULL.
+        fileName is not NULL, has the correct extension
+ *@post Card has not been modified in any way, and a file representing the
+        Card contents in vCard format has been created
+ *@return the error code indicating success or the error encountered when writing the Card
+ *@param fileName - the name of the output file
+ *       obj - a pointer to a Card struct
+ *       options - a pointer to a WriteOptions struct. May be NULL
+ **/
+VCardErrorCode writeCardWithOptions(const char* fileName, const Card* obj, const WriteOptions* options);
+
+/** Function for writing many Card objects at once, each into its own file.  Always atomic: every card is written
+ *  to a temporary file first, and only once all of them are written are they renamed into place.  With sync set,
+ *  each directory is fsynced once for the whole batch rather than once per card
+ *@pre fileNames and cards hold count entries. Every file name has the correct extension
+ *@post If any card can not be written, no file is changed.  If a rename fails part way through, the cards before it
+        have been written and the rest have not
+ *@return the error code indicating success or the first error encountered
+ *@param fileNames - the names of the output files
+ *       cards - pointers to the Card structs, cards[i] is written to fileNames[i]
+ *       count - number of cards
+ *       options - a pointer to a WriteOptions struct (atomic is implied). May be NULL
+ **/
+VCardErrorCode writeCards(const char** fileNames, const Card** cards, int count, const WriteOptions* options);
+
+// *************************************************************************
+
+// ************* Multi-card writer functions ********************************
+
+//Writes many cards into one file (The file openVCardReader reads them back from).  Opaque - See VCardParser.c
+typedef struct vCardWriter VCardWriter;
+
+/** Function for creating a file to write one or more vCards into.
+ *  Cards are collected in a fixed size buffer that is written out whenever it fills, so memory use does not grow with
+ *  the number of cards.  With options->atomic set, the cards go to a temporary file that only replaces fileName once
+ *  the writer is closed
+ *@pre fileName is not NULL, has the correct extension
+ *@post writer points to a new writer for an empty file, or NULL on error
+ *@return OK on success, WRITE_ERROR if the file can not be created
+ *@param fileName - the name of the output file
+ *       options - a pointer to a WriteOptions struct. May be NULL
+ *       writer - a double pointer to a VCardWriter struct that needs to be allocated
+ **/
+VCardErrorCode openVCardWriter(const char* fileName, const WriteOptions* options, VCardWriter** writer);
+
+/** Function for adding a Card object to the end of a writer's file
+ *@pre writer was created by openVCardWriter
+ *@post Card has not been modified in any way.  The card follows every card appended before it
+ *@return OK on success, WRITE_ERROR if the card is NULL (The writer can still be used) or the file could not be written
+ *        (Every later call fails too)
+ *@param writer - a pointer to a VCardWriter struct
+ *       obj - a pointer to a Card struct
+ **/
+VCardErrorCode appendCard(VCardWriter* writer, const Card* obj);
+
+/** Function for finishing a writer's file and freeing its memory.  The writer can not be used again
+ *@pre writer was created by openVCardWriter
+ *@post Every appended card is in the file.  With options->atomic set, fileName is replaced, or left untouched if any
+ *      write failed
+ *@return OK if every card was written, WRITE_ERROR otherwise
+ *@param writer - a pointer to a VCardWriter struct. May be NULL
+ **/
+VCardErrorCode closeVCardWriter(VCardWriter* writer);
+
+// *************************************************************************
+
+
 #endif	
@@ -0,0 +1,91 @@
+/**
+ * @file VCardPropertyKind.h
+ * @brief This file contains the VCard file's property name lookup definitions.
+ * @author ADD LATER
+ */
+
+#ifndef ASSIGNMENT_1_VCARDPROPERTYKIND_H
+#define ASSIGNMENT_1_VCARDPROPERTYKIND_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "VCardParser.h"
+#include "VCardTokenizer.h"
+
+/**
+ * How many times a property may appear on a card (RFC 6350 section 3.3)
+ */
+typedef enum cardinality {
+    //1 - Exactly one
+    CARDINALITY_ONE,
+    //*1 - At most one
+    CARDINALITY_AT_MOST_ONE,
+    //1* - At least one
+    CARDINALITY_ONE_OR_MORE,
+    //* - Any number
+    CARDINALITY_ANY
+} Cardinality;
+
+/**
+ * Validation rules of one kind of property
+ */
+typedef struct propertySpec {
+    //Upper case RFC 6350 name, NULL for PROP_UNKNOWN
+    const char* name;
+
+    Cardinality cardinality;
+
+    //Number of ';' separated values allowed (maxValues is 0 if there is no upper limit)
+    int minValues;
+    int maxValues;
+
+    //Error validateCard returns if the property is found among a card's optional properties (OK if it is allowed there)
+    VCardErrorCode optionalPropertyError;
+} PropertySpec;
+
+/**
+ * lookupPropertyKind: Resolves a property name, ignoring case
+ * @param name: StringView Property name
+ * @return PropertyKind: The kind of property the name describes, PROP_UNKNOWN if it is not an RFC 6350 name
+ */
+PropertyKind lookupPropertyKind(StringView name);
+
+/**
+ * propertyKind: Grabs a property's kind - prop->kind if it matches the name, otherwise the kind is resolved from the name
+ * @param prop: const Property* to check
+ * @return PropertyKind: The kind of the property, PROP_UNKNOWN if prop or its name is NULL
+ */
+PropertyKind propertyKind(const Property* prop);
+
+/**
+ * propertyKindName: Grabs the name of a property kind
+ * @param kind: PropertyKind to name
+ * @return const char*: Upper case RFC 6350 name (Static - Do not free), NULL for PROP_UNKNOWN/PROP_UNRESOLVED
+ */
+const char* propertyKindName(PropertyKind kind);
+
+/**
+ * propertySpec: Grabs the validation rules of a property kind
+ * @param kind: PropertyKind to look up
+ * @return const PropertySpec*: Static rules (Do not free) - The PROP_UNKNOWN rules for PROP_UNKNOWN/PROP_UNRESOLVED
+ */
+const PropertySpec* propertySpec(PropertyKind kind);
+
+/**
+ * checkValueCount: Checks that a property of the given kind may have the given number of values
+ * @param kind: PropertyKind of the property
+ * @param valueCount: int number of values
+ * @return VCardErrorCode: OK on a valid count, INV_PROP otherwise
+ */
+VCardErrorCode checkValueCount(PropertyKind kind, int valueCount);
+
+/**
+ * checkCardinality: Checks how many times each kind of optional property appeared against its cardinality
+ * @param occurrences: const int[PROPERTY_KIND_COUNT] Number of optional properties of each kind
+ * @return VCardErrorCode: OK if no property appears more often than allowed, INV_PROP otherwise
+ */
+VCardErrorCode checkCardinality(const int occurrences[PROPERTY_KIND_COUNT]);
+
+#endif //ASSIGNMENT_1_VCARDPROPERTYKIND_H
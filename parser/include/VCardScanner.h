@@ -0,0 +1,35 @@
+/**
+ * @file VCardScanner.h
+ * @brief This file contains the VCard file's vectorized byte scanner definitions, used to find line breaks and delimiters.
+ * @author ADD LATER
+ */
+
+#ifndef ASSIGNMENT_1_VCARDSCANNER_H
+#define ASSIGNMENT_1_VCARDSCANNER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+/**
+ * scanForEither: Finds the first byte of a buffer that is one of two structural characters
+ * Compares 32 (AVX2) or 16 (SSE2) bytes at a time when the compiler targets them, one byte at a time otherwise
+ * @param start: const char* First byte to check
+ * @param end: const char* One past the last byte to check
+ * @param first: char Character to look for
+ * @param second: char Other character to look for
+ * @return const char*: Position of the first match, end if there is none
+ */
+const char* scanForEither(const char* start, const char* end, char first, char second);
+
+/**
+ * countCharacter: Counts the occurrences of a character in a buffer, 16 or 32 bytes at a time when possible
+ * @param start: const char* First byte to check
+ * @param end: const char* One past the last byte to check
+ * @param toCount: char Character to count
+ * @return size_t: Number of occurrences
+ */
+size_t countCharacter(const char* start, const char* end, char toCount);
+
+#endif //ASSIGNMENT_1_VCARDSCANNER_H
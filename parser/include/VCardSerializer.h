@@ -0,0 +1,36 @@
+/**
+ * @file VCardSerializer.h
+ * @brief This file contains the VCard file's card to text rendering definitions, used to write cards.
+ * @author ADD LATER
+ */
+
+#ifndef ASSIGNMENT_1_VCARDSERIALIZER_H
+#define ASSIGNMENT_1_VCARDSERIALIZER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "VCardParser.h"
+#include "VCardStringBuilder.h"
+
+//Longest physical line (In octets, without the \r\n) RFC 6350 allows before a content line must be folded
+#define FOLD_LINE_LENGTH 75
+
+/**
+ * estimateCardText: Estimates the length of a card's text, so the output can be sized once
+ * @param card: const Card* to estimate
+ * @return size_t: Number of bytes appendCardText is expected to write (Escapes can make it slightly more)
+ */
+size_t estimateCardText(const Card* card);
+
+/**
+ * appendCardText: Renders a card as vCard 4.0 text (BEGIN:VCARD to END:VCARD\r\n)
+ * Values are escaped (\\, newlines and ;) and every content line is folded at FOLD_LINE_LENGTH octets,
+ * never inside a UTF-8 character
+ * @param out: StringBuilder* to append to
+ * @param card: const Card* to render
+ */
+void appendCardText(StringBuilder* out, const Card* card);
+
+#endif //ASSIGNMENT_1_VCARDSERIALIZER_H
@@ -0,0 +1,89 @@
+/**
+ * @file VCardStringBuilder.h
+ * @brief This file contains the VCard file's growable string definitions, used to build JSON output.
+ * @author ADD LATER
+ */
+
+#ifndef ASSIGNMENT_1_VCARDSTRINGBUILDER_H
+#define ASSIGNMENT_1_VCARDSTRINGBUILDER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+/**
+ * A NUL terminated string that grows as text is appended to its end.
+ * The length is tracked, so appending never rescans what was already written
+ */
+typedef struct stringBuilder {
+    char* buffer;
+    size_t length;
+    size_t capacity;
+} StringBuilder;
+
+/**
+ * initializeStringBuilder: Prepares an empty string
+ * @param builder: StringBuilder* to initialize
+ * @param initialCapacity: size_t Number of bytes to reserve up front (0 for the default)
+ */
+void initializeStringBuilder(StringBuilder* builder, size_t initialCapacity);
+
+/**
+ * clearStringBuilder: Frees a string that is not going to be finished
+ * @param builder: StringBuilder* to clear
+ */
+void clearStringBuilder(StringBuilder* builder);
+
+/**
+ * builderReserve: Makes sure a number of bytes can be appended without growing the string again
+ * @param builder: StringBuilder* to grow
+ * @param additional: size_t Number of bytes about to be appended
+ */
+void builderReserve(StringBuilder* builder, size_t additional);
+
+/**
+ * builderAppendBytes: Appends a number of bytes to the end of the string
+ * @param builder: StringBuilder* to append to
+ * @param bytes: const char* Bytes to append
+ * @param length: size_t Number of bytes to append
+ */
+void builderAppendBytes(StringBuilder* builder, const char* bytes, size_t length);
+
+/**
+ * builderAppend: Appends a NUL terminated string to the end of the string
+ * @param builder: StringBuilder* to append to
+ * @param string: const char* String to append (NULL appends nothing)
+ */
+void builderAppend(StringBuilder* builder, const char* string);
+
+/**
+ * builderAppendChar: Appends a single character to the end of the string
+ * @param builder: StringBuilder* to append to
+ * @param character: char Character to append
+ */
+void builderAppendChar(StringBuilder* builder, char character);
+
+/**
+ * builderAppendInt: Appends the decimal representation of a number to the end of the string
+ * @param builder: StringBuilder* to append to
+ * @param number: long Number to append
+ */
+void builderAppendInt(StringBuilder* builder, long number);
+
+/**
+ * builderAppendEscaped: Appends a string with its JSON special characters escaped (Without surrounding quotes)
+ * Quotes, backslashes and control characters are escaped, everything else is copied as is
+ * @param builder: StringBuilder* to append to
+ * @param string: const char* String to escape (NULL appends nothing)
+ */
+void builderAppendEscaped(StringBuilder* builder, const char* string);
+
+/**
+ * builderFinish: Hands the string over to the caller. The builder is left empty
+ * @param builder: StringBuilder* to finish
+ * @return char*: The dynamically allocated, NUL terminated string (Freed by the caller)
+ */
+char* builderFinish(StringBuilder* builder);
+
+#endif //ASSIGNMENT_1_VCARDSTRINGBUILDER_H
@@ -0,0 +1,194 @@
+/**
+ * @file VCardTokenizer.h
+ * @brief This file contains the VCard file's single pass content line tokenizer definitions.
+ * @author ADD LATER
+ */
+
+#ifndef ASSIGNMENT_1_VCARDTOKENIZER_H
+#define ASSIGNMENT_1_VCARDTOKENIZER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "VCardParser.h"
+
+/**
+ * A read-only slice of a buffer. The slice is not NUL terminated and is only valid for as long as the
+ * buffer it points into.
+ */
+typedef struct stringView {
+    const char* start;
+    size_t length;
+} StringView;
+
+/**
+ * One unfolded vCard content line, split into its sections.
+ * All views point either into the tokenized buffer, or into the tokenizer's scratch space when the line
+ * was folded over several physical lines of a read-only buffer. They are invalidated by the next call to nextContentLine.
+ */
+typedef struct contentLine {
+    //Entire unfolded line (without the trailing \r\n)
+    StringView line;
+
+    //Everything before the first '.' of the name section. Empty if the line has no group
+    StringView group;
+
+    //Property name
+    StringView name;
+
+    //Everything between the first ';' and the ':' that starts the values (quoted sections are skipped)
+    StringView parameters;
+
+    //Everything after the ':' that ends the name/parameter section
+    StringView values;
+
+    //True if the line has a parameter section (even an empty one)
+    bool hasParameters;
+
+    //Physical line number (starting at 1) the content line starts on
+    int lineNumber;
+
+    //Byte offset of the content line from the start of the input
+    size_t byteOffset;
+
+    //Length of the longest physical line the content line was unfolded from (without the \r\n)
+    size_t longestPhysicalLine;
+} ContentLine;
+
+/**
+ * Result of asking the tokenizer for the next content line
+ */
+typedef enum tokenStatus { TOKEN_LINE, TOKEN_END, TOKEN_ERROR } TokenStatus;
+
+/**
+ * Walks a buffer once, handing out content lines as views into it.
+ * The buffer may be the whole input, or a window that a refill function slides over a larger input.
+ */
+typedef struct tokenizer {
+    //Next byte to be scanned
+    const char* current;
+
+    //One past the last buffered byte
+    const char* end;
+
+    //Physical line number of current
+    int lineNumber;
+
+    //Byte offset of current from the start of the input (Refills do not change it)
+    size_t offset;
+
+    //True once no more bytes can be added after end
+    bool endOfInput;
+
+    //True if the buffer may be written to - Folded lines are then unfolded inside the buffer instead of being copied
+    bool unfoldInPlace;
+
+    /*  Called when a line runs past the buffered bytes. Must keep the bytes from current to end (They may be
+        moved), add more bytes after them and update current/end. Returns false once the input is exhausted.
+        NULL if the buffer is the whole input.
+    */
+    bool (*refill)(struct tokenizer* tokenizer);
+    void* refillContext;
+
+    //Line handed back through unreadContentLine
+    ContentLine pending;
+    bool hasPending;
+
+    //Unfolded copy of the current line, only used when a line of a read-only buffer is folded
+    char* scratch;
+    size_t scratchCapacity;
+} Tokenizer;
+
+/**
+ * initializeTokenizer: Prepares a tokenizer to walk a buffer. The buffer is never modified or copied
+ * @param tokenizer: Tokenizer* to initialize
+ * @param buffer: const char* Buffer to tokenize
+ * @param length: size_t Number of bytes in the buffer
+ */
+void initializeTokenizer(Tokenizer* tokenizer, const char* buffer, size_t length);
+
+/**
+ * initializeWritableTokenizer: Prepares a tokenizer to walk a buffer it may write to. Folded lines are unfolded in place,
+ * which overwrites the bytes of the line - The buffer no longer holds the original input afterwards
+ * @param tokenizer: Tokenizer* to initialize
+ * @param buffer: char* Buffer to tokenize
+ * @param length: size_t Number of bytes in the buffer
+ */
+void initializeWritableTokenizer(Tokenizer* tokenizer, char* buffer, size_t length);
+
+/**
+ * clearTokenizer: Frees the memory owned by a tokenizer (The tokenized buffer is not freed)
+ * @param tokenizer: Tokenizer* to clear
+ */
+void clearTokenizer(Tokenizer* tokenizer);
+
+/**
+ * hasMoreContent: Skips empty lines and checks if another content line follows
+ * @param tokenizer: Tokenizer* to check
+ * @return bool: true if nextContentLine will return a line (Or an error), false at the end of the input
+ */
+bool hasMoreContent(Tokenizer* tokenizer);
+
+/**
+ * nextContentLine: Grabs the next unfolded content line from the buffer. Empty lines are skipped
+ * Only line->line, line->lineNumber and line->byteOffset are set (line->name is emptied, and so is line->line on
+ * TOKEN_ERROR), see splitContentLine for the remaining sections
+ * @param tokenizer: Tokenizer* to read from
+ * @param line: ContentLine* to store the line into
+ * @return TokenStatus: TOKEN_LINE on a new line, TOKEN_END at the end of the input,
+ *                      TOKEN_ERROR if a \r is not followed by a \n or a \n is not preceded by a \r
+ *                      (The next call continues after the offending character)
+ */
+TokenStatus nextContentLine(Tokenizer* tokenizer, ContentLine* line);
+
+/**
+ * unreadContentLine: Hands a line back so the next nextContentLine call returns it again
+ * @param tokenizer: Tokenizer* the line was read from
+ * @param line: const ContentLine* Last line returned by nextContentLine
+ */
+void unreadContentLine(Tokenizer* tokenizer, const ContentLine* line);
+
+/**
+ * splitContentLine: Splits line->line into its group, name, parameter and value sections
+ * @param line: ContentLine* to split
+ * @return VCardErrorCode: OK on a valid line, INV_PROP if there is no ':' separating the values
+ */
+VCardErrorCode splitContentLine(ContentLine* line);
+
+/**
+ * nextViewSection: Grabs the next delimiter separated section of a view. Empty sections are kept,
+ * so "a;;b;" yields "a", "", "b" and ""
+ * @param remaining: StringView* Part of the view not yet handed out. Updated on every call
+ * @param delimiter: char Character separating the sections
+ * @param respectQuotes: bool true if delimiters inside "" must be skipped
+ * @param section: StringView* to store the section into
+ * @return bool: true if a section was grabbed, false once the view is exhausted
+ */
+bool nextViewSection(StringView* remaining, char delimiter, bool respectQuotes, StringView* section);
+
+/**
+ * nextValueSection: Grabs the next ';' separated value of a property's value section. A ';' escaped as "\;" is
+ * part of the value, so the value is handed out still escaped (See unescapeValue). Empty values are kept
+ * @param remaining: StringView* Part of the value section not yet handed out. Updated on every call
+ * @param section: StringView* to store the value into
+ * @return bool: true if a value was grabbed, false once the view is exhausted
+ */
+bool nextValueSection(StringView* remaining, StringView* section);
+
+/**
+ * viewCaseEquals: Compares a view to a string, ignoring case
+ * @param view: StringView to compare
+ * @param string: const char* String to compare to
+ * @return bool: true if both contain the same characters
+ */
+bool viewCaseEquals(StringView view, const char* string);
+
+/**
+ * viewToString: Materializes a view into a new NUL terminated string
+ * @param view: StringView to copy
+ * @return char*: A dynamically created copy of the view
+ */
+char* viewToString(StringView view);
+
+#endif //ASSIGNMENT_1_VCARDTOKENIZER_H
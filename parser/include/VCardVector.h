@@ -0,0 +1,103 @@
+/**
+ * @file VCardVector.h
+ * @brief This file contains the VCard file's contiguous growable array definitions, used to store card internals.
+ * @author ADD LATER
+ */
+
+#ifndef ASSIGNMENT_1_VCARDVECTOR_H
+#define ASSIGNMENT_1_VCARDVECTOR_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+struct arena;
+
+/**
+ * A growable array of pointers, stored contiguously in insertion order.
+ * The vector does not own what its items point to
+ */
+typedef struct vector {
+    void** items;
+    size_t length;
+    size_t capacity;
+
+    //Arena the items array is allocated from. NULL for a heap array
+    struct arena* arena;
+} Vector;
+
+/**
+ * Walks a vector front to back
+ */
+typedef struct vectorIterator {
+    const Vector* vector;
+    size_t index;
+} VectorIterator;
+
+/**
+ * initializeVector: Prepares an empty vector. Nothing is allocated until the first item is added
+ * @param vector: Vector* to initialize
+ * @param arena: struct arena* to grow the vector in, NULL to grow it on the heap
+ */
+void initializeVector(Vector* vector, struct arena* arena);
+
+/**
+ * clearVectorStorage: Frees a vector's items array (The items themselves are not freed)
+ * @param vector: Vector* to clear
+ */
+void clearVectorStorage(Vector* vector);
+
+/**
+ * vectorPushBack: Adds an item after the last item
+ * @param vector: Vector* to add to
+ * @param item: void* Item to add
+ */
+void vectorPushBack(Vector* vector, void* item);
+
+/**
+ * vectorInsert: Adds an item at an index, moving the items from that index on back by one
+ * @param vector: Vector* to add to
+ * @param index: size_t Index the item will have (At most the vector's length)
+ * @param item: void* Item to add
+ */
+void vectorInsert(Vector* vector, size_t index, void* item);
+
+/**
+ * vectorRemove: Removes the item at an index, moving the items after it forward by one
+ * @param vector: Vector* to remove from
+ * @param index: size_t Index of the item (Less than the vector's length)
+ * @return void*: The removed item
+ */
+void* vectorRemove(Vector* vector, size_t index);
+
+/**
+ * vectorGet: Grabs the item at an index
+ * @param vector: const Vector* to read from
+ * @param index: size_t Index of the item
+ * @return void*: The item, NULL if the index is past the end of the vector
+ */
+void* vectorGet(const Vector* vector, size_t index);
+
+/**
+ * vectorLength: Gets the number of items in a vector
+ * @param vector: const Vector* to check
+ * @return size_t: Number of items
+ */
+size_t vectorLength(const Vector* vector);
+
+/**
+ * createVectorIterator: Creates an iterator positioned before the first item
+ * @param vector: const Vector* to iterate over
+ * @return VectorIterator: The new iterator
+ */
+VectorIterator createVectorIterator(const Vector* vector);
+
+/**
+ * nextVectorElement: Grabs the next item of an iterator
+ * @param iter: VectorIterator* to advance
+ * @return void*: The next item, NULL once the end of the vector is reached
+ */
+void* nextVectorElement(VectorIterator* iter);
+
+#endif //ASSIGNMENT_1_VCARDVECTOR_H
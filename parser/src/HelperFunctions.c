@@ -5,102 +5,130 @@
  */
 
 //NOTE: REMEMBER TO CHANGE HARDCODED FILE LOCATIONS
+//Needed for ssize_t/read/fstat/mmap under -std=c11
+#define _DEFAULT_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 #include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 #include "LinkedListAPI.h"
 #include "HelperFunctions.h"
 #include "VCardParser.h"
+#include "VCardTokenizer.h"
+#include "VCardStringBuilder.h"
+#include "VCardPropertyKind.h"
+#include "VCardDiagnostics.h"
+#include "VCardScanner.h"
 #define DEBUG false
 
-char* readFileToString(char* fileName) {
-    //Find and open the file in read mode
-    FILE* file;
-    file = fopen(fileName, "r");
+bool openInputFile(char* fileName, InputFile* input) {
+    input->contents = NULL;
+    input->length = 0;
+    input->mapped = false;
 
-    //Check if the file could open
-    if (file == NULL) {
-        //Error: File could not be opened
-        return NULL;
+    int fd = open(fileName, O_RDONLY);
+    if (fd == -1) {
+        return false;
     }
 
-    //Find size of file
-    //Seek to end of file
-    fseek(file, 0, SEEK_END);
-    //Get current file pointer
-    int fileSize = ftell(file);
-    //Seek back to beginning of file
-    fseek(file, 0, SEEK_SET);
-
-    if (fileSize == 0) {
-        fclose(file);
-        return NULL;
+    /*  Read into the heap rather than mapping the file - A mapped file that is truncated while it is parsed
+        (An upload being replaced, a card being rewritten) raises SIGBUS, and the parser runs inside the server.
+        A file that shrinks here is just read short. Pipes and devices report no size, so the buffer grows as needed
+    */
+    struct stat fileStats;
+    size_t capacity = 4096;
+    if (fstat(fd, &fileStats) == 0 && S_ISREG(fileStats.st_mode) && fileStats.st_size > 0) {
+        capacity = (size_t)fileStats.st_size + 1;
     }
 
-    //Calloc size of file for string
-    char* toReturn = calloc(fileSize, sizeof(char));
+    //NOTE: REMEMBER TO FREE contents (closeInputFile)
+    char* contents = malloc(capacity);
+    size_t length = 0;
+    while (true) {
+        //Keep a byte for the NUL terminator
+        if (length + 1 == capacity) {
+            capacity *= 2;
+            contents = realloc(contents, capacity);
+        }
 
-    //Read file contents character by character into a string
-    fread(toReturn, fileSize, 1, file);
+        ssize_t bytesRead = read(fd, contents + length, capacity - 1 - length);
+        if (bytesRead < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytesRead < 0) {
+            free(contents);
+            close(fd);
+            return false;
+        }
+        if (bytesRead == 0) {
+            break;
+        }
+        length += (size_t)(bytesRead);
+    }
+    close(fd);
 
-    //Close file
-    fclose(file);
+    if (length == 0) {
+        free(contents);
+        return false;
+    }
+    contents[length] = '\0';
 
-    //NOTE: REMEMBER TO FREE toReturn IN CALLING FUNCTION
-    return toReturn;
-}
+    if (DEBUG)printf("openInputFile: read %zu bytes of %s\n", length, fileName);
 
-char** split(char* stringToSplit, int* length, char* delimiters, bool whiteSpaceCheck) {
-    //Declare variables
-    char** toReturn = 0;
-    char* currentString;
-    int i = 0;
+    input->contents = contents;
+    input->length = length;
+    return true;
+}
 
-    //Perform the first string tokenize
-    currentString = strtok(stringToSplit, delimiters);
-
-    //Go through all strings that end in \r\n
-    while (currentString != 0) {
-        //Check if the first character of the string is \t or ' ' for concatenation
-        if (whiteSpaceCheck) {
-            if (currentString[0] == '\t' || currentString[0] == ' ') {
-                //Remove single whitespace '\t' || ' ' from string before concatenation
-                int length = strlen(currentString);
-                //Go through entire string to replace the first character (\t || ' ')
-                for (int j = 0; j < length; j++) {
-                    currentString[j] = currentString[j + 1];
-                }
+bool mapInputFile(char* fileName, InputFile* input) {
+    int fd = open(fileName, O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
 
-                //Reallocate space for string + concatenation
-                toReturn[i - 1] = realloc(toReturn[i - 1], strlen(toReturn[i - 1]) + strlen(currentString) + 1);
+    //Only regular files can be mapped, and the page holding the last byte must have a byte to spare for the '\0'
+    struct stat fileStats;
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (fstat(fd, &fileStats) != 0 || S_ISREG(fileStats.st_mode) == false || fileStats.st_size <= 0 ||
+        pageSize <= 0 || fileStats.st_size % pageSize == 0) {
+        close(fd);
+        return openInputFile(fileName, input);
+    }
 
-                //Concatenate string to previous string
-                strcat(toReturn[i - 1], currentString);
+    //Private and writable - Unfolding a line copies only the page it is on, and the file never changes
+    size_t length = (size_t)(fileStats.st_size);
+    char* contents = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (contents == MAP_FAILED) {
+        return openInputFile(fileName, input);
+    }
 
-                //Continue to next string tokenize
-                currentString = strtok(NULL, delimiters);
-                continue;
-            }
-        }
+    //The rest of the last page is zero filled, so contents[length] is the '\0'
+    if (DEBUG)printf("mapInputFile: mapped %zu bytes of %s\n", length, fileName);
 
-        //Allocate space for the string
-        toReturn = realloc(toReturn, (i + 1) * sizeof(char*));
-        toReturn[i] = calloc(strlen(currentString) + 1, sizeof(char));
+    input->contents = contents;
+    input->length = length;
+    input->mapped = true;
+    return true;
+}
 
-        //Copy the string into the 2d array location
-        strcpy(toReturn[i], currentString);
-        //Increment i
-        i++;
-        //Tokenize again
-        currentString = strtok(NULL, delimiters);
+void closeInputFile(InputFile* input) {
+    if (input->mapped) {
+        munmap(input->contents, input->length);
+    }
+    else {
+        free(input->contents);
     }
-    //Set the length of the 2d array to i
-    *length = i;
 
-    //Return the 2d array of strings
-    return toReturn;
+    input->contents = NULL;
+    input->length = 0;
+    input->mapped = false;
 }
 
 bool verifyFileName(char* fileName) {
@@ -124,7 +152,17 @@ bool verifyFileName(char* fileName) {
     }
 }
 
-Card* initializeCard() {
+Card* initializeCard(Arena* arena) {
+    if (arena != NULL) {
+        Card* newCard = arenaAlloc(arena, sizeof(Card));
+        newCard->fn = NULL;
+        newCard->birthday = NULL;
+        newCard->anniversary = NULL;
+        //deleteCard finds the arena to release through this list
+        newCard->optionalProperties = initializeListInArena(arena, printProperty, deleteProperty, compareProperties);
+        return newCard;
+    }
+
     Card* newCard = malloc(sizeof(Card));
     newCard->fn = NULL;
     newCard->birthday = NULL;
@@ -133,8 +171,10 @@ Card* initializeCard() {
     return newCard;
 }
 
-DateTime* createDateTime(int flexSize) {
-    DateTime* newDateTime = malloc(sizeof(DateTime) + flexSize * sizeof(char));
+DateTime* createDateTime(int flexSize, Arena* arena) {
+    //Always room for the text's '\0'
+    size_t size = sizeof(DateTime) + (flexSize > 0 ? flexSize : 1) * sizeof(char);
+    DateTime* newDateTime = arena != NULL ? arenaAlloc(arena, size) : malloc(size);
     newDateTime->UTC = false;
     newDateTime->isText = false;
     memset(newDateTime->date, '\0', 9);
@@ -143,22 +183,47 @@ DateTime* createDateTime(int flexSize) {
     return newDateTime;
 }
 
-Parameter* createParameter(int flexSize) {
-    Parameter* newParameter = malloc(sizeof(Parameter) + flexSize * sizeof(char));
+Parameter* createParameter(int flexSize, Arena* arena) {
+    size_t size = sizeof(Parameter) + flexSize * sizeof(char);
+    Parameter* newParameter = arena != NULL ? arenaAlloc(arena, size) : malloc(size);
     newParameter->name[0] = '\0';
     newParameter->value[0] = '\0';
     return newParameter;
 }
 
-Property* createProperty() {
+Property* createProperty(Arena* arena) {
+    if (arena != NULL) {
+        Property* newProperty = arenaAlloc(arena, sizeof(Property));
+        newProperty->name = NULL;
+        newProperty->group = NULL;
+        newProperty->parameters = initializeListInArena(arena, printParameter, deleteParameter, compareParameters);
+        newProperty->values = initializeListInArena(arena, printValue, deleteValue, compareValues);
+        newProperty->kind = PROP_UNRESOLVED;
+        return newProperty;
+    }
+
     Property* newProperty = malloc(sizeof(Property));
     newProperty->name = NULL;
     newProperty->group = NULL;
     newProperty->parameters = initializeList(printParameter, deleteParameter, compareParameters);
     newProperty->values = initializeList(printValue, deleteValue, compareValues);
+    newProperty->kind = PROP_UNRESOLVED;
     return newProperty;
 }
 
+/**
+ * copyView: Materializes a view into a new string, in an arena if one is given
+ * @param view: StringView to copy
+ * @param arena: Arena* to allocate the string from, NULL to allocate it on the heap
+ * @return char*: A NUL terminated copy of the view
+ */
+static char* copyView(StringView view, Arena* arena) {
+    if (arena != NULL) {
+        return arenaStringCopy(arena, view.start, view.length);
+    }
+    return viewToString(view);
+}
+
 void stringUpper(char* string) {
     int i = 0;
     while (string[i] != '\0') {
@@ -170,80 +235,11 @@ void stringUpper(char* string) {
 }
 
 int numberOfCharacters(char* string, char toSearch) {
-    int countToReturn = 0;
-
-    for (int i = 0; i < strlen(string); i++) {
-        if (string[i] == toSearch) {
-            countToReturn++;
-        }
-    }
-
+    //One strlen, then one pass over the string
+    int countToReturn = (int)(countCharacter(string, string + strlen(string), toSearch));
     return countToReturn;
 }
 
-bool verifyStringEndOfLines(char* string) {
-    if (string[0] == '\r' || string[0] == '\n' || string[0] == '\0') {
-        return false;
-    }
-    int quotationCounter = 0;
-    int stringLength = (int)(strlen(string));
-
-    for (int i = 0; i < stringLength; i++) {
-        if (string[i] == '"') {
-            quotationCounter++;
-            if (quotationCounter == 2) {
-                quotationCounter = 0;
-            }
-        }
-
-        if (quotationCounter == 0) {
-            if (string[i] == '\n') {
-                if (string[i - 1] != '\r') {
-                    return false;
-                }
-            }
-
-            if (string[i] == '\r') {
-                if (string[i + 1] != '\n') {
-                    return false;
-                }
-            }
-        }
-    }
-
-    return true;
-}
-
-void removeBackslash(char* string) {
-    int quotationCounter = 0;
-    int stringLength = (int)(strlen(string));
-
-    for (int i = 0; i < stringLength; i++) {
-        if (string[i] == '"') {
-            quotationCounter++;
-            if (quotationCounter == 2) {
-                quotationCounter = 0;
-            }
-        }
-
-        if (quotationCounter == 1) {
-            if (string[i] == ',' || string[i] == '\\' || string[i] == ';') {
-                if (string[i] == ';') {
-                    //Replace semi-colon with another character to reduce parsing issues later
-                    //NOTE: Look for all '^' at the end and replace it back with a ';'
-                    string[i] = '^';
-                }
-
-                if (string[i - 1] == '\\') {
-                    //Remove backslash
-                    int indexToDelete = i - 1;
-                    memmove(&string[indexToDelete], &string[indexToDelete + 1], strlen(string) - indexToDelete);
-                }
-            }
-        }
-    }
-}
-
 int stringCaseCompare(const char* string1, const char* string2) {
     int d = 0;
     for ( ; ; ) {
@@ -256,232 +252,147 @@ int stringCaseCompare(const char* string1, const char* string2) {
     return d;
 }
 
-void noParamOneValue(Card* mainCard, Property* toStoreIn, char* sectionOfLine, char* values, bool groupSet) {
-    if (groupSet == true) {
-        //Skip first tokenize on "."
-        sectionOfLine = strtok(sectionOfLine, ".");
-        sectionOfLine = strtok(NULL, ":");
-    }
-    else {
-        sectionOfLine = strtok(sectionOfLine, ":");
+VCardErrorCode addParametersToProperty(Property* toStoreIn, StringView parameters) {
+    if (toStoreIn == NULL) {
+        return INV_PROP;
     }
 
-//    sectionOfLine = strtok(sectionOfLine, ":");
-    if(DEBUG)printf("Property: %s\n", sectionOfLine);
-    //NOTE: REMEMBER TO FREE newProperty->name
-    toStoreIn->name = calloc(strlen(sectionOfLine) + 1, sizeof(char));
-    strcpy(toStoreIn->name, sectionOfLine);
-    if(DEBUG)printf("Value(s): %s\n", values);
-    //NOTE: REMEMBER TO FREE value
-    char* propertyValue = calloc(strlen(values) + 1, sizeof(char));
-    strcpy(propertyValue, values);
-    insertBack(toStoreIn->values, propertyValue);
-}
-
-void noParamMultipleValues(Card* mainCard, Property* toStoreIn, char* sectionOfLine, char* values, bool groupSet) {
-    //Should be a property followed by a list of values - delimit on ';' && ':'
-    //Count how many semi colons there are - compare to the number of values created
-    int valueCount = 0;
-    int semiColonCount = numberOfCharacters(sectionOfLine, ';');
-    char* section = NULL;
-
-    //Create Property* structure based on currentLine
-    if (groupSet == true) {
-        //Skip first tokenize on "."
-        section = strtok(sectionOfLine, ".");
-        section = strtok(NULL, ":;");
-    }
-    else {
-        section = strtok(sectionOfLine, ":;");
-    }
+    StringView remaining = parameters;
+    StringView parameter;
 
-//    char* section = strtok(sectionOfLine, ":;");
-    if(DEBUG)printf("Property: %s\n", section);
+    //Parameters are separated by ';' - A ';' inside a quoted parameter value does not end the parameter
+    while (nextViewSection(&remaining, ';', true, &parameter)) {
+        //Every parameter must be NAME=VALUE
+        const char* equals = memchr(parameter.start, '=', parameter.length);
+        if (equals == NULL) {
+            return INV_PROP;
+        }
 
-    //NOTE: REMEMBER TO FREE newProperty->name
-    toStoreIn->name = calloc(strlen(section) + 1, sizeof(char));
-    strcpy(toStoreIn->name, section);
+        size_t nameLength = (size_t)(equals - parameter.start);
+        size_t valueLength = parameter.length - nameLength - 1;
 
-    //Begin grabbing all values and storing into Property* structure
-    while (section) {
-        section = strtok(NULL, ";");
-        if (section != NULL) {
-            valueCount++;
-            if(DEBUG)printf("Value(s): %s\n", section);
-            char* value = calloc(strlen(section) + 1, sizeof(char));
-            strcpy(value, section);
-            insertBack(toStoreIn->values, value);
-        }
-    }
-    int toAdd = 0;
-    //Handles empty string values that must be added
-    if (valueCount <= semiColonCount) {
-        toAdd = semiColonCount - valueCount;
-        if (toAdd >= 0) {
-            toAdd++;
+        //Parameter names are stored in a 200 byte array
+        if (nameLength == 0 || nameLength >= 200 || valueLength == 0) {
+            return INV_PROP;
         }
-        for (int i = 0; i < toAdd; i++) {
-            if(DEBUG)printf("Value(s): \n");
-            //NOTE: REMEMBER TO FREE value
-            char* value = calloc(1, sizeof(char));
-            strcpy(value, "");
-            insertBack(toStoreIn->values, value);
+
+        //NOTE: REMEMBER TO FREE newParameter (Gets freed in freeList)
+        Parameter* newParameter = createParameter((int)(valueLength) + 1, toStoreIn->parameters->arena);
+        memcpy(newParameter->name, parameter.start, nameLength);
+        newParameter->name[nameLength] = '\0';
+
+        //Copy the value, removing the backslash before an escaped ',', ';' or '\\' inside quotes
+        const char* value = equals + 1;
+        bool inQuotes = false;
+        int j = 0;
+        for (size_t i = 0; i < valueLength; i++) {
+            if (value[i] == '"') {
+                inQuotes = !inQuotes;
+            }
+            else if (inQuotes && value[i] == '\\' && i + 1 < valueLength) {
+                if (value[i + 1] == ',' || value[i + 1] == ';' || value[i + 1] == '\\') {
+                    i++;
+                }
+            }
+            newParameter->value[j++] = value[i];
         }
+        newParameter->value[j] = '\0';
+        if(DEBUG)printf("Parameter: %s=%s\n", newParameter->name, newParameter->value);
+
+        insertBack(toStoreIn->parameters, newParameter);
     }
+
+    return OK;
 }
 
-void params(Card* mainCard, Property* toStoreIn, List* parameters, char* sectionOfLine, char* values, bool groupSet) {
-    //Now there are parameters
-    if (groupSet == true) {
-        sectionOfLine = strchr(sectionOfLine, '.');
-        sectionOfLine++;
+char* unescapeValue(StringView value, Arena* arena) {
+    //Most values have nothing to unescape
+    if (memchr(value.start, '\\', value.length) == NULL) {
+        return copyView(value, arena);
     }
 
-    if(DEBUG)printf("Property: %s\n", sectionOfLine);
-    //NOTE: REMEMBER TO FREE newProperty->name
-    toStoreIn->name = calloc(strlen(sectionOfLine) + 1, sizeof(char));
-    strcpy(toStoreIn->name, sectionOfLine);
-
-    //Create a copy of values
-    int valuesLength = strlen(values);
-    char* valuesCopy = calloc(valuesLength + 1, sizeof(char));
-    strcpy(valuesCopy, values);
-    //NOTE: REMEMBER TO FREE valuesCopyPointer
-    char* valuesCopyPointer = valuesCopy;
-
-    int valueCount = 0;
-    int semiColonCount = numberOfCharacters(valuesCopy, ';');
-
-    //If validated, parse using strtok currentLine ";" based on the return integer value of # of semi-colons
-    //Read through line until a colon is reached - once the colon is reached, all parameters have been received
-    while (sectionOfLine) {
-	sectionOfLine = strtok(NULL, ";");
-        if (numberOfCharacters(sectionOfLine, '^') > 0) {
-            //Go through line and replace all ^ with ;
-            int length = strlen(sectionOfLine);
-            for (int j = 0; j < length; j++) {
-                if (sectionOfLine[j] == '^') {
-                    sectionOfLine[j] = ';';
-                }
-            }
-        }
-        if (sectionOfLine) {
-            //if currentLine contains ':', read until ':' - That's the last parameter
-            //Break from loop after last parameter created
-            //NOTE: Deal with last parameter and get rid of value
-            if (numberOfCharacters(sectionOfLine, ':') > 0) {
-                //Read until ':' - Last parameter
-                char* lastParam = sectionOfLine;
-                lastParam = strtok(lastParam, ":");
-                //NOTE: REMEMBER TO FREE tempParameter (Gets freed in freeList)
-                char* tempParameter = calloc(strlen(lastParam) + 1, sizeof(char));
-                strcpy(tempParameter, lastParam);
-                insertBack(parameters, tempParameter);
-                break;
+    //Unescaping never makes a value longer, so one buffer of the escaped length is enough
+    //NOTE: REMEMBER TO FREE toReturn IN CALLING FUNCTION (Unless it comes from an arena)
+    char* toReturn = arena != NULL ? arenaAlloc(arena, value.length + 1) : malloc(value.length + 1);
+    const char* read = value.start;
+    const char* end = value.start + value.length;
+    char* write = toReturn;
+
+    while (read < end) {
+        if (*read == '\\' && read + 1 < end) {
+            char escaped = read[1];
+            if (escaped == 'n' || escaped == 'N') {
+                *write++ = '\n';
+                read += 2;
+                continue;
             }
-            else {
-                //NOTE: REMEMBER TO FREE tempParameter (Gets freed in freeList)
-                char* tempParameter = calloc(strlen(sectionOfLine) + 1, sizeof(char));
-                strcpy(tempParameter, sectionOfLine);
-                insertBack(parameters, tempParameter);
+            if (escaped == ',' || escaped == ';' || escaped == '\\') {
+                *write++ = escaped;
+                read += 2;
+                continue;
             }
-	}
+        }
+        *write++ = *read++;
     }
+    *write = '\0';
 
-    valuesCopy = strtok(valuesCopy, ";");
+    return toReturn;
+}
 
-    while (valuesCopy) {
-        if (valuesCopy != NULL) {
+int countPropertyValues(StringView values) {
+    //Same split as addValuesToProperty - Every ';' that is not escaped separates two values
+    int valueCount = 1;
+    const char* p = values.start;
+    const char* end = values.start + values.length;
+    while ((p = scanForEither(p, end, ';', '\\')) < end) {
+        if (*p == ';') {
             valueCount++;
-            if(DEBUG)printf("Value(s): %s\n", valuesCopy);
-            char* value = calloc(strlen(valuesCopy) + 1, sizeof(char));
-            strcpy(value, valuesCopy);
-            insertBack(toStoreIn->values, value);
-        }
-        valuesCopy = strtok(NULL, ";");
-    }
-    int toAdd = 0;
-    //Handles empty string values that must be added
-    if (valueCount <= semiColonCount) {
-        toAdd = semiColonCount - valueCount;
-        if (toAdd >= 0) {
-            toAdd++;
-        }
-        for (int i = 0; i < toAdd; i++) {
-            if(DEBUG)printf("Value(s): \n");
-            //NOTE: REMEMBER TO FREE value
-            char* value = calloc(1, sizeof(char));
-            strcpy(value, "");
-            insertBack(toStoreIn->values, value);
         }
+        p += *p == '\\' && p + 1 < end ? 2 : 1;
     }
+    return valueCount;
+}
+
+void addValuesToProperty(Property* toStoreIn, StringView values) {
+    StringView remaining = values;
+    StringView value;
 
-    free(valuesCopyPointer);
+    //Every ';' separates two values, so empty values keep their position
+    while (nextValueSection(&remaining, &value)) {
+        //NOTE: REMEMBER TO FREE value (Gets freed in freeList)
+        char* propertyValue = unescapeValue(value, toStoreIn->values->arena);
+        if(DEBUG)printf("Value(s): %s\n", propertyValue);
+        insertBack(toStoreIn->values, propertyValue);
+    }
 }
 
-VCardErrorCode addParametersToProperty(Property* toStoreIn, List* parameters) {
-    if (toStoreIn == NULL || parameters == NULL) {
+VCardErrorCode createPropertyFromLine(const ContentLine* line, Property** newProperty, Arena* arena) {
+    *newProperty = NULL;
+
+    //Property name and values must not be empty
+    if (line->name.length == 0 || line->values.length == 0) {
         return INV_PROP;
     }
 
-    if (parameters->length > 0) {
-        Node* temp = parameters->head;
-        while (temp) {
-	    if (temp->data == NULL) {
-                return INV_PROP;
-	    }
-            char* parameterToParse = (char*)(temp->data);
-	    if (parameterToParse == NULL) {
-                //Error
-		return INV_PROP;
-	    }
-            char* parameterCopy = calloc(strlen(parameterToParse) + 1, sizeof(char));
-            strcpy(parameterCopy, parameterToParse);
-
-            //NOTE: REMEMBER TO FREE parameterCopyPointer
-	    if (numberOfCharacters(parameterCopy, '=') == 0) {
-                free(parameterCopy);
-		return INV_PROP;
-	    }
-            char* parameterCopyPointer = parameterCopy;
-            parameterCopy = strtok(parameterCopy, "=");
-
-            //NOTE: REMEMBER TO FREE parameterName
-	    if (parameterCopy == NULL) {
-                //Error
-		free(parameterCopyPointer);
-		return INV_PROP;
-	    }
-            char* parameterName = calloc(strlen(parameterCopy) + 1, sizeof(char));
-            strcpy(parameterName, parameterCopy);
-            if(DEBUG)printf("Parameter Name: %s\n", parameterName);
-
-            parameterCopy = strtok(NULL, "=");
-
-	    if (parameterCopy == NULL) {
-                //Error
-		free(parameterCopyPointer);
-		free(parameterName);
-		return INV_PROP;
-	    }
-
-            //NOTE: REMEMBER TO FREE parameterValue
-            char* parameterValue = calloc(strlen(parameterCopy) + 1, sizeof(char));
-            strcpy(parameterValue, parameterCopy);
-            if(DEBUG)printf("Parameter Value: %s\n", parameterValue);
-
-            Parameter* newParameter = createParameter(strlen(parameterValue) + 1);
-            strcpy(newParameter->name, parameterName);
-            strcpy(newParameter->value, parameterValue);
-
-            insertBack(toStoreIn->parameters, newParameter);
-
-            free(parameterName);
-            free(parameterValue);
-            free(parameterCopyPointer);
-            temp = temp->next;
+    //NOTE: REMEMBER TO FREE toReturn
+    Property* toReturn = createProperty(arena);
+    toReturn->name = copyView(line->name, arena);
+    //Resolved once here, so later checks switch on the kind instead of comparing names
+    toReturn->kind = lookupPropertyKind(line->name);
+    //Group is an empty string if the line has no group
+    toReturn->group = copyView(line->group, arena);
+    if(DEBUG)printf("Property: %s group: %s\n", toReturn->name, toReturn->group);
+
+    if (line->hasParameters) {
+        if (addParametersToProperty(toReturn, line->parameters) != OK) {
+            deleteProperty(toReturn);
+            return INV_PROP;
         }
     }
+
+    addValuesToProperty(toReturn, line->values);
+
+    *newProperty = toReturn;
     return OK;
 }
 
@@ -521,9 +432,8 @@ DateTime* parseDate(Property* currentProperty) {
         }
 
         if (currentProperty->parameters->length > 0) {
-            Node* temp = currentProperty->parameters->head;
-            while (temp != NULL) {
-                Parameter* tempParam = (Parameter*)(temp->data);
+            for (size_t i = 0; i < vectorLength(&currentProperty->parameters->elements); i++) {
+                Parameter* tempParam = (Parameter*)(vectorGet(&currentProperty->parameters->elements, i));
                 if (stringCaseCompare(tempParam->name, "VALUE") == 0) {
                     if (stringCaseCompare(tempParam->value, "text") == 0) {
                         isText = true;
@@ -537,25 +447,26 @@ DateTime* parseDate(Property* currentProperty) {
                         //INVProp
                     }
 		}
-		temp = temp->next;
             }
         }
 
         //Tokenize on 'T' to get date/time values if isText == false
         if (isText == false) {
+            //Position for strtok_r - Keeps parseDate reentrant
+            char* tokenState = NULL;
             if (strchr(valuesString, 'T') != NULL) {
 		if (valuesString[0] == 'T') {
                     //Only a time
-		    valuesString = strtok(valuesString, "T");
+		    valuesString = strtok_r(valuesString, "T", &tokenState);
 		    time = calloc(strlen(valuesString) + 1, sizeof(char));
 		    strcpy(time, valuesString);
 		}
 		else {
-                    valuesString = strtok(valuesString, "T");
+                    valuesString = strtok_r(valuesString, "T", &tokenState);
                     date = calloc(strlen(valuesString) + 1, sizeof(char));
                     strcpy(date, valuesString);
 
-                    valuesString = strtok(NULL, "T");
+                    valuesString = strtok_r(NULL, "T", &tokenState);
 		    if (valuesString == NULL) {
                         time = calloc(1, sizeof(char));
 		        strcpy(time, "");
@@ -575,7 +486,7 @@ DateTime* parseDate(Property* currentProperty) {
         free(valuesStringPtr);
     }
 
-    DateTime* newDate = createDateTime(flexSize);
+    DateTime* newDate = createDateTime(flexSize, currentProperty->values->arena);
     newDate->UTC = UTC;
     newDate->isText = isText;
     if (isText == false) {
@@ -662,279 +573,6 @@ bool validateDateTime(DateTime* currentDateTime) {
     return true;
 }
 
-char* groupCheck(char* line) {
-    char lineCopy[998];
-    lineCopy[0] = '\0';
-    strcpy(lineCopy, line);
-    char* returned = strchr(lineCopy, '.');
-    if (returned != NULL) {
-        *returned = '\0';
-        if (numberOfCharacters(lineCopy, ';') > 0 || numberOfCharacters(lineCopy, ':') > 0) {
-            return NULL;
-        }
-        else {
-            char* toReturn = calloc(strlen(lineCopy) + 1, sizeof(char));
-            strcpy(toReturn, lineCopy);
-            return toReturn;
-        }
-    }
-    return NULL;
-}
-
-VCardErrorCode propertyCheck(char* line) {
-    char* lineCopy = NULL;
-    lineCopy = calloc(strlen(line) + 1, sizeof(char));
-    strcpy(lineCopy, line);
-
-    char* lineCopyPointer = lineCopy;
-
-    lineCopy = strtok(lineCopy, ";:");
-    lineCopy = strtok(NULL, ";:");
-    if (lineCopy == NULL || strcmp(lineCopy, "") == 0) {
-	    free(lineCopyPointer);
-        return INV_PROP;
-    }
-    free(lineCopyPointer);
-    return OK;
-}
-
-bool verifyOnlyOnce(char* line) {
-    //Check first line of VCard
-    if (stringCaseCompare(line, "BEGIN:VCARD") == 0) {
-        return false;
-    }
-
-    //Check second line of VCard
-    if (stringCaseCompare(line, "VERSION:4.0") == 0) {
-        return false;
-    }
-
-    //Check last line of VCard
-    if (stringCaseCompare(line, "END:VCARD") == 0) {
-        return false;
-    }
-
-    return true;
-}
-
-void writeProperty(FILE* file, Property* toWrite) {
-    if (file != NULL && toWrite != NULL) {
-        if (strcmp(toWrite->group, "") != 0) {
-            //Write group
-            fprintf(file, "%s.", toWrite->group);
-        }
-
-        //Write Property* name with appropriate ; OR :
-        if (toWrite->parameters->length > 0) {
-            fprintf(file, "%s;", toWrite->name);
-        }
-        else {
-            fprintf(file, "%s:", toWrite->name);
-        }
-
-        //Check for Parameters*
-        if (toWrite->parameters->length > 0) {
-            Node* temp = toWrite->parameters->head;
-            while (temp != NULL) {
-                //Check if at tail
-                if (temp->next == NULL) {
-                    Parameter* currentParam = (Parameter*)(temp->data);
-                    fprintf(file, "%s=%s:", currentParam->name, currentParam->value);
-                    temp = temp->next;
-                }
-                else {
-                    Parameter* currentParam = (Parameter*)(temp->data);
-                    fprintf(file, "%s=%s;", currentParam->name, currentParam->value);
-                    temp = temp->next;
-                }
-            }
-        }
-
-        //Check for Property* values
-        if (toWrite->values->length > 0) {
-            Node* temp = toWrite->values->head;
-            while (temp != NULL) {
-                //Check if at tail
-                if (temp->next == NULL) {
-                    if (strcmp((char*)(temp->data), "") == 0) {
-                        fprintf(file, "%s;\r\n", (char*)(temp->data));
-                    }
-                    else {
-                        fprintf(file, "%s\r\n", (char*)(temp->data));
-                    }
-                    temp = temp->next;
-                }
-                else {
-                    fprintf(file, "%s;", (char*)(temp->data));
-                    temp = temp->next;
-                }
-            }
-        }
-    }
-}
-
-void writeDateTime(FILE* file, DateTime* toWrite, bool isAnniversary, bool isBDay) {
-    if (file == NULL || toWrite == NULL) {
-        return;
-    }
-
-    if (isAnniversary) {
-        fprintf(file, "ANNIVERSARY");
-    }
-
-    if (isBDay) {
-        fprintf(file, "BDAY");
-    }
-
-    if (toWrite->isText) {
-        if (toWrite->UTC) {
-            //Must append a 'Z' to the end
-            fprintf(file, ";VALUE=text:%sZ\r\n", toWrite->text);
-        }
-        else {
-            fprintf(file, ";VALUE=text:%s\r\n", toWrite->text);
-        }
-    }
-    else {
-        fprintf(file, ":");
-
-        if (toWrite->UTC) {
-            //Must append a 'Z' to the end
-            if (toWrite->date[0] != '\0') {
-                fprintf(file, "%s", toWrite->date);
-            }
-            if (toWrite->time[0] != '\0') {
-                fprintf(file, "T%s", toWrite->time);
-            }
-            fprintf(file, "Z\r\n");
-        }
-        else {
-            if (toWrite->date[0] != '\0') {
-                fprintf(file, "%s", toWrite->date);
-            }
-            if (toWrite->time[0] != '\0') {
-                fprintf(file, "T%s", toWrite->time);
-            }
-            fprintf(file, "\r\n");
-        }
-    }
-}
-
-void populatePropertyList(List* toPopulate) {
-
-    if (toPopulate == NULL) {
-        return;
-    }
-
-    /**
-     * Cardinality:
-     * 1 - Exactly one instance MUST be present in card
-     * * - One or more instances MAY be present in card
-     * *1 - Exactly one instance MAY be present in card
-     * 1* - One or more instances MUST be present in card
-     */
-    //Insert all valid properties into list toPopulate (BEGIN/VERSION/END not added - may only appear once and validated elsewhere)
-    char* source = calloc(7, sizeof(char));
-    strcpy(source, "SOURCE");
-    insertBack(toPopulate, source); //Cardinality: * - Property values count: 1
-    char* kind = calloc(5, sizeof(char));
-    strcpy(kind, "KIND");
-    insertBack(toPopulate, kind); //Cardinality: *1 - Property values count: 1
-    char* xml = calloc(4, sizeof(char));
-    strcpy(xml, "XML");
-    insertBack(toPopulate, xml); //Cardinality: * - Property values count: 1
-    char* fn = calloc(3, sizeof(char));
-    strcpy(fn, "FN");
-    insertBack(toPopulate, fn); //Cardinality: 1* - Property values count: 1
-    char* n = calloc(2, sizeof(char));
-    strcpy(n, "N");
-    insertBack(toPopulate, n); //Cardinality: *1 - Property values count: 5
-    char* nickname = calloc(9, sizeof(char));
-    strcpy(nickname, "NICKNAME");
-    insertBack(toPopulate, nickname); //Cardinality: * - Property values count: * (List - Can have unlimited values)
-    char* photo = calloc(6, sizeof(char));
-    strcpy(photo, "PHOTO");
-    insertBack(toPopulate, photo); //Cardinality: * - Property values count: 1
-    char* gender = calloc(7, sizeof(char));
-    strcpy(gender, "GENDER");
-    insertBack(toPopulate, gender); //Cardinality: *1 - Property values count: 1-2 (May have text after the first value)
-    char* adr = calloc(4, sizeof(char));
-    strcpy(adr, "ADR");
-    insertBack(toPopulate, adr); //Cardinality: * - Property values count: 7
-    char* tel = calloc(4, sizeof(char));
-    strcpy(tel, "TEL");
-    insertBack(toPopulate, tel); //Cardinality: * - Property values count: 1-2
-    char* email = calloc(6, sizeof(char));
-    strcpy(email, "EMAIL");
-    insertBack(toPopulate, email); //Cardinality: * - Property values count: 1
-    char* impp = calloc(5, sizeof(char));
-    strcpy(impp, "IMPP");
-    insertBack(toPopulate, impp); //Cardinality: * - Property values count: 1
-    char* lang = calloc(5, sizeof(char));
-    strcpy(lang, "LANG");
-    insertBack(toPopulate, lang); //Cardinality: * - Property values count: 1
-    char* tz = calloc(3, sizeof(char));
-    strcpy(tz, "TZ");
-    insertBack(toPopulate, tz); //Cardinality: * - Property values count: 1
-    char* geo = calloc(4, sizeof(char));
-    strcpy(geo, "GEO");
-    insertBack(toPopulate, geo); //Cardinality: * - Property values count: 1
-    char* title = calloc(6, sizeof(char));
-    strcpy(title, "TITLE");
-    insertBack(toPopulate, title); //Cardinality: * - Property values count: 1
-    char* role = calloc(5, sizeof(char));
-    strcpy(role, "ROLE");
-    insertBack(toPopulate, role); //Cardinality: * - Property values count: 1
-    char* logo = calloc(5, sizeof(char));
-    strcpy(logo, "LOGO");
-    insertBack(toPopulate, logo); //Cardinality: * - Property values count: 1
-    char* org = calloc(4, sizeof(char));
-    strcpy(org, "ORG");
-    insertBack(toPopulate, org); //Cardinality: * - Property values count: * (Can have unlimited values)
-    char* member = calloc(7, sizeof(char));
-    strcpy(member, "MEMBER");
-    insertBack(toPopulate, member); //Cardinality: * - Property values count: 1
-    char* related = calloc(8, sizeof(char));
-    strcpy(related, "RELATED");
-    insertBack(toPopulate, related); //Cardinality: * - Property values count: 1
-    char* categories = calloc(11, sizeof(char));
-    strcpy(categories, "CATEGORIES");
-    insertBack(toPopulate, categories); //Cardinality: * - Property values count: * (List - Can have unlimited values)
-    char* note = calloc(5, sizeof(char));
-    strcpy(note, "NOTE");
-    insertBack(toPopulate, note); //Cardinality: * - Property values count: 1
-    char* prodid = calloc(7, sizeof(char));
-    strcpy(prodid, "PRODID");
-    insertBack(toPopulate, prodid); //Cardinality: *1 - Property values count: 1
-    char* rev = calloc(4, sizeof(char));
-    strcpy(rev, "REV");
-    insertBack(toPopulate, rev); //Cardinality: *1 - Property values count: 1
-    char* sound = calloc(6, sizeof(char));
-    strcpy(sound, "SOUND");
-    insertBack(toPopulate, sound); //Cardinality: * - Property values count: 1
-    char* uid = calloc(4, sizeof(char));
-    strcpy(uid, "UID");
-    insertBack(toPopulate, uid); //Cardinality: *1 - Property values count: 1
-    char* clientpidmap = calloc(13, sizeof(char));
-    strcpy(clientpidmap, "CLIENTPIDMAP");
-    insertBack(toPopulate, clientpidmap); //Cardinality: * - Property values count: 2
-    char* url = calloc(4, sizeof(char));
-    strcpy(url, "URL");
-    insertBack(toPopulate, url); //Cardinality: * - Property values count: 1
-    char* key = calloc(4, sizeof(char));
-    strcpy(key, "KEY");
-    insertBack(toPopulate, key); //Cardinality: * - Property values count: 1
-    char* fburl = calloc(6, sizeof(char));
-    strcpy(fburl, "FBURL");
-    insertBack(toPopulate, fburl); //Cardinality: * - Property values count: 1
-    char* caladruri = calloc(10, sizeof(char));
-    strcpy(caladruri, "CALADRURI");
-    insertBack(toPopulate, caladruri); //Cardinality: * - Property values count: 1
-    char* caluri = calloc(7, sizeof(char));
-    strcpy(caluri, "CALURI");
-    insertBack(toPopulate, caluri); //Cardinality: * - Property values count: 1
-}
-
 VCardErrorCode errorCheckProperty(Property* toCheck) {
     if (toCheck == NULL) {
         return INV_PROP;
@@ -953,16 +591,14 @@ VCardErrorCode errorCheckProperty(Property* toCheck) {
     }
 
     if (toCheck->parameters->length > 0) {
-        Node* currentParam = toCheck->parameters->head;
-        while (currentParam != NULL) {
-            Parameter* currentParameter = (Parameter*)(currentParam->data);
+        for (size_t i = 0; i < vectorLength(&toCheck->parameters->elements); i++) {
+            Parameter* currentParameter = (Parameter*)(vectorGet(&toCheck->parameters->elements, i));
             if (currentParameter->name[0] == '\0') {
                 return INV_PROP;
             }
             if (currentParameter->value[0] == '\0') {
                 return INV_PROP;
             }
-            currentParam = currentParam->next;
         }
     }
 
@@ -970,12 +606,10 @@ VCardErrorCode errorCheckProperty(Property* toCheck) {
         return INV_PROP;
     }
 
-    Node* currentValue = toCheck->values->head;
-    while (currentValue != NULL) {
-        if (currentValue->data == NULL) {
+    for (size_t i = 0; i < vectorLength(&toCheck->values->elements); i++) {
+        if (vectorGet(&toCheck->values->elements, i) == NULL) {
             return INV_PROP;
         }
-        currentValue = currentValue->next;
     }
 
 
@@ -1063,54 +697,7 @@ VCardErrorCode checkPropertyValueCount(Property* toCheck) {
         return INV_PROP;
     }
 
-    if (stringCaseCompare(toCheck->name, "N") == 0) {
-        if (toCheck->values->length != 5) {
-            return INV_PROP;
-        }
-    }
-    else if (stringCaseCompare(toCheck->name, "ADR") == 0) {
-        if (toCheck->values->length != 7) {
-            return INV_PROP;
-        }
-    }
-    else if (stringCaseCompare(toCheck->name, "NICKNAME") == 0 || stringCaseCompare(toCheck->name, "ORG") == 0 || stringCaseCompare(toCheck->name, "CATEGORIES") == 0) {
-        if (toCheck->values->length <= 0) {
-            return INV_PROP;
-        }
-    }
-    else if (stringCaseCompare(toCheck->name, "GENDER") == 0 || stringCaseCompare(toCheck->name, "TEL") == 0) {
-        if (toCheck->values->length <= 0 || toCheck->values->length > 2) {
-            return INV_PROP;
-        }
-    }
-    else if (stringCaseCompare(toCheck->name, "CLIENTPIDMAP") == 0) {
-        if (toCheck->values->length != 2) {
-            return INV_PROP;
-        }
-    }
-    else {
-        if (toCheck->values->length != 1) {
-            return INV_PROP;
-        }
-    }
-
-    return OK;
-}
-
-bool listPropertyNameSearch(List* validPropertyList, char* propertyName) {
-    if (validPropertyList == NULL || propertyName == NULL) {
-        return false;
-    }
-
-    Node* current = validPropertyList->head;
-
-    while (current != NULL) {
-        if (stringCaseCompare(current->data, propertyName) == 0) {
-            return true;
-        }
-        current = current->next;
-    }
-    return false;
+    return checkValueCount(propertyKind(toCheck), toCheck->values->length);
 }
 
 char* substring(int startIndex, char* str) {
@@ -1149,45 +736,26 @@ char* getFileLog(char* fileName) {
         return NULL;
     }
 
-    Card* object = NULL;
-    VCardErrorCode err = createCard(fileName, &object);
-    char* errorCode = printError(err);
-    if (strcmp(errorCode, "OK") != 0) {
-        return NULL;
-    }
-
-    free(errorCode);
-
-    VCardErrorCode err2 = validateCard(object);
-    char* errorCode2 = printError(err2);
-    if (strcmp(errorCode2, "OK") != 0) {
+    //Only FN and the property count are shown, so the card is validated without being built
+    CardSummary summary;
+    if (createCardSummary(fileName, &summary) != OK) {
         return NULL;
     }
 
-    free(errorCode2);
-
-    //Get object->fn->name
-    char* FNName = calloc((int)(strlen(object->fn->values->head->data)) + 1, sizeof(char));
-    strcpy(FNName, object->fn->values->head->data);
-
-    //Get object->optionalProperties->length
-    int optPropLength = object->optionalProperties->length;
-
-    if (object->anniversary != NULL) {
-        optPropLength++;
-    }
-    if (object->birthday != NULL) {
-        optPropLength++;
-    }
-
     //Create JSON to return
     //{"indiname":"Simon Perreault","addiprops":"15"}
-    int FNNameLength = (int)(strlen(FNName)) + 1;
-    char* toReturn = calloc(100 + FNNameLength, sizeof(char));
-    sprintf(toReturn, "{\"indiname\":\"%s\",\"addiprops\":\"%d\"}", FNName, optPropLength);
+    StringBuilder json;
+    initializeStringBuilder(&json, strlen(summary.fn) + 40);
+    builderAppend(&json, "{\"indiname\":\"");
+    builderAppendEscaped(&json, summary.fn);
+    builderAppend(&json, "\",\"addiprops\":\"");
+    builderAppendInt(&json, summary.propertyCount);
+    builderAppend(&json, "\"}");
 
-    deleteCard(object);
+    free(summary.fn);
 
+    //NOTE: REMEMBER TO FREE toReturn IN CALLING FUNCTION
+    char* toReturn = builderFinish(&json);
     return toReturn;
 }
 
@@ -1199,74 +767,65 @@ char* getCardView(char* fileName) {
         return NULL;
     }
 
+    //The card is thrown away right after, so build it in an arena and free it in one go
+    //Invalid cards are rejected as soon as the first bad property is parsed
+    ParseOptions options = { .useArena = true, .validate = true };
     Card* object = NULL;
-    VCardErrorCode err = createCard(fileName, &object);
-    char* errorCode = printError(err);
-    if (strcmp(errorCode, "OK") != 0) {
-        return NULL;
-    }
-
-    free(errorCode);
-
-    VCardErrorCode err2 = validateCard(object);
-    char* errorCode2 = printError(err2);
-    if (strcmp(errorCode2, "OK") != 0) {
+    VCardErrorCode err = createCardWithOptions(fileName, &object, &options);
+    if (err != OK) {
         return NULL;
     }
 
-    free(errorCode2);
-
-    char buffer[9000];
-    //char* toReturn = calloc(50, sizeof(char));
-    strcpy(buffer, "[{\"propname\":\"FN\",\"propvalues\":\"");
+    //Grows with the card, so large PHOTO/NOTE/KEY values are copied once instead of overflowing a fixed buffer
+    StringBuilder buffer;
+    initializeStringBuilder(&buffer, 0);
+    builderAppend(&buffer, "[{\"propname\":\"FN\",\"propvalues\":\"");
 
     //Get object->fn->values
     if (object->fn->values > 0) {
-        Node* current = object->fn->values->head;
-        while (current) {
-            //Add current->data to buffer
-            strcat(buffer, current->data);
+        size_t valueCount = vectorLength(&object->fn->values->elements);
+        for (size_t i = 0; i < valueCount; i++) {
+            //Add the value to buffer
+            builderAppendEscaped(&buffer, vectorGet(&object->fn->values->elements, i));
 
-            if (current->next == NULL) {
-                strcat(buffer, "\"");
+            if (i + 1 == valueCount) {
+                builderAppend(&buffer, "\"");
             }
             else {
-                strcat(buffer, ", ");
+                builderAppend(&buffer, ", ");
             }
-
-            current = current->next;
         }
 
-        strcat(buffer, "}");
+        builderAppend(&buffer, "}");
     }
 
     //Get object->birthday if not NULL
     if (object->birthday != NULL) {
-        strcat(buffer, ",{\"propname\":\"BDAY\",");
+        builderAppend(&buffer, ",{\"propname\":\"BDAY\",");
 
         //Check if isText == true
         if (object->birthday->isText) {
-            strcat(buffer, "\"propvalues\":\"");
-            strcat(buffer, object->birthday->text);
-            strcat(buffer, "\"}");
+            builderAppend(&buffer, "\"propvalues\":\"");
+            builderAppendEscaped(&buffer, object->birthday->text);
+            builderAppend(&buffer, "\"}");
         }
         else {
             if (object->birthday->time[0] != '\0') {
-                strcat(buffer, "\"propvalues\":\"");
-                strcat(buffer, object->birthday->time);
+                builderAppend(&buffer, "\"propvalues\":\"");
+                builderAppendEscaped(&buffer, object->birthday->time);
                 if (object->birthday->date[0] != '\0') {
-                    strcat(buffer, object->birthday->date);
-                    strcat(buffer, "\"}");
+                    builderAppendEscaped(&buffer, object->birthday->date);
+                    builderAppend(&buffer, "\"}");
                 }
                 else {
-                    strcat(buffer, "\"}");
+                    builderAppend(&buffer, "\"}");
                 }
             }
             else {
                 if (object->birthday->date[0] != '\0') {
-                    strcat(buffer, "\"propvalues\":\"");
-                    strcat(buffer, object->birthday->date);
-                    strcat(buffer, "\"}");
+                    builderAppend(&buffer, "\"propvalues\":\"");
+                    builderAppendEscaped(&buffer, object->birthday->date);
+                    builderAppend(&buffer, "\"}");
                 }
             }
         }
@@ -1274,31 +833,31 @@ char* getCardView(char* fileName) {
 
     //Get object->anniversary if not NULL
     if (object->anniversary != NULL) {
-        strcat(buffer, ",{\"propname\":\"ANNIVERSARY\",");
+        builderAppend(&buffer, ",{\"propname\":\"ANNIVERSARY\",");
 
         //Check if isText == true
         if (object->anniversary->isText) {
-            strcat(buffer, "\"propvalues\":\"");
-            strcat(buffer, object->anniversary->text);
-            strcat(buffer, "\"}");
+            builderAppend(&buffer, "\"propvalues\":\"");
+            builderAppendEscaped(&buffer, object->anniversary->text);
+            builderAppend(&buffer, "\"}");
         }
         else {
             if (object->anniversary->time[0] != '\0') {
-                strcat(buffer, "\"propvalues\":\"");
-                strcat(buffer, object->anniversary->time);
+                builderAppend(&buffer, "\"propvalues\":\"");
+                builderAppendEscaped(&buffer, object->anniversary->time);
                 if (object->anniversary->date[0] != '\0') {
-                    strcat(buffer, object->anniversary->date);
-                    strcat(buffer, "\"}");
+                    builderAppendEscaped(&buffer, object->anniversary->date);
+                    builderAppend(&buffer, "\"}");
                 }
                 else {
-                    strcat(buffer, "\"}");
+                    builderAppend(&buffer, "\"}");
                 }
             }
             else {
                 if (object->anniversary->date[0] != '\0') {
-                    strcat(buffer, "\"propvalues\":\"");
-                    strcat(buffer, object->anniversary->date);
-                    strcat(buffer, "\"}");
+                    builderAppend(&buffer, "\"propvalues\":\"");
+                    builderAppendEscaped(&buffer, object->anniversary->date);
+                    builderAppend(&buffer, "\"}");
                 }
             }
         }
@@ -1306,51 +865,69 @@ char* getCardView(char* fileName) {
 
     //Get object->optionalProperties if not empty
     if (object->optionalProperties->length > 0) {
-        strcat(buffer, ",");
-        Node* current = object->optionalProperties->head;
-        while (current) {
-            Property* currentProperty = (Property*)(current->data);
+        builderAppend(&buffer, ",");
+        size_t propertyCount = vectorLength(&object->optionalProperties->elements);
+        for (size_t i = 0; i < propertyCount; i++) {
+            Property* currentProperty = (Property*)(vectorGet(&object->optionalProperties->elements, i));
             //Get current property name
-            strcat(buffer, "{\"propname\":\"");
-            strcat(buffer, currentProperty->name);
-            strcat(buffer, "\",");
+            builderAppend(&buffer, "{\"propname\":\"");
+            builderAppendEscaped(&buffer, currentProperty->name);
+            builderAppend(&buffer, "\",");
 
             //Get current property values
             if (currentProperty->values->length > 0) {
-                strcat(buffer, "\"propvalues\":\"");
-                Node* currentValue = currentProperty->values->head;
-                while (currentValue) {
-                    char* currentValueString = (char*)(currentValue->data);
+                builderAppend(&buffer, "\"propvalues\":\"");
+                VectorIterator valueIter = createVectorIterator(&currentProperty->values->elements);
+                char* currentValueString = NULL;
+                bool valueWritten = false;
+                while ((currentValueString = nextVectorElement(&valueIter)) != NULL) {
+                    //Empty values keep their position in the list, but are not shown
                     if (strcmp(currentValueString, "") != 0) {
-                        //Concatenate the value to buffer
-                        strcat(buffer, currentValueString);
-                        if (currentValue->next != NULL) {
-                            if (strcmp((char*)(currentValue->next->data), "") != 0) {
-                                strcat(buffer, ", ");
-                            }
+                        if (valueWritten) {
+                            builderAppend(&buffer, ", ");
                         }
+                        //Concatenate the value to buffer
+                        builderAppendEscaped(&buffer, currentValueString);
+                        valueWritten = true;
                     }
-                    currentValue = currentValue->next;
                 }
-                strcat(buffer, "\"");
+                builderAppend(&buffer, "\"");
             }
 
-            if (current->next == NULL) {
-                strcat(buffer, "}");
+            if (i + 1 == propertyCount) {
+                builderAppend(&buffer, "}");
             }
             else {
-                strcat(buffer, "},");
+                builderAppend(&buffer, "},");
             }
-
-            current = current->next;
         }
     }
 
-    strcat(buffer, "]");
+    builderAppend(&buffer, "]");
 
     deleteCard(object);
 
-    char* toReturn = calloc(strlen(buffer), sizeof(char));
-    strcpy(toReturn, buffer);
+    //NOTE: REMEMBER TO FREE toReturn IN CALLING FUNCTION
+    char* toReturn = builderFinish(&buffer);
+    return toReturn;
+}
+
+char* getFileDiagnostics(char* fileName) {
+    if (fileName == NULL) {
+        return NULL;
+    }
+
+    //Read the whole card, validating as it goes, so every problem is reported in one pass
+    Diagnostics diagnostics;
+    initializeDiagnostics(&diagnostics);
+    ParseOptions options = { .useArena = true, .validate = true, .collectErrors = true, .diagnostics = &diagnostics };
+    Card* object = NULL;
+    if (createCardWithOptions(fileName, &object, &options) == OK) {
+        deleteCard(object);
+    }
+
+    //NOTE: REMEMBER TO FREE toReturn IN CALLING FUNCTION
+    char* toReturn = diagnosticsToJSON(&diagnostics);
+    clearDiagnostics(&diagnostics);
     return toReturn;
 }
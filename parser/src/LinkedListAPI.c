@@ -1,6 +1,24 @@
 #include "LinkedListAPI.h"
+#include "VCardArena.h"
 #include "assert.h"
 
+/** Drops a list's node chain (See getListHead) - It no longer matches the list once the list changes
+*@param list the list to drop the chain of
+**/
+static void dropListNodes(List* list){
+	//Arena nodes are freed with their arena
+	if (list->arena == NULL){
+		Node* current = list->head;
+		while (current != NULL){
+			Node* next = current->next;
+			free(current);
+			current = next;
+		}
+	}
+	list->head = NULL;
+	list->tail = NULL;
+}
+
 /** Function to initialize the list metadata head to the appropriate function pointers. Allocates memory to the struct.
 *@return pointer to the list head
 *@param printFunction function pointer to print a single node of the list
@@ -15,6 +33,7 @@ List * initializeList(char* (*printFunction)(void* toBePrinted),void (*deleteFun
 
     List * tmpList = malloc(sizeof(List));
 	
+	initializeVector(&tmpList->elements, NULL);
 	tmpList->head = NULL;
 	tmpList->tail = NULL;
 
@@ -23,10 +42,40 @@ List * initializeList(char* (*printFunction)(void* toBePrinted),void (*deleteFun
 	tmpList->deleteData = deleteFunction;
 	tmpList->compare = compareFunction;
 	tmpList->printData = printFunction;
+	tmpList->arena = NULL;
 	
 	return tmpList;
 }
 
+/** Function to initialize a list that lives in an arena. The list and its elements array are freed with the arena.
+*@return pointer to the list head
+*@param arena the arena to allocate the list and its elements array from
+*@param printFunction function pointer to print a single node of the list
+*@param deleteFunction function pointer to delete a single piece of data from the list
+*@param compareFunction function pointer to compare two nodes of the list in order to test for equality or order
+**/
+List * initializeListInArena(Arena* arena, char* (*printFunction)(void* toBePrinted),void (*deleteFunction)(void* toBeDeleted),int (*compareFunction)(const void* first,const void* second)){
+    assert(arena != NULL);
+    assert(printFunction != NULL);
+    assert(deleteFunction != NULL);
+    assert(compareFunction != NULL);
+
+    List * tmpList = arenaAlloc(arena, sizeof(List));
+
+	initializeVector(&tmpList->elements, arena);
+	tmpList->head = NULL;
+	tmpList->tail = NULL;
+
+	tmpList->length = 0;
+
+	tmpList->deleteData = deleteFunction;
+	tmpList->compare = compareFunction;
+	tmpList->printData = printFunction;
+	tmpList->arena = arena;
+
+	return tmpList;
+}
+
 
 /** Deletes the entire linked list, freeing all memory.
 * uses the supplied function pointer to release allocated memory for the data
@@ -35,8 +84,17 @@ List * initializeList(char* (*printFunction)(void* toBePrinted),void (*deleteFun
 *@return  on success: NULL, on failure: head of list
 **/
 void freeList(List* list){	
+    if (list == NULL){
+        return;
+    }
+
     clearList(list);
-    free(list);
+
+    //Arena lists are freed with their arena
+    if (list->arena == NULL){
+        clearVectorStorage(&list->elements);
+        free(list);
+    }
 }
 
 /** Clears the contents linked list, freeing all memory associated with these contents.  The list itself is not freed.
@@ -50,21 +108,16 @@ void clearList(List* list) {
         return;
     }
 
-    if (list->head == NULL && list->tail == NULL){
-        return;
-    }
-
-    Node* tmp;
-
-    while (list->head != NULL){
-        list->deleteData(list->head->data);
-        tmp = list->head;
-        list->head = list->head->next;
-        free(tmp);
+    //Arena data is freed with its arena
+    if (list->arena == NULL){
+        for (size_t i = 0; i < list->elements.length; i++){
+            list->deleteData(list->elements.items[i]);
+        }
     }
+    dropListNodes(list);
 
-    list->head = NULL;
-    list->tail = NULL;
+    //The elements array is kept for reuse
+    list->elements.length = 0;
     list->length = 0;
 }
 
@@ -91,8 +144,8 @@ Node* initializeNode(void* data){
 	return tmpNode;
 }
 
-/**Inserts a Node at the front of a linked list.  List metadata is updated
-* so that head and tail pointers are correct.
+/**Inserts data at the back of a list.  List metadata is updated
+* so that the length is correct.
 *@pre 'List' type must exist and be used in order to keep track of the linked list.
 *@param list pointer to the dummy head of the list
 *@param toBeAdded a pointer to data that is to be added to the linked list
@@ -102,22 +155,13 @@ void insertBack(List* list, void* toBeAdded){
 		return;
 	}
 	
-	(list->length)++;
-
-	Node* newNode = initializeNode(toBeAdded);
-	
-    if (list->head == NULL && list->tail == NULL){
-        list->head = newNode;
-        list->tail = list->head;
-    }else{
-		newNode->previous = list->tail;
-        list->tail->next = newNode;
-    	list->tail = newNode;
-    }
+	vectorPushBack(&list->elements, toBeAdded);
+	dropListNodes(list);
+	list->length = (int)(list->elements.length);
 }
 
-/**Inserts a Node at the front of a linked list.  List metadata is updated
-* so that head and tail pointers are correct.
+/**Inserts data at the front of a list.  List metadata is updated
+* so that the length is correct.
 *@pre 'List' type must exist and be used in order to keep track of the linked list.
 *@param list pointer to the dummy head of the list
 *@param toBeAdded a pointer to data that is to be added to the linked list
@@ -127,18 +171,9 @@ void insertFront(List* list, void* toBeAdded){
 		return;
 	}
 	
-	(list->length)++;
-
-	Node* newNode = initializeNode(toBeAdded);
-	
-    if (list->head == NULL && list->tail == NULL){
-        list->head = newNode;
-        list->tail = list->head;
-    }else{
-		newNode->next = list->head;
-        list->head->previous = newNode;
-    	list->head = newNode;
-    }
+	vectorInsert(&list->elements, 0, toBeAdded);
+	dropListNodes(list);
+	list->length = (int)(list->elements.length);
 }
 
 /**Returns a pointer to the data at the front of the list. Does not alter list structure.
@@ -147,11 +182,11 @@ void insertFront(List* list, void* toBeAdded){
  *@return pointer to the data located at the head of the list
  **/
 void* getFromFront(List * list){
-	if (list->head == NULL){
+	if (list == NULL){
 		return NULL;
 	}
 	
-	return list->head->data;
+	return vectorGet(&list->elements, 0);
 }
 
 /**Returns a pointer to the data at the back of the list. Does not alter list structure.
@@ -160,20 +195,19 @@ void* getFromFront(List * list){
  *@return pointer to the data located at the tail of the list
  **/
 void* getFromBack(List * list){
-	if (list->tail == NULL){
+	if (list == NULL || list->elements.length == 0){
 		return NULL;
 	}
 	
-	return list->tail->data;
+	return vectorGet(&list->elements, list->elements.length - 1);
 }
 
 
-/** Removes data from from the list, deletes the node and frees the memory,
- * changes pointer values of surrounding nodes to maintain list structure.
+/** Removes data from from the list, closing the gap it leaves behind.
  * returns the data 
  * You can assume that the list contains no duplicates
  *@pre List must exist and have memory allocated to it
- *@post toBeDeleted will have its memory freed if it exists in the list.
+ *@post toBeDeleted has been removed from the list if it exists in the list.
  *@param list - a pointer to the List struct
  *@param toBeDeleted - a pointer to data that is to be removed from the list
  *@return on success: void * pointer to data  on failure: NULL
@@ -183,34 +217,12 @@ void* deleteDataFromList(List* list, void* toBeDeleted){
 		return NULL;
 	}
 	
-	Node* tmp = list->head;
-	
-	while(tmp != NULL){
-		if (list->compare(toBeDeleted, tmp->data) == 0){
-			//Unlink the node
-			Node* delNode = tmp;
-			
-			if (tmp->previous != NULL){
-				tmp->previous->next = delNode->next;
-			}else{
-				list->head = delNode->next;
-			}
-			
-			if (tmp->next != NULL){
-				tmp->next->previous = delNode->previous;
-			}else{
-				list->tail = delNode->previous;
-			}
-			
-			void* data = delNode->data;
-			free(delNode);
-			
-			(list->length)--;
-
+	for (size_t i = 0; i < list->elements.length; i++){
+		if (list->compare(toBeDeleted, list->elements.items[i]) == 0){
+			void* data = vectorRemove(&list->elements, i);
+			list->length = (int)(list->elements.length);
+			dropListNodes(list);
 			return data;
-			
-		}else{
-			tmp = tmp->next;
 		}
 	}
 	
@@ -222,7 +234,7 @@ void* deleteDataFromList(List* list, void* toBeDeleted){
 * appropriate position in the list.
 * should be used as the only insert function if a sorted list is required.  
 *@pre List exists and has memory allocated to it. Node to be added is valid.
-*@post The node to be added will be placed immediately before or after the first occurrence of a related node
+*@post The node to be added will be placed immediately before the first element it compares less than or equal to
 *@param list a pointer to the dummy head of the list containing function pointers for delete and compare, as well 
 as a pointer to the first and last element of the list.
 *@param toBeAdded a pointer to data that is to be added to the linked list
@@ -232,49 +244,14 @@ void insertSorted(List *list, void *toBeAdded){
 		return;
 	}
 	
-	(list->length)++;
-
-	if (list->head == NULL){
-		insertBack(list, toBeAdded);
-		return;
-	}
-	
-	if (list->compare(toBeAdded, list->head->data) <= 0){
-		insertFront(list, toBeAdded);
-		return;
-	}
-	
-	if (list->compare(toBeAdded, list->tail->data) > 0){
-		insertBack(list, toBeAdded);
-		return;
+	size_t index = 0;
+	while (index < list->elements.length && list->compare(toBeAdded, list->elements.items[index]) > 0){
+		index++;
 	}
 	
-	Node* currNode = list->head;
-	
-	while (currNode != NULL){
-		if (list->compare(toBeAdded, currNode->data) <= 0){
-		
-			char* currDescr = list->printData(currNode->data);
-			char* newDescr = list->printData(toBeAdded);
-
-			//printf("Inserting %s before %s\n", newDescr, currDescr);
-
-			free(currDescr);
-			free(newDescr);
-		
-			Node* newNode = initializeNode(toBeAdded);
-			newNode->next = currNode;
-			newNode->previous = currNode->previous;
-			currNode->previous->next = newNode;
-			currNode->previous = newNode;
-		
-			return;
-		}
-	
-		currNode = currNode->next;
-	}
-	
-	return;
+	vectorInsert(&list->elements, index, toBeAdded);
+	dropListNodes(list);
+	list->length = (int)(list->elements.length);
 }
 
 /**Returns a string that contains a string representation of the list traversed from  head to tail. 
@@ -305,17 +282,47 @@ char* toString(List * list){
 	return str;
 }
 
-/** Function for creating an iterator for the linked list.
- * This node contains abstracted (void *) data as well as previous and next
- * pointers to connect to other nodes in the list
+/** Function for getting a list's elements as a chain of nodes, for code written against head/tail.
+* The chain is only built the first time it is asked for after the list changes
+*@pre List exists and is valid
+*@post list->head and list->tail hold the chain (From the list's arena, if it has one)
+*@return The first node, NULL if the list is empty
+*@param list - pointer to the List struct
+**/
+Node* getListHead(List* list){
+	if (list == NULL){
+		return NULL;
+	}
+	if (list->head != NULL || list->elements.length == 0){
+		return list->head;
+	}
+
+	for (size_t i = 0; i < list->elements.length; i++){
+		Node* node = list->arena != NULL ? arenaAlloc(list->arena, sizeof(Node)) : initializeNode(NULL);
+		node->data = list->elements.items[i];
+		node->previous = list->tail;
+		node->next = NULL;
+		if (list->tail != NULL){
+			list->tail->next = node;
+		}
+		else {
+			list->head = node;
+		}
+		list->tail = node;
+	}
+
+	return list->head;
+}
+
+/** Function for creating an iterator for the list.
  *@pre List exists and is valid
- *@post List remains unchanged.  The iterator has been allocated and points to the head of the list.
+ *@post List remains unchanged.  The iterator points to the head of the list.
  *@return The newly created iterator object.
  *@param list - pointer to the List struct to iterate over.
 **/
 ListIterator createIterator(List* list) {
     ListIterator iter;
-    iter.current = list->head;
+    iter.position = createVectorIterator(&list->elements);
 
     return iter;
 }
@@ -330,15 +337,7 @@ ListIterator createIterator(List* list) {
 *@param iter - an iterator for a List struct.
 **/
 void* nextElement(ListIterator* iter) {
-    Node* tmp = iter->current;
-
-    if (tmp != NULL){
-        iter->current = iter->current->next;
-        return tmp->data;
-    }
-    else {
-        return NULL;
-    }
+    return nextVectorElement(&iter->position);
 }
 
 /**Returns the number of elements in the list.
@@ -347,6 +346,10 @@ void* nextElement(ListIterator* iter) {
  *@return on success: number of eleemnts in the list (0 or more).  on failure: -1 (e.g. list not initlized correctly)
  **/
 int getLength(List* list){
+	if (list == NULL){
+		return -1;
+	}
+
 	return list->length;
 }
 
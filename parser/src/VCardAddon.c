@@ -0,0 +1,337 @@
+/**
+ * @file VCardAddon.c
+ * @brief This file contains the VCard parser's Node.js addon (Built by binding.gyp), used by app.js to call the parser.
+ * @author ADD LATER
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <node_api.h>
+#include "VCardParser.h"
+#include "HelperFunctions.h"
+#include "VCardBatch.h"
+#define DEBUG false
+
+/**
+ * Parser function a job runs
+ */
+typedef enum addonCall {
+    CALL_FILE_LOG, CALL_FILE_LOGS, CALL_CARD_VIEW, CALL_FILE_DIAGNOSTICS, CALL_PARSE_DIRECTORY
+} AddonCall;
+
+/**
+ * One call from JavaScript. The parsing runs on the libuv threadpool, the JavaScript values are only touched
+ * on the main thread before and after
+ */
+typedef struct addonJob {
+    AddonCall call;
+
+    //Files (Or the directory) to parse, copied out of the JavaScript strings
+    char** paths;
+    size_t pathCount;
+
+    //Threads parseDirectory may use
+    int threads;
+
+    //JSON text for each path (NULL where the parser returned NULL). Handed over to the Buffers resolved to JavaScript
+    char** results;
+
+    napi_deferred deferred;
+    napi_async_work work;
+} AddonJob;
+
+/**
+ * copyString: Copies a JavaScript string into a new C string
+ * @param env: napi_env of the call
+ * @param value: napi_value to copy
+ * @return char*: New NUL terminated UTF-8 string, NULL if value is not a string
+ */
+static char* copyString(napi_env env, napi_value value) {
+    size_t length = 0;
+    if (napi_get_value_string_utf8(env, value, NULL, 0, &length) != napi_ok) {
+        return NULL;
+    }
+
+    //NOTE: REMEMBER TO FREE toReturn IN CALLING FUNCTION
+    char* toReturn = malloc(length + 1);
+    napi_get_value_string_utf8(env, value, toReturn, length + 1, &length);
+    return toReturn;
+}
+
+/**
+ * createJob: Allocates a job for a number of paths
+ * @param call: AddonCall the job runs
+ * @param pathCount: size_t Number of paths (Filled in by the caller)
+ * @return AddonJob*: New job
+ */
+static AddonJob* createJob(AddonCall call, size_t pathCount) {
+    //NOTE: REMEMBER TO FREE job (deleteJob)
+    AddonJob* job = malloc(sizeof(AddonJob));
+    job->call = call;
+    job->pathCount = pathCount;
+    job->paths = calloc(pathCount > 0 ? pathCount : 1, sizeof(char*));
+    job->results = calloc(pathCount > 0 ? pathCount : 1, sizeof(char*));
+    job->threads = 0;
+    job->deferred = NULL;
+    job->work = NULL;
+    return job;
+}
+
+/**
+ * deleteJob: Frees a job, along with any results that were not handed over to JavaScript
+ * @param job: AddonJob* to free
+ */
+static void deleteJob(AddonJob* job) {
+    for (size_t i = 0; i < job->pathCount; i++) {
+        free(job->paths[i]);
+        free(job->results[i]);
+    }
+    free(job->paths);
+    free(job->results);
+    free(job);
+}
+
+/**
+ * executeJob: Runs the parser for every path of a job (napi_async_execute_callback, runs on a threadpool thread)
+ * @param env: napi_env - Must not be used here
+ * @param data: void* The AddonJob
+ */
+static void executeJob(napi_env env, void* data) {
+    AddonJob* job = data;
+
+    for (size_t i = 0; i < job->pathCount; i++) {
+        switch (job->call) {
+            case CALL_FILE_LOG:
+            case CALL_FILE_LOGS:
+                job->results[i] = getFileLog(job->paths[i]);
+                break;
+            case CALL_CARD_VIEW:
+                job->results[i] = getCardView(job->paths[i]);
+                break;
+            case CALL_FILE_DIAGNOSTICS:
+                job->results[i] = getFileDiagnostics(job->paths[i]);
+                break;
+            case CALL_PARSE_DIRECTORY:
+                job->results[i] = parseDirectory(job->paths[i], job->threads);
+                break;
+        }
+    }
+}
+
+/**
+ * freeResult: Frees a result once its Buffer is garbage collected (napi_finalize)
+ * @param env: napi_env of the Buffer
+ * @param data: void* The result
+ * @param hint: void* Unused
+ */
+static void freeResult(napi_env env, void* data, void* hint) {
+    free(data);
+}
+
+/**
+ * createResultValue: Turns a parser result into a Buffer without copying it - The Buffer frees the result
+ * @param env: napi_env of the call
+ * @param result: char* JSON text returned by the parser. Owned by the Buffer from here on (May be NULL)
+ * @return napi_value: A Buffer holding the JSON text, or null if result is NULL
+ */
+static napi_value createResultValue(napi_env env, char* result) {
+    napi_value value;
+
+    if (result == NULL) {
+        napi_get_null(env, &value);
+        return value;
+    }
+
+    size_t length = strlen(result);
+    if (napi_create_external_buffer(env, length, result, freeResult, NULL, &value) != napi_ok) {
+        //Some runtimes do not allow Buffers over outside memory - Copy it instead
+        napi_create_buffer_copy(env, length, result, NULL, &value);
+        free(result);
+    }
+    return value;
+}
+
+/**
+ * completeJob: Settles a job's Promise with its results (napi_async_complete_callback, runs on the main thread)
+ * getFileLogs resolves to an array with one entry per file, every other call resolves to a single entry
+ * @param env: napi_env of the call
+ * @param status: napi_status napi_cancelled if the job never ran
+ * @param data: void* The AddonJob
+ */
+static void completeJob(napi_env env, napi_status status, void* data) {
+    AddonJob* job = data;
+    napi_value result;
+
+    if (status != napi_ok) {
+        napi_value message;
+        napi_create_string_utf8(env, "The parser job was cancelled", NAPI_AUTO_LENGTH, &message);
+        napi_create_error(env, NULL, message, &result);
+        napi_reject_deferred(env, job->deferred, result);
+    }
+    else {
+        if (job->call == CALL_FILE_LOGS) {
+            napi_create_array_with_length(env, job->pathCount, &result);
+            for (size_t i = 0; i < job->pathCount; i++) {
+                napi_set_element(env, result, (uint32_t)(i), createResultValue(env, job->results[i]));
+                job->results[i] = NULL;
+            }
+        }
+        else {
+            result = createResultValue(env, job->results[0]);
+            job->results[0] = NULL;
+        }
+        napi_resolve_deferred(env, job->deferred, result);
+    }
+
+    if(DEBUG)printf("completeJob: %zu paths\n", job->pathCount);
+
+    napi_delete_async_work(env, job->work);
+    deleteJob(job);
+}
+
+/**
+ * queueJob: Queues a job on the libuv threadpool
+ * @param env: napi_env of the call
+ * @param job: AddonJob* to queue. Freed once it completes
+ * @return napi_value: Promise settled by completeJob
+ */
+static napi_value queueJob(napi_env env, AddonJob* job) {
+    napi_value promise;
+    napi_value name;
+
+    napi_create_promise(env, &job->deferred, &promise);
+    napi_create_string_utf8(env, "vcardparser", NAPI_AUTO_LENGTH, &name);
+    napi_create_async_work(env, NULL, name, executeJob, completeJob, job, &job->work);
+    napi_queue_async_work(env, job->work);
+    return promise;
+}
+
+/**
+ * queueFileJob: Queues a job for the file name passed as the first argument
+ * @param env: napi_env of the call
+ * @param info: napi_callback_info of the call
+ * @param call: AddonCall to run
+ * @return napi_value: Promise of the result, NULL (With a TypeError thrown) if the argument is not a string
+ */
+static napi_value queueFileJob(napi_env env, napi_callback_info info, AddonCall call) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, NULL, NULL);
+
+    char* path = argc >= 1 ? copyString(env, argv[0]) : NULL;
+    if (path == NULL) {
+        napi_throw_type_error(env, NULL, "Expected a file name");
+        return NULL;
+    }
+
+    AddonJob* job = createJob(call, 1);
+    job->paths[0] = path;
+    return queueJob(env, job);
+}
+
+/**
+ * getFileLogAsync: getFileLog(fileName) - Promise of the file log as a JSON Buffer, null if the card is invalid
+ */
+static napi_value getFileLogAsync(napi_env env, napi_callback_info info) {
+    return queueFileJob(env, info, CALL_FILE_LOG);
+}
+
+/**
+ * getCardViewAsync: getCardView(fileName) - Promise of the card view as a JSON Buffer, null if the card is invalid
+ */
+static napi_value getCardViewAsync(napi_env env, napi_callback_info info) {
+    return queueFileJob(env, info, CALL_CARD_VIEW);
+}
+
+/**
+ * getFileDiagnosticsAsync: getFileDiagnostics(fileName) - Promise of the file's diagnostics as a JSON Buffer
+ */
+static napi_value getFileDiagnosticsAsync(napi_env env, napi_callback_info info) {
+    return queueFileJob(env, info, CALL_FILE_DIAGNOSTICS);
+}
+
+/**
+ * getFileLogsAsync: getFileLogs([fileName, ...]) - Promise of an array with the file log of each file (See getFileLog),
+ * all parsed by one job
+ */
+static napi_value getFileLogsAsync(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, NULL, NULL);
+
+    bool isArray = false;
+    if (argc >= 1) {
+        napi_is_array(env, argv[0], &isArray);
+    }
+    if (isArray == false) {
+        napi_throw_type_error(env, NULL, "Expected an array of file names");
+        return NULL;
+    }
+
+    uint32_t fileCount = 0;
+    napi_get_array_length(env, argv[0], &fileCount);
+
+    AddonJob* job = createJob(CALL_FILE_LOGS, fileCount);
+    for (uint32_t i = 0; i < fileCount; i++) {
+        napi_value element;
+        napi_get_element(env, argv[0], i, &element);
+        job->paths[i] = copyString(env, element);
+        if (job->paths[i] == NULL) {
+            deleteJob(job);
+            napi_throw_type_error(env, NULL, "Expected an array of file names");
+            return NULL;
+        }
+    }
+
+    return queueJob(env, job);
+}
+
+/**
+ * parseDirectoryAsync: parseDirectory(path, threads) - Promise of the directory's file logs as a JSON Buffer,
+ * null if the directory can not be opened (See parseDirectory)
+ */
+static napi_value parseDirectoryAsync(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value argv[2];
+    napi_get_cb_info(env, info, &argc, argv, NULL, NULL);
+
+    char* path = argc >= 1 ? copyString(env, argv[0]) : NULL;
+    if (path == NULL) {
+        napi_throw_type_error(env, NULL, "Expected a directory name");
+        return NULL;
+    }
+
+    AddonJob* job = createJob(CALL_PARSE_DIRECTORY, 1);
+    job->paths[0] = path;
+
+    //Threads are optional - 0 uses one per CPU
+    int32_t threads = 0;
+    if (argc >= 2 && napi_get_value_int32(env, argv[1], &threads) == napi_ok) {
+        job->threads = threads;
+    }
+
+    return queueJob(env, job);
+}
+
+/**
+ * initializeAddon: Exports the addon's functions
+ * @param env: napi_env of the module
+ * @param exports: napi_value exports object
+ * @return napi_value: The exports object
+ */
+static napi_value initializeAddon(napi_env env, napi_value exports) {
+    napi_property_descriptor functions[] = {
+        { "getFileLog", NULL, getFileLogAsync, NULL, NULL, NULL, napi_enumerable, NULL },
+        { "getFileLogs", NULL, getFileLogsAsync, NULL, NULL, NULL, napi_enumerable, NULL },
+        { "getCardView", NULL, getCardViewAsync, NULL, NULL, NULL, napi_enumerable, NULL },
+        { "getFileDiagnostics", NULL, getFileDiagnosticsAsync, NULL, NULL, NULL, napi_enumerable, NULL },
+        { "parseDirectory", NULL, parseDirectoryAsync, NULL, NULL, NULL, napi_enumerable, NULL }
+    };
+
+    napi_define_properties(env, exports, sizeof(functions) / sizeof(functions[0]), functions);
+    return exports;
+}
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, initializeAddon)
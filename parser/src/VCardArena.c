@@ -0,0 +1,126 @@
+/**
+ * @file VCardArena.c
+ * @brief This file contains the VCard file's bump allocator.
+ * @author ADD LATER
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "VCardArena.h"
+#define DEBUG false
+
+//Big enough for a typical card, its properties and their values
+#define ARENA_DEFAULT_BLOCK_SIZE 8192
+
+/**
+ * alignSize: Rounds a size up so the next allocation stays aligned for any type
+ * @param size: size_t Size to round up
+ * @return size_t: The rounded size
+ */
+static size_t alignSize(size_t size) {
+    size_t alignment = sizeof(max_align_t);
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * createBlock: ArenaBlock* constructor
+ * @param capacity: size_t Number of bytes the block can hold
+ * @return ArenaBlock*: An empty block
+ */
+static ArenaBlock* createBlock(size_t capacity) {
+    ArenaBlock* newBlock = malloc(sizeof(ArenaBlock) + capacity);
+    newBlock->next = NULL;
+    newBlock->used = 0;
+    newBlock->capacity = capacity;
+    return newBlock;
+}
+
+Arena* createArena(size_t blockSize) {
+    if (blockSize == 0) {
+        blockSize = ARENA_DEFAULT_BLOCK_SIZE;
+    }
+
+    //The arena lives at the start of its own first block, so creating it is a single malloc
+    ArenaBlock* firstBlock = createBlock(alignSize(sizeof(Arena)) + alignSize(blockSize));
+    Arena* newArena = (Arena*)(firstBlock->data);
+    firstBlock->used = alignSize(sizeof(Arena));
+
+    newArena->blocks = firstBlock;
+    newArena->cleanups = NULL;
+    newArena->blockSize = alignSize(blockSize);
+
+    return newArena;
+}
+
+void* arenaAlloc(Arena* arena, size_t size) {
+    size = alignSize(size == 0 ? 1 : size);
+
+    ArenaBlock* current = arena->blocks;
+    if (current->capacity - current->used < size) {
+        if (size > arena->blockSize / 2) {
+            //Large allocations get their own block behind the current one, so the current block keeps its free space
+            ArenaBlock* largeBlock = createBlock(size);
+            largeBlock->used = size;
+            largeBlock->next = current->next;
+            current->next = largeBlock;
+            if(DEBUG)printf("arenaAlloc: dedicated block of %zu bytes\n", size);
+            return largeBlock->data;
+        }
+
+        ArenaBlock* newBlock = createBlock(arena->blockSize);
+        newBlock->next = current;
+        arena->blocks = newBlock;
+        current = newBlock;
+    }
+
+    void* toReturn = (char*)(current->data) + current->used;
+    current->used += size;
+    return toReturn;
+}
+
+void* arenaCalloc(Arena* arena, size_t size) {
+    void* toReturn = arenaAlloc(arena, size);
+    memset(toReturn, 0, size);
+    return toReturn;
+}
+
+char* arenaStringCopy(Arena* arena, const char* string, size_t length) {
+    char* toReturn = arenaAlloc(arena, length + 1);
+    memcpy(toReturn, string, length);
+    toReturn[length] = '\0';
+    return toReturn;
+}
+
+void arenaAddCleanup(Arena* arena, void (*cleanup)(void* data), void* data) {
+    ArenaCleanup* newCleanup = arenaAlloc(arena, sizeof(ArenaCleanup));
+    newCleanup->cleanup = cleanup;
+    newCleanup->data = data;
+    newCleanup->next = arena->cleanups;
+    arena->cleanups = newCleanup;
+}
+
+void releaseArena(Arena* arena) {
+    if (arena == NULL) {
+        return;
+    }
+
+    //Cleanups live in the arena too, so they have to run before any block is freed
+    for (ArenaCleanup* current = arena->cleanups; current != NULL; current = current->next) {
+        current->cleanup(current->data);
+    }
+
+    //The first block holds the arena itself, so it is freed last
+    ArenaBlock* current = arena->blocks;
+    ArenaBlock* firstBlock = (ArenaBlock*)((char*)(arena) - offsetof(ArenaBlock, data));
+    while (current != NULL) {
+        ArenaBlock* next = current->next;
+        if (current != firstBlock) {
+            free(current);
+        }
+        current = next;
+    }
+    free(firstBlock);
+}
@@ -0,0 +1,296 @@
+/**
+ * @file VCardBatch.c
+ * @brief This file contains the VCard file's batch parsing functionality.
+ * @author ADD LATER
+ */
+
+//Needed for pthreads, dirent and sysconf(_SC_NPROCESSORS_ONLN) under -std=c11
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <unistd.h>
+#include "VCardParser.h"
+#include "HelperFunctions.h"
+#include "VCardBatch.h"
+#include "VCardStringBuilder.h"
+#define DEBUG false
+
+/**
+ * Block of file indices [begin, end) waiting to be parsed by one worker
+ */
+typedef struct workQueue {
+    pthread_mutex_t lock;
+    size_t begin;
+    size_t end;
+} WorkQueue;
+
+/**
+ * State shared by all workers of one parseDirectory call
+ */
+typedef struct workPool {
+    //Full paths of the files, and the JSON entry built for each of them
+    char** paths;
+    char** fileNames;
+    char** results;
+
+    WorkQueue* queues;
+    int workerCount;
+} WorkPool;
+
+/**
+ * Arguments of a single worker thread
+ */
+typedef struct worker {
+    WorkPool* pool;
+    int index;
+} Worker;
+
+/**
+ * popOwnWork: Takes the last file of a worker's own block
+ * @param queue: WorkQueue* of the worker
+ * @param fileIndex: size_t* to store the file index into
+ * @return bool: true if a file was taken, false if the block is empty
+ */
+static bool popOwnWork(WorkQueue* queue, size_t* fileIndex) {
+    bool found = false;
+
+    pthread_mutex_lock(&queue->lock);
+    if (queue->begin < queue->end) {
+        queue->end--;
+        *fileIndex = queue->end;
+        found = true;
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return found;
+}
+
+/**
+ * stealWork: Moves the front half of another worker's block into an empty block
+ * @param pool: WorkPool* holding all blocks
+ * @param thief: int Index of the worker that ran out of files
+ * @return bool: true if files were stolen, false once every block is empty
+ */
+static bool stealWork(WorkPool* pool, int thief) {
+    for (int i = 1; i < pool->workerCount; i++) {
+        WorkQueue* victim = &pool->queues[(thief + i) % pool->workerCount];
+        size_t begin = 0;
+        size_t end = 0;
+
+        //The owner works from the back of its block, so steal from the front
+        pthread_mutex_lock(&victim->lock);
+        size_t remaining = victim->end - victim->begin;
+        if (remaining > 0) {
+            size_t toSteal = (remaining + 1) / 2;
+            begin = victim->begin;
+            end = victim->begin + toSteal;
+            victim->begin = end;
+        }
+        pthread_mutex_unlock(&victim->lock);
+
+        if (begin < end) {
+            WorkQueue* own = &pool->queues[thief];
+            pthread_mutex_lock(&own->lock);
+            own->begin = begin;
+            own->end = end;
+            pthread_mutex_unlock(&own->lock);
+            if(DEBUG)printf("stealWork: worker %d stole %zu files\n", thief, end - begin);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * createFileEntry: Creates the JSON entry of one file
+ * @param fileName: char* Name of the file (Without the directory)
+ * @param fileLog: char* getFileLog result for the file, NULL if the file is not a valid card
+ * @param diagnostics: char* getFileDiagnostics result for the file, only used if fileLog is NULL
+ * @return char*: A dynamically created JSON object
+ */
+static char* createFileEntry(char* fileName, char* fileLog, char* diagnostics) {
+    StringBuilder entry;
+    initializeStringBuilder(&entry, strlen(fileName) + (fileLog != NULL ? strlen(fileLog) : 0) + 32);
+    builderAppend(&entry, "{\"file\":\"");
+
+    //Escape the file name - It comes straight from the directory
+    builderAppendEscaped(&entry, fileName);
+
+    if (fileLog == NULL) {
+        //Say why the file was rejected
+        builderAppend(&entry, "\",\"valid\":false,\"errors\":");
+        builderAppend(&entry, diagnostics != NULL ? diagnostics : "[]");
+        builderAppendChar(&entry, '}');
+    }
+    else {
+        //Splice the file log's members in after the file name (Skipping its opening '{')
+        builderAppend(&entry, "\",\"valid\":true,");
+        builderAppend(&entry, fileLog + 1);
+    }
+
+    //NOTE: REMEMBER TO FREE toReturn IN CALLING FUNCTION
+    char* toReturn = builderFinish(&entry);
+    return toReturn;
+}
+
+/**
+ * runWorker: Worker thread - Parses its own block, then steals from the others until every block is empty
+ * @param argument: void* Worker* of the thread
+ * @return void*: NULL
+ */
+static void* runWorker(void* argument) {
+    Worker* worker = argument;
+    WorkPool* pool = worker->pool;
+    size_t fileIndex = 0;
+
+    while (true) {
+        while (popOwnWork(&pool->queues[worker->index], &fileIndex)) {
+            char* fileLog = getFileLog(pool->paths[fileIndex]);
+
+            //Invalid files are read a second time, collecting every error instead of stopping at the first
+            char* diagnostics = fileLog == NULL ? getFileDiagnostics(pool->paths[fileIndex]) : NULL;
+
+            pool->results[fileIndex] = createFileEntry(pool->fileNames[fileIndex], fileLog, diagnostics);
+            free(fileLog);
+            free(diagnostics);
+        }
+
+        if (stealWork(pool, worker->index) == false) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * compareFileNames: qsort comparator for file names
+ */
+static int compareFileNames(const void* first, const void* second) {
+    return strcmp(*(char* const*)(first), *(char* const*)(second));
+}
+
+char* parseDirectory(char* path, int nthreads) {
+    if (path == NULL) {
+        return NULL;
+    }
+
+    DIR* directory = opendir(path);
+    if (directory == NULL) {
+        return NULL;
+    }
+
+    //Collect the file names
+    size_t fileCount = 0;
+    size_t capacity = 64;
+    char** fileNames = malloc(capacity * sizeof(char*));
+    struct dirent* entry = NULL;
+    while ((entry = readdir(directory)) != NULL) {
+        //Skips ".", ".." and hidden files - Including the temporary files of cards still being written (See writeCards)
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        if (fileCount == capacity) {
+            capacity *= 2;
+            fileNames = realloc(fileNames, capacity * sizeof(char*));
+        }
+        fileNames[fileCount] = malloc(strlen(entry->d_name) + 1);
+        strcpy(fileNames[fileCount], entry->d_name);
+        fileCount++;
+    }
+    closedir(directory);
+
+    qsort(fileNames, fileCount, sizeof(char*), compareFileNames);
+
+    //Build the full path of every file
+    size_t pathLength = strlen(path);
+    char** paths = malloc((fileCount > 0 ? fileCount : 1) * sizeof(char*));
+    for (size_t i = 0; i < fileCount; i++) {
+        paths[i] = malloc(pathLength + strlen(fileNames[i]) + 2);
+        sprintf(paths[i], "%s/%s", path, fileNames[i]);
+    }
+
+    //One worker per online CPU by default, never more workers than files
+    if (nthreads <= 0) {
+        long onlineCPUs = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = onlineCPUs > 0 ? (int)(onlineCPUs) : 1;
+    }
+    if ((size_t)(nthreads) > fileCount) {
+        nthreads = fileCount > 0 ? (int)(fileCount) : 1;
+    }
+
+    WorkPool pool;
+    pool.paths = paths;
+    pool.fileNames = fileNames;
+    pool.results = calloc(fileCount > 0 ? fileCount : 1, sizeof(char*));
+    pool.workerCount = nthreads;
+    pool.queues = malloc(nthreads * sizeof(WorkQueue));
+
+    //Start every worker with an even share of the files
+    for (int i = 0; i < nthreads; i++) {
+        pthread_mutex_init(&pool.queues[i].lock, NULL);
+        pool.queues[i].begin = fileCount * i / nthreads;
+        pool.queues[i].end = fileCount * (i + 1) / nthreads;
+    }
+
+    Worker* workers = malloc(nthreads * sizeof(Worker));
+    pthread_t* threads = malloc(nthreads * sizeof(pthread_t));
+    bool* started = calloc(nthreads, sizeof(bool));
+    for (int i = 1; i < nthreads; i++) {
+        workers[i].pool = &pool;
+        workers[i].index = i;
+        started[i] = pthread_create(&threads[i], NULL, runWorker, &workers[i]) == 0;
+        if(DEBUG && started[i] == false)printf("parseDirectory: worker %d could not be started\n", i);
+    }
+
+    //The calling thread is worker 0
+    workers[0].pool = &pool;
+    workers[0].index = 0;
+    runWorker(&workers[0]);
+
+    for (int i = 1; i < nthreads; i++) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        }
+        else {
+            //The thread could not be created (Thread limit reached) - Its block is parsed on the calling thread
+            runWorker(&workers[i]);
+        }
+    }
+
+    //Join the entries in file name order
+    StringBuilder json;
+    initializeStringBuilder(&json, 0);
+    builderAppendChar(&json, '[');
+    for (size_t i = 0; i < fileCount; i++) {
+        if (i > 0) {
+            builderAppendChar(&json, ',');
+        }
+        builderAppend(&json, pool.results[i]);
+
+        free(pool.results[i]);
+        free(paths[i]);
+        free(fileNames[i]);
+    }
+    builderAppendChar(&json, ']');
+
+    for (int i = 0; i < nthreads; i++) {
+        pthread_mutex_destroy(&pool.queues[i].lock);
+    }
+    free(pool.queues);
+    free(pool.results);
+    free(workers);
+    free(threads);
+    free(started);
+    free(paths);
+    free(fileNames);
+
+    //NOTE: REMEMBER TO FREE toReturn IN CALLING FUNCTION
+    char* toReturn = builderFinish(&json);
+    return toReturn;
+}
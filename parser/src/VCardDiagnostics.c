@@ -0,0 +1,96 @@
+/**
+ * @file VCardDiagnostics.c
+ * @brief This file contains the VCard file's parse diagnostics, used to explain why a card was rejected.
+ * @author ADD LATER
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "VCardParser.h"
+#include "VCardTokenizer.h"
+#include "VCardDiagnostics.h"
+#include "VCardStringBuilder.h"
+
+void initializeDiagnostics(Diagnostics* diagnostics) {
+    diagnostics->entries = NULL;
+    diagnostics->count = 0;
+    diagnostics->capacity = 0;
+}
+
+void clearDiagnostics(Diagnostics* diagnostics) {
+    for (size_t i = 0; i < diagnostics->count; i++) {
+        free(diagnostics->entries[i].propertyName);
+    }
+    free(diagnostics->entries);
+    initializeDiagnostics(diagnostics);
+}
+
+void addDiagnostic(Diagnostics* diagnostics, VCardErrorCode error, const ContentLine* line, const char* reason) {
+    if (diagnostics->count == diagnostics->capacity) {
+        diagnostics->capacity = diagnostics->capacity == 0 ? 4 : diagnostics->capacity * 2;
+        diagnostics->entries = realloc(diagnostics->entries, diagnostics->capacity * sizeof(Diagnostic));
+    }
+
+    Diagnostic* diagnostic = &diagnostics->entries[diagnostics->count];
+    diagnostic->error = error;
+    diagnostic->lineNumber = 0;
+    diagnostic->byteOffset = 0;
+    diagnostic->propertyName = NULL;
+    diagnostic->reason = reason;
+
+    if (line != NULL) {
+        diagnostic->lineNumber = line->lineNumber;
+        diagnostic->byteOffset = line->byteOffset;
+        if (line->name.start != NULL) {
+            //NOTE: REMEMBER TO FREE propertyName (clearDiagnostics)
+            diagnostic->propertyName = viewToString(line->name);
+        }
+    }
+
+    diagnostics->count++;
+}
+
+char* diagnosticsToJSON(const Diagnostics* diagnostics) {
+    StringBuilder json;
+    initializeStringBuilder(&json, 0);
+    builderAppendChar(&json, '[');
+
+    for (size_t i = 0; i < diagnostics->count; i++) {
+        const Diagnostic* diagnostic = &diagnostics->entries[i];
+        if (i > 0) {
+            builderAppendChar(&json, ',');
+        }
+
+        char* error = printError(diagnostic->error);
+        builderAppend(&json, "{\"error\":\"");
+        builderAppend(&json, error);
+        free(error);
+
+        builderAppend(&json, "\",\"line\":");
+        builderAppendInt(&json, diagnostic->lineNumber);
+        builderAppend(&json, ",\"offset\":");
+        builderAppendInt(&json, (long)(diagnostic->byteOffset));
+
+        builderAppend(&json, ",\"property\":");
+        if (diagnostic->propertyName != NULL) {
+            builderAppendChar(&json, '"');
+            builderAppendEscaped(&json, diagnostic->propertyName);
+            builderAppendChar(&json, '"');
+        }
+        else {
+            builderAppend(&json, "null");
+        }
+
+        builderAppend(&json, ",\"reason\":\"");
+        builderAppendEscaped(&json, diagnostic->reason);
+        builderAppend(&json, "\"}");
+    }
+
+    builderAppendChar(&json, ']');
+
+    //NOTE: REMEMBER TO FREE toReturn IN CALLING FUNCTION
+    char* toReturn = builderFinish(&json);
+    return toReturn;
+}
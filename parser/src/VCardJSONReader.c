@@ -0,0 +1,454 @@
+/**
+ * @file VCardJSONReader.c
+ * @brief This file contains the VCard file's single pass JSON reader, used to import JSON.
+ * @author ADD LATER
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "VCardJSONReader.h"
+#include "VCardStringBuilder.h"
+
+//Cards nest a few levels deep - Anything deeper is rejected before it can exhaust the stack
+#define JSON_MAX_DEPTH 64
+
+/**
+ * Position of the reader in the document
+ */
+typedef struct jsonReader {
+    const char* current;
+    const char* end;
+    const JSONHandler* handler;
+    int depth;
+
+    //Unescaped copy of the current string, only used when the string has escapes
+    StringBuilder scratch;
+} JSONReader;
+
+static bool readValue(JSONReader* reader);
+
+/**
+ * skipWhitespace: Moves the reader past any JSON whitespace
+ * @param reader: JSONReader* to move
+ */
+static void skipWhitespace(JSONReader* reader) {
+    while (reader->current < reader->end && (*reader->current == ' ' || *reader->current == '\t' || *reader->current == '\n' || *reader->current == '\r')) {
+        reader->current++;
+    }
+}
+
+/**
+ * readHexDigits: Reads the 4 hex digits of a \u escape
+ * @param reader: JSONReader* positioned at the first digit
+ * @param codeUnit: unsigned int* to store the value into
+ * @return bool: true if 4 hex digits were read
+ */
+static bool readHexDigits(JSONReader* reader, unsigned int* codeUnit) {
+    if (reader->end - reader->current < 4) {
+        return false;
+    }
+
+    *codeUnit = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = *reader->current++;
+        *codeUnit <<= 4;
+        if (c >= '0' && c <= '9') {
+            *codeUnit |= (unsigned int)(c - '0');
+        }
+        else if (c >= 'a' && c <= 'f') {
+            *codeUnit |= (unsigned int)(c - 'a' + 10);
+        }
+        else if (c >= 'A' && c <= 'F') {
+            *codeUnit |= (unsigned int)(c - 'A' + 10);
+        }
+        else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * appendCodePoint: Appends a code point to the reader's scratch space as UTF-8
+ * @param reader: JSONReader* owning the scratch space
+ * @param codePoint: unsigned int Code point to append
+ */
+static void appendCodePoint(JSONReader* reader, unsigned int codePoint) {
+    char utf8[4];
+    size_t length = 0;
+
+    if (codePoint < 0x80) {
+        utf8[length++] = (char)codePoint;
+    }
+    else if (codePoint < 0x800) {
+        utf8[length++] = (char)(0xC0 | (codePoint >> 6));
+        utf8[length++] = (char)(0x80 | (codePoint & 0x3F));
+    }
+    else if (codePoint < 0x10000) {
+        utf8[length++] = (char)(0xE0 | (codePoint >> 12));
+        utf8[length++] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        utf8[length++] = (char)(0x80 | (codePoint & 0x3F));
+    }
+    else {
+        utf8[length++] = (char)(0xF0 | (codePoint >> 18));
+        utf8[length++] = (char)(0x80 | ((codePoint >> 12) & 0x3F));
+        utf8[length++] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        utf8[length++] = (char)(0x80 | (codePoint & 0x3F));
+    }
+
+    builderAppendBytes(&reader->scratch, utf8, length);
+}
+
+/**
+ * readString: Reads a string, unescaping it if needed
+ * @param reader: JSONReader* positioned at the opening quote
+ * @param value: const char** to store the start of the unescaped string into
+ * @param length: size_t* to store the length of the unescaped string into
+ * @return bool: true if a well formed string was read
+ */
+static bool readString(JSONReader* reader, const char** value, size_t* length) {
+    //Skip the opening quote
+    reader->current++;
+    const char* start = reader->current;
+
+    //Strings without escapes are handed out straight from the document
+    while (reader->current < reader->end && *reader->current != '"' && *reader->current != '\\') {
+        if ((unsigned char)(*reader->current) < 0x20) {
+            return false;
+        }
+        reader->current++;
+    }
+
+    if (reader->current == reader->end) {
+        return false;
+    }
+
+    if (*reader->current == '"') {
+        *value = start;
+        *length = (size_t)(reader->current - start);
+        reader->current++;
+        return true;
+    }
+
+    //Copy what was scanned so far, then unescape the rest into the scratch space
+    reader->scratch.length = 0;
+    builderAppendBytes(&reader->scratch, start, (size_t)(reader->current - start));
+
+    while (reader->current < reader->end && *reader->current != '"') {
+        char c = *reader->current++;
+
+        if ((unsigned char)c < 0x20) {
+            return false;
+        }
+
+        if (c != '\\') {
+            builderAppendChar(&reader->scratch, c);
+            continue;
+        }
+
+        if (reader->current == reader->end) {
+            return false;
+        }
+
+        c = *reader->current++;
+        switch (c) {
+            case '"':
+            case '\\':
+            case '/':
+                builderAppendChar(&reader->scratch, c);
+                break;
+            case 'b':
+                builderAppendChar(&reader->scratch, '\b');
+                break;
+            case 'f':
+                builderAppendChar(&reader->scratch, '\f');
+                break;
+            case 'n':
+                builderAppendChar(&reader->scratch, '\n');
+                break;
+            case 'r':
+                builderAppendChar(&reader->scratch, '\r');
+                break;
+            case 't':
+                builderAppendChar(&reader->scratch, '\t');
+                break;
+            case 'u': {
+                unsigned int codePoint = 0;
+                if (readHexDigits(reader, &codePoint) == false) {
+                    return false;
+                }
+
+                //Characters outside the BMP are written as a surrogate pair
+                if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+                    unsigned int lowSurrogate = 0;
+                    if (reader->end - reader->current < 2 || reader->current[0] != '\\' || reader->current[1] != 'u') {
+                        return false;
+                    }
+                    reader->current += 2;
+                    if (readHexDigits(reader, &lowSurrogate) == false || lowSurrogate < 0xDC00 || lowSurrogate > 0xDFFF) {
+                        return false;
+                    }
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+                }
+                else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+                    return false;
+                }
+
+                appendCodePoint(reader, codePoint);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+
+    if (reader->current == reader->end) {
+        return false;
+    }
+
+    //Skip the closing quote
+    reader->current++;
+    *value = reader->scratch.buffer;
+    *length = reader->scratch.length;
+    return true;
+}
+
+/**
+ * readNumber: Reads a number, checking it against the JSON number grammar
+ * @param reader: JSONReader* positioned at the first character of the number
+ * @return bool: true if a well formed number was read and accepted
+ */
+static bool readNumber(JSONReader* reader) {
+    const char* start = reader->current;
+    const char* p = reader->current;
+    const char* end = reader->end;
+
+    if (p < end && *p == '-') {
+        p++;
+    }
+
+    //No leading zeros
+    if (p < end && *p == '0') {
+        p++;
+    }
+    else if (p < end && *p >= '1' && *p <= '9') {
+        while (p < end && *p >= '0' && *p <= '9') {
+            p++;
+        }
+    }
+    else {
+        return false;
+    }
+
+    if (p < end && *p == '.') {
+        p++;
+        if (p == end || *p < '0' || *p > '9') {
+            return false;
+        }
+        while (p < end && *p >= '0' && *p <= '9') {
+            p++;
+        }
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        if (p < end && (*p == '+' || *p == '-')) {
+            p++;
+        }
+        if (p == end || *p < '0' || *p > '9') {
+            return false;
+        }
+        while (p < end && *p >= '0' && *p <= '9') {
+            p++;
+        }
+    }
+
+    reader->current = p;
+    return reader->handler->number == NULL || reader->handler->number(reader->handler->context, start, (size_t)(p - start));
+}
+
+/**
+ * readLiteral: Reads true, false or null
+ * @param reader: JSONReader* positioned at the first character of the literal
+ * @param literal: const char* Literal expected
+ * @return bool: true if the literal is next in the document
+ */
+static bool readLiteral(JSONReader* reader, const char* literal) {
+    size_t length = strlen(literal);
+    if ((size_t)(reader->end - reader->current) < length || memcmp(reader->current, literal, length) != 0) {
+        return false;
+    }
+    reader->current += length;
+    return true;
+}
+
+/**
+ * readObject: Reads an object and its members
+ * @param reader: JSONReader* positioned at the opening brace
+ * @return bool: true if a well formed object was read and accepted
+ */
+static bool readObject(JSONReader* reader) {
+    const JSONHandler* handler = reader->handler;
+
+    //Skip the opening brace
+    reader->current++;
+    if (handler->startObject != NULL && handler->startObject(handler->context) == false) {
+        return false;
+    }
+
+    skipWhitespace(reader);
+    if (reader->current < reader->end && *reader->current == '}') {
+        reader->current++;
+        return handler->endObject == NULL || handler->endObject(handler->context);
+    }
+
+    while (true) {
+        skipWhitespace(reader);
+        if (reader->current == reader->end || *reader->current != '"') {
+            return false;
+        }
+
+        const char* key = NULL;
+        size_t keyLength = 0;
+        if (readString(reader, &key, &keyLength) == false) {
+            return false;
+        }
+        if (handler->key != NULL && handler->key(handler->context, key, keyLength) == false) {
+            return false;
+        }
+
+        skipWhitespace(reader);
+        if (reader->current == reader->end || *reader->current != ':') {
+            return false;
+        }
+        reader->current++;
+
+        if (readValue(reader) == false) {
+            return false;
+        }
+
+        skipWhitespace(reader);
+        if (reader->current == reader->end) {
+            return false;
+        }
+        if (*reader->current == ',') {
+            reader->current++;
+            continue;
+        }
+        if (*reader->current == '}') {
+            reader->current++;
+            return handler->endObject == NULL || handler->endObject(handler->context);
+        }
+        return false;
+    }
+}
+
+/**
+ * readArray: Reads an array and its elements
+ * @param reader: JSONReader* positioned at the opening bracket
+ * @return bool: true if a well formed array was read and accepted
+ */
+static bool readArray(JSONReader* reader) {
+    const JSONHandler* handler = reader->handler;
+
+    //Skip the opening bracket
+    reader->current++;
+    if (handler->startArray != NULL && handler->startArray(handler->context) == false) {
+        return false;
+    }
+
+    skipWhitespace(reader);
+    if (reader->current < reader->end && *reader->current == ']') {
+        reader->current++;
+        return handler->endArray == NULL || handler->endArray(handler->context);
+    }
+
+    while (true) {
+        if (readValue(reader) == false) {
+            return false;
+        }
+
+        skipWhitespace(reader);
+        if (reader->current == reader->end) {
+            return false;
+        }
+        if (*reader->current == ',') {
+            reader->current++;
+            continue;
+        }
+        if (*reader->current == ']') {
+            reader->current++;
+            return handler->endArray == NULL || handler->endArray(handler->context);
+        }
+        return false;
+    }
+}
+
+/**
+ * readValue: Reads any JSON value
+ * @param reader: JSONReader* positioned before the value (Whitespace is skipped)
+ * @return bool: true if a well formed value was read and accepted
+ */
+static bool readValue(JSONReader* reader) {
+    const JSONHandler* handler = reader->handler;
+
+    skipWhitespace(reader);
+    if (reader->current == reader->end) {
+        return false;
+    }
+
+    switch (*reader->current) {
+        case '{':
+        case '[': {
+            if (reader->depth == JSON_MAX_DEPTH) {
+                return false;
+            }
+            reader->depth++;
+            bool read = *reader->current == '{' ? readObject(reader) : readArray(reader);
+            reader->depth--;
+            return read;
+        }
+        case '"': {
+            const char* value = NULL;
+            size_t length = 0;
+            if (readString(reader, &value, &length) == false) {
+                return false;
+            }
+            return handler->string == NULL || handler->string(handler->context, value, length);
+        }
+        case 't':
+            return readLiteral(reader, "true") && (handler->boolean == NULL || handler->boolean(handler->context, true));
+        case 'f':
+            return readLiteral(reader, "false") && (handler->boolean == NULL || handler->boolean(handler->context, false));
+        case 'n':
+            return readLiteral(reader, "null") && (handler->null == NULL || handler->null(handler->context));
+        default:
+            return readNumber(reader);
+    }
+}
+
+bool readJSON(const char* json, size_t length, const JSONHandler* handler) {
+    if (json == NULL || handler == NULL) {
+        return false;
+    }
+
+    JSONReader reader;
+    reader.current = json;
+    reader.end = json + length;
+    reader.handler = handler;
+    reader.depth = 0;
+    initializeStringBuilder(&reader.scratch, 0);
+
+    bool read = readValue(&reader);
+
+    //Nothing but whitespace may follow the document
+    if (read) {
+        skipWhitespace(&reader);
+        read = reader.current == reader.end;
+    }
+
+    clearStringBuilder(&reader.scratch);
+    return read;
+}
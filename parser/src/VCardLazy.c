@@ -0,0 +1,223 @@
+/**
+ * @file VCardLazy.c
+ * @brief This file contains the VCard file's lazy cards, used to read single properties without building the whole card.
+ * @author ADD LATER
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "VCardParser.h"
+#include "HelperFunctions.h"
+#include "VCardTokenizer.h"
+#include "VCardArena.h"
+#include "VCardPropertyKind.h"
+#include "VCardLazy.h"
+#define DEBUG false
+
+/**
+ * addLazyProperty: Records where a property's content line is
+ * @param card: LazyCard* to add to
+ * @param line: const ContentLine* split line of the property (Points into the card's file contents)
+ * @param capacity: int* Number of properties card->properties has room for - Grown as needed
+ */
+static void addLazyProperty(LazyCard* card, const ContentLine* line, int* capacity) {
+    if (card->propertyCount == *capacity) {
+        *capacity = *capacity == 0 ? 16 : *capacity * 2;
+        card->properties = realloc(card->properties, (size_t)(*capacity) * sizeof(LazyProperty));
+    }
+
+    LazyProperty* property = &card->properties[card->propertyCount];
+    property->offset = (size_t)(line->line.start - card->input.contents);
+    property->length = line->line.length;
+    property->lineNumber = line->lineNumber;
+    property->kind = lookupPropertyKind(line->name);
+    property->decoded = NULL;
+
+    card->propertyCount++;
+}
+
+/**
+ * scanLazyCard: Scans a card's lines, recording each property (Same structural checks as parseCard)
+ * @param tokenizer: Tokenizer* positioned before the BEGIN:VCARD line
+ * @param card: LazyCard* to record the properties into
+ * @return VCardErrorCode: OK on a well formed card, the error encountered otherwise
+ */
+static VCardErrorCode scanLazyCard(Tokenizer* tokenizer, LazyCard* card) {
+    ContentLine line;
+    TokenStatus status;
+    int capacity = 0;
+
+    //Check first line of VCard
+    status = nextContentLine(tokenizer, &line);
+    if (status == TOKEN_ERROR) {
+        return INV_PROP;
+    }
+    if (status == TOKEN_END || viewCaseEquals(line.line, "BEGIN:VCARD") == false) {
+        return INV_CARD;
+    }
+
+    //Check second line of VCard
+    status = nextContentLine(tokenizer, &line);
+    if (status == TOKEN_ERROR) {
+        return INV_PROP;
+    }
+    if (status == TOKEN_END || viewCaseEquals(line.line, "VERSION:4.0") == false) {
+        return INV_CARD;
+    }
+
+    while (true) {
+        status = nextContentLine(tokenizer, &line);
+        if (status == TOKEN_ERROR) {
+            return INV_PROP;
+        }
+        if (status == TOKEN_END) {
+            return INV_CARD;
+        }
+        if (viewCaseEquals(line.line, "END:VCARD")) {
+            break;
+        }
+
+        //Same line checks as parseCard - The line must not be too long, or be BEGIN/VERSION, and must have a name and value
+        if (line.longestPhysicalLine > 998 || viewCaseEquals(line.line, "BEGIN:VCARD") || viewCaseEquals(line.line, "VERSION:4.0")) {
+            return INV_PROP;
+        }
+        if (splitContentLine(&line) != OK || line.name.length == 0 || line.values.length == 0) {
+            return INV_PROP;
+        }
+
+        addLazyProperty(card, &line, &capacity);
+        if (card->fnIndex == -1 && card->properties[card->propertyCount - 1].kind == PROP_FN) {
+            card->fnIndex = card->propertyCount - 1;
+        }
+    }
+
+    //Check if FN was set, if not, return INV_CARD
+    if (card->fnIndex == -1) {
+        return INV_CARD;
+    }
+
+    //END:VCARD must be the last line of the file
+    status = nextContentLine(tokenizer, &line);
+    if (status == TOKEN_ERROR) {
+        return INV_PROP;
+    }
+    if (status == TOKEN_LINE) {
+        return INV_CARD;
+    }
+
+    return OK;
+}
+
+VCardErrorCode createLazyCard(char* fileName, LazyCard** newCard) {
+    *newCard = NULL;
+
+    //Check file name and extension
+    if (verifyFileName(fileName) == false) {
+        return INV_FILE;
+    }
+
+    //NOTE: REMEMBER TO FREE card (deleteLazyCard)
+    LazyCard* card = malloc(sizeof(LazyCard));
+    card->properties = NULL;
+    card->propertyCount = 0;
+    card->fnIndex = -1;
+    card->arena = NULL;
+
+    //The file contents stay open - Properties are decoded straight out of them
+    if (openInputFile(fileName, &card->input) == false) {
+        free(card);
+        return INV_FILE;
+    }
+
+    //The file can not start with an empty line
+    VCardErrorCode errorToReturn = OK;
+    if (card->input.contents[0] == '\r' || card->input.contents[0] == '\n') {
+        errorToReturn = INV_PROP;
+    }
+    else {
+        //Folded lines are unfolded in place, so every property is one contiguous byte range
+        Tokenizer tokenizer;
+        initializeWritableTokenizer(&tokenizer, card->input.contents, card->input.length);
+        errorToReturn = scanLazyCard(&tokenizer, card);
+        clearTokenizer(&tokenizer);
+    }
+
+    if (errorToReturn != OK) {
+        deleteLazyCard(card);
+        return errorToReturn;
+    }
+
+    if(DEBUG)printf("createLazyCard: %d properties in %s\n", card->propertyCount, fileName);
+
+    *newCard = card;
+    return OK;
+}
+
+void deleteLazyCard(LazyCard* card) {
+    if (card == NULL) {
+        return;
+    }
+
+    //Decoded properties all live in the arena
+    if (card->arena != NULL) {
+        releaseArena(card->arena);
+    }
+    free(card->properties);
+    closeInputFile(&card->input);
+    free(card);
+}
+
+int cardPropertyCount(const LazyCard* card) {
+    return card != NULL ? card->propertyCount : 0;
+}
+
+PropertyKind cardGetPropertyKind(const LazyCard* card, int index) {
+    if (card == NULL || index < 0 || index >= card->propertyCount) {
+        return PROP_UNRESOLVED;
+    }
+    return card->properties[index].kind;
+}
+
+int cardFindProperty(const LazyCard* card, PropertyKind kind, int start) {
+    if (card == NULL) {
+        return -1;
+    }
+
+    for (int i = start < 0 ? 0 : start; i < card->propertyCount; i++) {
+        if (card->properties[i].kind == kind) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+Property* cardGetProperty(LazyCard* card, int index) {
+    if (card == NULL || index < 0 || index >= card->propertyCount) {
+        return NULL;
+    }
+
+    LazyProperty* property = &card->properties[index];
+    if (property->decoded != NULL) {
+        return property->decoded;
+    }
+
+    //Split the line again - Only the byte range was kept
+    ContentLine line;
+    line.line.start = card->input.contents + property->offset;
+    line.line.length = property->length;
+    line.lineNumber = property->lineNumber;
+    line.byteOffset = property->offset;
+    line.longestPhysicalLine = 0;
+    splitContentLine(&line);
+
+    if (card->arena == NULL) {
+        card->arena = createArena(0);
+    }
+    if (createPropertyFromLine(&line, &property->decoded, card->arena) != OK) {
+        return NULL;
+    }
+
+    return property->decoded;
+}
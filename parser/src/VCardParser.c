@@ -5,751 +5,1857 @@
  */
 
 //NOTE: REMEMBER TO CHANGE HARDCODED FILE LOCATIONS
+//Needed for fsync, mkstemp, fchmod and O_DIRECTORY under -std=c11
+#define _POSIX_C_SOURCE 200809L
 #include <stdbool.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "LinkedListAPI.h"
 #include "VCardParser.h"
 #include "HelperFunctions.h"
+#include "VCardTokenizer.h"
+#include "VCardArena.h"
+#include "VCardStringBuilder.h"
+#include "VCardJSONReader.h"
+#include "VCardPropertyKind.h"
+#include "VCardDiagnostics.h"
+#include "VCardSerializer.h"
 #define DEBUG false
 
 VCardErrorCode createCard(char* fileName, Card** newCardObject) {
-    //Malloc the Card** structure and initialize it
-    //NOTE: REMEMBER TO FREE newCard
-    *newCardObject = malloc(sizeof(Card));
-    Card* newCard = *newCardObject;
-    newCard->fn = NULL;
-    newCard->anniversary = NULL;
-    newCard->birthday = NULL;
-    newCard->optionalProperties = initializeList(printProperty, deleteProperty, compareProperties);
+    return createCardWithOptions(fileName, newCardObject, NULL);
+}
+
+/**
+ * recordParseError: Records an error found while parsing, in the options' diagnostics if there are any
+ * @param options: const ParseOptions* being parsed with (May be NULL)
+ * @param firstError: VCardErrorCode* First error found - Only set if it is still OK
+ * @param error: VCardErrorCode of the error
+ * @param line: const ContentLine* the error was found on, NULL if the error is not tied to a line
+ * @param reason: const char* Static description of the error
+ * @return bool: true if parsing must stop, false if the options ask for every error to be collected
+ */
+static bool recordParseError(const ParseOptions* options, VCardErrorCode* firstError, VCardErrorCode error, const ContentLine* line, const char* reason) {
+    if (*firstError == OK) {
+        *firstError = error;
+    }
+
+    if (options != NULL && options->diagnostics != NULL) {
+        addDiagnostic(options->diagnostics, error, line, reason);
+    }
+    if(DEBUG)printf("recordParseError: line %d: %s\n", line != NULL ? line->lineNumber : 0, reason);
+
+    return options == NULL || options->collectErrors == false;
+}
+
+/**
+ * recordPropertyError: Records an error confined to one content line. In lenient mode the line is dropped - It is
+ * copied into the options' quarantine and the card goes on without it. Otherwise it is handled like recordParseError
+ * @param options: const ParseOptions* being parsed with (May be NULL)
+ * @param firstError: VCardErrorCode* First error found - Only set if the line is not dropped
+ * @param error: VCardErrorCode of the error
+ * @param line: const ContentLine* the error was found on
+ * @param reason: const char* Static description of the error
+ * @return bool: true if parsing must stop
+ */
+static bool recordPropertyError(const ParseOptions* options, VCardErrorCode* firstError, VCardErrorCode error, const ContentLine* line, const char* reason) {
+    if (options == NULL || options->lenient == false) {
+        return recordParseError(options, firstError, error, line, reason);
+    }
+
+    if (options->diagnostics != NULL) {
+        addDiagnostic(options->diagnostics, error, line, reason);
+    }
 
+    //Lines with a bad line break have no text to keep
+    if (options->quarantine != NULL && line->line.start != NULL) {
+        //NOTE: REMEMBER TO FREE the quarantined line (Owned by the quarantine list)
+        insertBack(options->quarantine, viewToString(line->line));
+    }
+    if(DEBUG)printf("recordPropertyError: dropped line %d: %s\n", line->lineNumber, reason);
+
+    return false;
+}
+
+/**
+ * parseCardFile: Reads the single card in a file, either into a Card or into a CardSummary
+ * @param fileName: Destination/Name of the file
+ * @param options: const ParseOptions* to parse with (Ignored for summaries)
+ * @param newCardObject: Card** to store the new Card* into, NULL to summarize the card instead
+ * @param summary: CardSummary* to store the summary into when newCardObject is NULL
+ * @return VCardErrorCode: OK on a valid card, the error encountered otherwise
+ */
+static VCardErrorCode parseCardFile(char* fileName, const ParseOptions* options, Card** newCardObject, CardSummary* summary) {
     //Create error code to return
-    VCardErrorCode errorToReturn;
+    VCardErrorCode errorToReturn = OK;
 
     //Check file name and extension
     if (verifyFileName(fileName) == false) {
-        deleteCard(newCard);
-        newCard = NULL;
-        *newCardObject = newCard;
-        errorToReturn = INV_FILE;
+        recordParseError(options, &errorToReturn, INV_FILE, NULL, "File name does not end in .vcf or .vcard");
         return errorToReturn;
     }
 
-    //Read in the file to a string
-    //Note: Remember to free returnedString
-    char* returnedString = readFileToString(fileName);
+    //Read the file into memory (Or map it, if asked to)
+    //Note: Remember to close input
+    InputFile input;
+    bool mapFile = options != NULL && options->mapFile;
 
     //Check if file was read in correctly
-    if (returnedString == NULL) {
-        deleteCard(newCard);
-        newCard = NULL;
-        *newCardObject = newCard;
-        errorToReturn = INV_FILE;
+    if ((mapFile ? mapInputFile(fileName, &input) : openInputFile(fileName, &input)) == false) {
+        recordParseError(options, &errorToReturn, INV_FILE, NULL, "File is empty or can not be read");
         return errorToReturn;
     }
 
-    //Check that every \n has a \r before it
-    if (verifyStringEndOfLines(returnedString) == false) {
-        deleteCard(newCard);
-        newCard = NULL;
-        *newCardObject = newCard;
-        free(returnedString);
-        errorToReturn = INV_PROP;
+    //The file can not start with an empty line
+    if (input.contents[0] == '\r' || input.contents[0] == '\n') {
+        closeInputFile(&input);
+        ContentLine firstLine = { .lineNumber = 1 };
+        recordParseError(options, &errorToReturn, INV_PROP, &firstLine, "File starts with an empty line");
         return errorToReturn;
     }
 
-    //Go through string looking for commas in between quotation marks - Remove backslash before them
-    removeBackslash(returnedString);
+    //Walk the file contents once - Lines are handed out as views into the file contents (Folded lines are unfolded in place)
+    Tokenizer tokenizer;
+    initializeWritableTokenizer(&tokenizer, input.contents, input.length);
+
+    if (newCardObject != NULL) {
+        errorToReturn = parseCard(&tokenizer, newCardObject, options);
+    }
+    else {
+        errorToReturn = summarizeCard(&tokenizer, summary);
+    }
+
+    //END:VCARD must be the last line of the file (Also checked after an invalid card when collecting every error)
+    bool collectErrors = options != NULL && options->collectErrors && newCardObject != NULL;
+    if (errorToReturn == OK || collectErrors) {
+        ContentLine line;
+        TokenStatus status = nextContentLine(&tokenizer, &line);
+        if (status != TOKEN_END) {
+            if (newCardObject != NULL) {
+                deleteCard(*newCardObject);
+                *newCardObject = NULL;
+            }
+            else {
+                free(summary->fn);
+                summary->fn = NULL;
+            }
+            if (status == TOKEN_ERROR) {
+                recordParseError(options, &errorToReturn, INV_PROP, &line, "Line break is not \\r\\n");
+            }
+            else {
+                recordParseError(options, &errorToReturn, INV_CARD, &line, "Content after END:VCARD");
+            }
+        }
+    }
 
-    //Declare variables
-    int numberOfLines = 0;
-    int i = 0;
+    clearTokenizer(&tokenizer);
+    closeInputFile(&input);
 
-    //Split the file contents and unfold
-    //Note: Remember to free lines 2d array - Requires freeing all strings inside table, then freeing table
-    char** lines = split(returnedString, &numberOfLines, "\r\n", true);
+    return errorToReturn;
+}
 
-    //Free the single string of file content
-    free(returnedString);
-    returnedString = NULL;
+VCardErrorCode createCardWithOptions(char* fileName, Card** newCardObject, const ParseOptions* options) {
+    *newCardObject = NULL;
+    return parseCardFile(fileName, options, newCardObject, NULL);
+}
 
-    //Check first line of VCard
-    if (stringCaseCompare(lines[0], "BEGIN:VCARD") != 0) {
-        deleteCard(newCard);
-        newCard = NULL;
-        *newCardObject = newCard;
+VCardErrorCode createCardSummary(char* fileName, CardSummary* summary) {
+    summary->fn = NULL;
+    summary->propertyCount = 0;
 
-        //Free all lines of the 2d string array
-        for (i = 0; i < numberOfLines; i++) {
-            free(lines[i]);
-        }
-        //Free the 2d array
-        free(lines);
+    VCardErrorCode errorToReturn = parseCardFile(fileName, NULL, NULL, summary);
 
-        //Return INV_CARD
-        errorToReturn = INV_CARD;
-        return errorToReturn;
+    //Parse errors (Including lines after END:VCARD) take precedence over validation errors
+    if (errorToReturn == OK && summary->validationError != OK) {
+        free(summary->fn);
+        summary->fn = NULL;
+        summary->propertyCount = 0;
+        errorToReturn = summary->validationError;
     }
 
-    //Check second line of VCard
-    if (stringCaseCompare(lines[1], "VERSION:4.0") != 0) {
-        deleteCard(newCard);
-        newCard = NULL;
-        *newCardObject = newCard;
+    return errorToReturn;
+}
 
-        //Free all lines of the 2d string array
-        for (i = 0; i < numberOfLines; i++) {
-            free(lines[i]);
-        }
-        //Free the 2d array
-        free(lines);
+/**
+ * validateOptionalProperty: Runs validateCard's checks on one of a card's optional properties
+ * @param prop: const Property* to validate
+ * @param occurrences: int[PROPERTY_KIND_COUNT] Optional properties seen of each kind - Counts prop if it is valid
+ * @param reason: const char** to store a description of the error into (Untouched on OK)
+ * @return VCardErrorCode: OK on a valid property, the error validateCard returns for it otherwise
+ */
+static VCardErrorCode validateOptionalProperty(const Property* prop, int occurrences[PROPERTY_KIND_COUNT], const char** reason) {
+    if (errorCheckProperty((Property*)prop) == INV_PROP) {
+        *reason = "Property has an empty name, parameter or value";
+        return INV_PROP;
+    }
 
-        //Return INV_CARD
-        errorToReturn = INV_CARD;
-        return errorToReturn;
+    //Unknown names, BEGIN/END/VERSION and BDAY/ANNIVERSARY are not allowed among the optional properties
+    PropertyKind kind = propertyKind(prop);
+    const PropertySpec* spec = propertySpec(kind);
+    if (spec->optionalPropertyError != OK) {
+        *reason = kind == PROP_UNKNOWN ? "Unknown property name" : "Property is not allowed more than once";
+        return spec->optionalPropertyError;
+    }
+    if (checkValueCount(kind, prop->values->length) != OK) {
+        *reason = "Wrong number of values for the property";
+        return INV_PROP;
     }
 
-    //Check last line of VCard
-    if (stringCaseCompare(lines[numberOfLines - 1], "END:VCARD") != 0) {
-        deleteCard(newCard);
-        newCard = NULL;
-        *newCardObject = newCard;
+    occurrences[kind]++;
+    return OK;
+}
 
-        //Free all lines of the 2d string array
-        for (i = 0; i < numberOfLines; i++) {
-            free(lines[i]);
-        }
-        //Free the 2d array
-        free(lines);
+VCardErrorCode parseCard(Tokenizer* tokenizer, Card** newCardObject, const ParseOptions* options) {
+    *newCardObject = NULL;
 
-        //Return INV_CARD
-        errorToReturn = INV_CARD;
-        return errorToReturn;
-    }
+    bool useArena = options != NULL && options->useArena;
+    bool validate = options != NULL && options->validate;
+    bool collectErrors = options != NULL && options->collectErrors;
+    bool lenient = options != NULL && options->lenient;
 
-    //Error check line lengths (MUST not be more than 998 characters)
-    for (i = 0; i < numberOfLines; i++) {
-        if (strlen(lines[i]) > 998) {
-            deleteCard(newCard);
-            newCard = NULL;
-            *newCardObject = newCard;
+    ContentLine line;
+    TokenStatus status;
+    VCardErrorCode errorToReturn = OK;
 
-            //Free all lines of the 2d string array
-            for (i = 0; i < numberOfLines; i++) {
-                free(lines[i]);
-            }
-            //Free the 2d array
-            free(lines);
+    //Check first line of VCard
+    status = nextContentLine(tokenizer, &line);
+    if (status == TOKEN_ERROR) {
+        recordParseError(options, &errorToReturn, INV_PROP, &line, "Line break is not \\r\\n");
+        return errorToReturn;
+    }
+    if (status == TOKEN_END || viewCaseEquals(line.line, "BEGIN:VCARD") == false) {
+        recordParseError(options, &errorToReturn, INV_CARD, status == TOKEN_END ? NULL : &line, "Card does not start with BEGIN:VCARD");
+        return errorToReturn;
+    }
 
-            //Return INV_CARD
-            errorToReturn = INV_PROP;
-            return errorToReturn;
-        }
+    //Check second line of VCard
+    status = nextContentLine(tokenizer, &line);
+    if (status == TOKEN_ERROR) {
+        recordParseError(options, &errorToReturn, INV_PROP, &line, "Line break is not \\r\\n");
+        return errorToReturn;
+    }
+    if (status == TOKEN_END || viewCaseEquals(line.line, "VERSION:4.0") == false) {
+        recordParseError(options, &errorToReturn, INV_CARD, status == TOKEN_END ? NULL : &line, "VERSION:4.0 does not follow BEGIN:VCARD");
+        return errorToReturn;
     }
 
-    //Check if the line contains a ':', if not, return INV_PROP
-    for (i = 0; i < numberOfLines; i++) {
-        if (numberOfCharacters(lines[i], ':') == 0) {
-            deleteCard(newCard);
-            newCard = NULL;
-            *newCardObject = newCard;
+    //NOTE: REMEMBER TO FREE newCard
+    //Arena cards own their arena - deleteCard releases it
+    Arena* arena = useArena ? createArena(0) : NULL;
+    Card* newCard = initializeCard(arena);
 
-            //Free all lines of the 2d string array
-            for (i = 0; i < numberOfLines; i++) {
-                free(lines[i]);
-            }
-            //Free the 2d array
-            free(lines);
-            //INV_PROP
-            errorToReturn = INV_PROP;
-            return INV_PROP;
-        }
-    }
+    //Optional properties seen of each kind, only counted when validating
+    int occurrences[PROPERTY_KIND_COUNT] = { 0 };
 
     //Go through the lines creating structures
     bool FNSet = false;
     bool BDAYSet = false;
     bool anniversarySet = false;
-    //TODO: Error check DateTime property specs
-    for (i = 2; i < numberOfLines - 1; i++) {
-        bool groupSet = false;
-
-        //Make sure the line isn't BEGIN/END/VERSION
-        if (verifyOnlyOnce(lines[i]) == false) {
+    bool cardEnded = false;
+    while (true) {
+        status = nextContentLine(tokenizer, &line);
 
-            //Free all lines of the 2d string array
-            for (i = 0; i < numberOfLines; i++) {
-                free(lines[i]);
+        if (status == TOKEN_ERROR) {
+            if (recordPropertyError(options, &errorToReturn, INV_PROP, &line, "Line break is not \\r\\n")) {
+                break;
             }
-            //Free the 2d array
-            free(lines);
-
-            deleteCard(newCard);
-            newCard = NULL;
-            *newCardObject = newCard;
-
-            errorToReturn = INV_PROP;
-            return errorToReturn;
+            continue;
         }
 
-        //NOTE: REMEMBER TO FREE newProperty
-        Property* newProperty = createProperty();
-
-        int currentLineLength = (int)(strlen(lines[i]));
-        char* currentLine = calloc(currentLineLength + 1, sizeof(char));
-        strcpy(currentLine, lines[i]);
-
-        //NOTE: REMEMBER TO FREE currentLinePointer
-        char* currentLinePointer = currentLine;
-
-        //Values check
-        //returned = All values after furthest-left ':'
-        char* returned = strchr(currentLine, ':');
-        returned++;
+        //Card must end with END:VCARD
+        if (status == TOKEN_END) {
+            recordParseError(options, &errorToReturn, INV_CARD, NULL, "Card does not end with END:VCARD");
+            break;
+        }
 
-        if (returned == NULL || strcmp(returned, "") == 0) {
-            free(currentLine);
+        if (viewCaseEquals(line.line, "END:VCARD")) {
+            cardEnded = true;
+            break;
+        }
 
-            //Free all lines of the 2d string array
-            for (i = 0; i < numberOfLines; i++) {
-                free(lines[i]);
+        //Error check line lengths (MUST not be more than 998 characters) - Folding keeps long values within the limit
+        if (line.longestPhysicalLine > 998) {
+            if (recordPropertyError(options, &errorToReturn, INV_PROP, &line, "Line is longer than 998 characters")) {
+                break;
             }
-            //Free the 2d array
-            free(lines);
-
-            deleteProperty(newProperty);
-            deleteCard(newCard);
-            newCard = NULL;
-            *newCardObject = newCard;
-
-            errorToReturn = INV_PROP;
-            return errorToReturn;
+            continue;
         }
 
-        //Group check and set
-        char* group = groupCheck(currentLine);
-        if (group != NULL) {
-            newProperty->group = calloc(strlen(group) + 1, sizeof(char));
-            strcpy(newProperty->group, group);
-            if(DEBUG)printf("group: %s\n", group);
-            free(group);
-            groupSet = true;
-        }
-
-	    VCardErrorCode propCheck = propertyCheck(currentLine);
-	    if (propCheck != OK) {
-	        free(currentLine);
-	        for (i = 0; i < numberOfLines; i++) {
-                free(lines[i]);
-	        }
-	        free(lines);
-	        deleteProperty(newProperty);
-	        deleteCard(newCard);
-	        newCard = NULL;
-	        *newCardObject = newCard;
-	        errorToReturn = INV_PROP;
-	        return errorToReturn;
-	    }
-
-        //If there's no semi-colon in the string, then everything to the left of the colon is the property
-        //NOTE: if statement deals with string that has no parameters and only one value (Not a list of values)
-        if (numberOfCharacters(currentLine, ';') == 0) {
-            //Call function to store property name and values
-            noParamOneValue(newCard, newProperty, currentLine, returned, groupSet);
-        }
-        //NOTE: else statement deals with parameters or a list of Property* structure values
-        else {
-            //NOTE: REMEMBER TO FREE parameterList
-            List* parameterList = initializeList(printValue, deleteValue, compareValues);
-
-            //Otherwise must check parameters (returned == values) && (currentLine == Property + parameters)
-            //Everything before the first semi-colon is a property - Read until first ';' to get property
-            char* dupCurrentLine = calloc(currentLineLength + 1, sizeof(char));
-            strcpy(dupCurrentLine, currentLine);
-            //NOTE: REMEMBER TO FREE dupCurrentLinePointer
-            char* dupCurrentLinePointer = dupCurrentLine;
-
-            //Recheck how many ':' are found in current line - if there is a colon, all of the ';' separate values of the Property* structure
-            //NOTE: if statement deals with parameters and values if there are any
-	        currentLine = strtok(currentLine, ";");
-
-            if (numberOfCharacters(currentLine, ':') == 0) {
-
-                params(newCard, newProperty, parameterList, currentLine, returned, groupSet);
-
-                //Go through parameter list and create/add Parameter*s to Property*
-                VCardErrorCode addError = addParametersToProperty(newProperty, parameterList);
-		        if (addError != OK) {
-                    free(dupCurrentLinePointer);
-		            freeList(parameterList);
-	                free(currentLine);
-	                for (i = 0; i < numberOfLines; i++) {
-                        free(lines[i]);
-	                }
-	                free(lines);
-	                deleteProperty(newProperty);
-                    deleteCard(newCard);
-	                newCard = NULL;
-                    *newCardObject = newCard;
-                    errorToReturn = INV_PROP;
-                    return errorToReturn;
-		        }
-            }
-            //NOTE: else statement deals with no parameters but multiple Property* structure values
-            else {
-                //Should be a property followed by a list of values - delimit on ';' && ':'
-                noParamMultipleValues(newCard, newProperty, dupCurrentLine, returned, groupSet);
+        //Make sure the line isn't BEGIN/VERSION
+        if (viewCaseEquals(line.line, "BEGIN:VCARD")) {
+            //Hand the line back so a multi-card reader can start the next card from it
+            unreadContentLine(tokenizer, &line);
+            recordParseError(options, &errorToReturn, INV_PROP, &line, "BEGIN:VCARD before END:VCARD");
+            break;
+        }
+        if (viewCaseEquals(line.line, "VERSION:4.0")) {
+            if (recordPropertyError(options, &errorToReturn, INV_PROP, &line, "VERSION appears more than once")) {
+                break;
             }
-            free(dupCurrentLinePointer);
-            freeList(parameterList);
+            continue;
         }
 
-        free(currentLinePointer);
-
-        //Check if newProperty->name valid (Verify working)
-        if (newProperty->name == NULL || strcmp(newProperty->name, "") == 0) {
-            //Free all lines of the 2d string array
-            for (i = 0; i < numberOfLines; i++) {
-                free(lines[i]);
+        //Check if the line contains a ':', if not, return INV_PROP
+        if (splitContentLine(&line) != OK) {
+            line.name.start = NULL;
+            if (recordPropertyError(options, &errorToReturn, INV_PROP, &line, "Line has no ':' before its value")) {
+                break;
             }
-            //Free the 2d array
-            free(lines);
-
-            deleteCard(newCard);
-            newCard = NULL;
-            *newCardObject = newCard;
-
-            errorToReturn = INV_PROP;
-            return errorToReturn;
+            continue;
         }
 
-        //If a group has not been set, initialize it with an empty string
-        if (newProperty->group == NULL) {
-            newProperty->group = calloc(1, sizeof(char));
-            strcpy(newProperty->group, "");
+        //NOTE: REMEMBER TO FREE newProperty
+        Property* newProperty = NULL;
+        if (createPropertyFromLine(&line, &newProperty, arena) != OK) {
+            if (recordPropertyError(options, &errorToReturn, INV_PROP, &line, "Property has an empty name or value, or a malformed parameter")) {
+                break;
+            }
+            continue;
         }
 
         //Set the property to one of the three main card structures (FN/BDAY/ANNIVERSARY) - Or insert to optionalProperties
-        if (stringCaseCompare(newProperty->name, "FN") == 0 && FNSet == false) {
+        if (newProperty->kind == PROP_FN && FNSet == false) {
+            const char* reason = NULL;
+            if (validate && errorCheckProperty(newProperty) != OK) {
+                reason = "Property has an empty name, parameter or value";
+            }
+            else if (validate && checkPropertyValueCount(newProperty) != OK) {
+                reason = "Wrong number of values for the property";
+            }
+            if (reason != NULL) {
+                //A dropped FN leaves room for a later one
+                if (lenient == false) {
+                    FNSet = true;
+                }
+                deleteProperty(newProperty);
+                if (recordPropertyError(options, &errorToReturn, INV_PROP, &line, reason)) {
+                    break;
+                }
+                continue;
+            }
+
             //Found FN property - Set newCard->fn = newProperty
             newCard->fn = newProperty;
             //Set FNSet = true
             FNSet = true;
         }
-        else if (stringCaseCompare(newProperty->name, "BDAY") == 0 && BDAYSet == false) {
-            DateTime* newBDay = parseDate(newProperty);
-            if (validateDateTime(newBDay) != true) {
-                deleteProperty(newProperty);
-		        deleteDate(newBDay);
-
-                //Free all lines of the 2d string array
-                for (i = 0; i < numberOfLines; i++) {
-                    free(lines[i]);
-                }
-                //Free the 2d array
-                free(lines);
-
-                deleteCard(newCard);
-                newCard = NULL;
-                *newCardObject = newCard;
-
-                errorToReturn = INV_PROP;
-                return errorToReturn;
-            }
-            BDAYSet = true;
+        else if ((newProperty->kind == PROP_BDAY && BDAYSet == false) || (newProperty->kind == PROP_ANNIVERSARY && anniversarySet == false)) {
+            bool isBDay = newProperty->kind == PROP_BDAY;
+            DateTime* newDate = parseDate(newProperty);
             //Delete Property* structure
             deleteProperty(newProperty);
-            newCard->birthday = newBDay;
-        }
-        else if (stringCaseCompare(newProperty->name, "ANNIVERSARY") == 0 && anniversarySet == false) {
-            DateTime* newAnniversary = parseDate(newProperty);
-            if (validateDateTime(newAnniversary) != true) {
-                deleteProperty(newProperty);
-                deleteDate(newAnniversary);
 
-                //Free all lines of the 2d string array
-                for (i = 0; i < numberOfLines; i++) {
-                    free(lines[i]);
+            VCardErrorCode dateError = OK;
+            const char* reason = NULL;
+            if (validateDateTime(newDate) != true) {
+                dateError = INV_PROP;
+                reason = "Date or time can not be parsed";
+            }
+            else if (validate && errorCheckDateTime(newDate) != OK) {
+                dateError = INV_DT;
+                reason = "Date or time is not valid";
+            }
+
+            //Later BDAY/ANNIVERSARY properties are duplicates, unless this one was dropped in lenient mode
+            if (dateError == OK || lenient == false) {
+                if (isBDay) {
+                    BDAYSet = true;
                 }
-                //Free the 2d array
-                free(lines);
+                else {
+                    anniversarySet = true;
+                }
+            }
 
-                deleteCard(newCard);
-                newCard = NULL;
-                *newCardObject = newCard;
+            if (dateError != OK) {
+                if (arena == NULL) {
+                    deleteDate(newDate);
+                }
+                if (recordPropertyError(options, &errorToReturn, dateError, &line, reason)) {
+                    break;
+                }
+                continue;
+            }
 
-                errorToReturn = INV_PROP;
-                return errorToReturn;
+            if (isBDay) {
+                newCard->birthday = newDate;
+            }
+            else {
+                newCard->anniversary = newDate;
             }
-            anniversarySet = true;
-            //Delete Property* structure
-            deleteProperty(newProperty);
-            newCard->anniversary = newAnniversary;
         }
         else {
+            if (validate) {
+                //Cardinality is checked as soon as a property appears once too often (The duplicate is not counted)
+                const char* reason = NULL;
+                VCardErrorCode propertyError = validateOptionalProperty(newProperty, occurrences, &reason);
+                if (propertyError == OK && propertySpec(newProperty->kind)->cardinality == CARDINALITY_AT_MOST_ONE && occurrences[newProperty->kind] > 1) {
+                    occurrences[newProperty->kind]--;
+                    propertyError = INV_PROP;
+                    reason = "Property is not allowed more than once";
+                }
+                if (propertyError != OK) {
+                    deleteProperty(newProperty);
+                    if (recordPropertyError(options, &errorToReturn, propertyError, &line, reason)) {
+                        break;
+                    }
+                    continue;
+                }
+            }
+
             insertBack(newCard->optionalProperties, newProperty);
         }
     }
 
-    //Free all lines of the 2d string array
-    for (i = 0; i < numberOfLines; i++) {
-        free(lines[i]);
+    //Check if FN was set, if not, return INV_CARD (Only worth reporting if the whole card was read)
+    if (FNSet == false && (errorToReturn == OK || (collectErrors && cardEnded))) {
+        recordParseError(options, &errorToReturn, INV_CARD, NULL, "Card has no FN property");
     }
-    //Free the 2d array
-    free(lines);
 
-    //Check if FN was set, if not, return INV_CARD
-    if (FNSet == false) {
+    if (errorToReturn != OK) {
         deleteCard(newCard);
-        newCard = NULL;
-        *newCardObject = newCard;
-
-        errorToReturn = INV_CARD;
         return errorToReturn;
     }
 
     //Return OK on successful card creation
     *newCardObject = newCard;
-    errorToReturn = OK;
     return errorToReturn;
 }
 
-VCardErrorCode writeCard(const char* fileName, const Card* obj) {
-    //TODO: Confirm empty values get written correctly
-    //Create error code to return
-    VCardErrorCode errorToReturn;
+VCardErrorCode summarizeCard(Tokenizer* tokenizer, CardSummary* summary) {
+    summary->fn = NULL;
+    summary->propertyCount = 0;
+    summary->validationError = OK;
 
-    //Check if Card* object is NULL
-    if (obj == NULL) {
-        errorToReturn = WRITE_ERROR;
-        return errorToReturn;
+    ContentLine line;
+    TokenStatus status;
+
+    //Check first line of VCard
+    status = nextContentLine(tokenizer, &line);
+    if (status == TOKEN_ERROR) {
+        return INV_PROP;
+    }
+    if (status == TOKEN_END || viewCaseEquals(line.line, "BEGIN:VCARD") == false) {
+        return INV_CARD;
+    }
+
+    //Check second line of VCard
+    status = nextContentLine(tokenizer, &line);
+    if (status == TOKEN_ERROR) {
+        return INV_PROP;
+    }
+    if (status == TOKEN_END || viewCaseEquals(line.line, "VERSION:4.0") == false) {
+        return INV_CARD;
+    }
+
+    VCardErrorCode errorToReturn = OK;
+
+    /*  Parse errors end the card right away, like in parseCard. Validation errors are only recorded, so they can be
+        reported in the order validateCard would find them once the whole file has parsed
+    */
+    VCardErrorCode FNError = OK;
+    VCardErrorCode BDAYError = OK;
+    VCardErrorCode anniversaryError = OK;
+    VCardErrorCode propertyError = OK;
+
+    //Optional properties seen of each kind (See checkCardinality)
+    int occurrences[PROPERTY_KIND_COUNT] = { 0 };
+
+    bool FNSet = false;
+    bool BDAYSet = false;
+    bool anniversarySet = false;
+    while (true) {
+        status = nextContentLine(tokenizer, &line);
+
+        if (status == TOKEN_ERROR) {
+            errorToReturn = INV_PROP;
+            break;
+        }
+
+        //Card must end with END:VCARD
+        if (status == TOKEN_END) {
+            errorToReturn = INV_CARD;
+            break;
+        }
+
+        if (viewCaseEquals(line.line, "END:VCARD")) {
+            break;
+        }
+
+        //Error check line lengths (MUST not be more than 998 characters) - Folding keeps long values within the limit
+        if (line.longestPhysicalLine > 998) {
+            errorToReturn = INV_PROP;
+            break;
+        }
+
+        //Make sure the line isn't BEGIN/VERSION
+        if (viewCaseEquals(line.line, "BEGIN:VCARD")) {
+            unreadContentLine(tokenizer, &line);
+            errorToReturn = INV_PROP;
+            break;
+        }
+        if (viewCaseEquals(line.line, "VERSION:4.0")) {
+            errorToReturn = INV_PROP;
+            break;
+        }
+
+        if (splitContentLine(&line) != OK || line.name.length == 0 || line.values.length == 0) {
+            errorToReturn = INV_PROP;
+            break;
+        }
+
+        //Parameters are checked the same way as when they are added to a Property
+        if (line.hasParameters) {
+            StringView remaining = line.parameters;
+            StringView parameter;
+            bool validParameters = true;
+            while (nextViewSection(&remaining, ';', true, &parameter)) {
+                const char* equals = memchr(parameter.start, '=', parameter.length);
+                size_t nameLength = equals != NULL ? (size_t)(equals - parameter.start) : 0;
+                if (equals == NULL || nameLength == 0 || nameLength >= 200 || parameter.length - nameLength - 1 == 0) {
+                    validParameters = false;
+                    break;
+                }
+            }
+            if (validParameters == false) {
+                errorToReturn = INV_PROP;
+                break;
+            }
+        }
+
+        int valueCount = countPropertyValues(line.values);
+        PropertyKind kind = lookupPropertyKind(line.name);
+
+        if (kind == PROP_FN && FNSet == false) {
+            //Only the first value is shown
+            StringView values = line.values;
+            StringView firstValue;
+            nextValueSection(&values, &firstValue);
+            summary->fn = unescapeValue(firstValue, NULL);
+            FNSet = true;
+
+            if (checkValueCount(kind, valueCount) != OK) {
+                FNError = INV_PROP;
+            }
+            continue;
+        }
+
+        summary->propertyCount++;
+
+        if ((kind == PROP_BDAY && BDAYSet == false) || (kind == PROP_ANNIVERSARY && anniversarySet == false)) {
+            //Dates are rare enough to go through the full DateTime* path
+            Property* dateProperty = NULL;
+            createPropertyFromLine(&line, &dateProperty, NULL);
+            DateTime* newDate = parseDate(dateProperty);
+            deleteProperty(dateProperty);
+
+            bool validDate = validateDateTime(newDate);
+            VCardErrorCode dateError = errorCheckDateTime(newDate);
+            deleteDate(newDate);
+            if (validDate == false) {
+                errorToReturn = INV_PROP;
+                break;
+            }
+
+            if (kind == PROP_BDAY) {
+                BDAYSet = true;
+                BDAYError = dateError;
+            }
+            else {
+                anniversarySet = true;
+                anniversaryError = dateError;
+            }
+            continue;
+        }
+
+        //Everything else is an optional property - Checked like validateCard checks optionalProperties
+        if (propertyError != OK) {
+            continue;
+        }
+
+        propertyError = propertySpec(kind)->optionalPropertyError;
+        if (propertyError == OK) {
+            occurrences[kind]++;
+            propertyError = checkValueCount(kind, valueCount);
+        }
+    }
+
+    //Check if FN was set, if not, return INV_CARD
+    if (errorToReturn == OK && FNSet == false) {
+        errorToReturn = INV_CARD;
     }
 
-    //Make a copy of the fileName if it's not NULL
-    char* fileNameCopy = NULL;
-    if (fileName != NULL) {
-        //NOTE: REMEMBER TO FREE fileNameCopy
-        fileNameCopy = calloc(strlen(fileName) + 1, sizeof(char));
-        strcpy(fileNameCopy, fileName);
+    //Record validation errors in validateCard's order
+    if (FNError != OK) {
+        summary->validationError = FNError;
+    }
+    else if (BDAYError != OK) {
+        summary->validationError = BDAYError;
+    }
+    else if (anniversaryError != OK) {
+        summary->validationError = anniversaryError;
+    }
+    else if (propertyError != OK) {
+        summary->validationError = propertyError;
     }
     else {
-        errorToReturn = WRITE_ERROR;
-        return errorToReturn;
+        summary->validationError = checkCardinality(occurrences);
     }
 
-    //Check file name and extension
-    if (verifyFileName(fileNameCopy) == false) {
-        errorToReturn = WRITE_ERROR;
-        return errorToReturn;
+    if (errorToReturn != OK) {
+        free(summary->fn);
+        summary->fn = NULL;
+        summary->propertyCount = 0;
     }
 
-    free(fileNameCopy);
+    return errorToReturn;
+}
 
-    //Create file and open it in append mode (This will create a new file if one hasn't been created)
+/**
+ * Reads the cards of a multi-card file one at a time through a fixed window of the file
+ */
+struct vCardReader {
     FILE* file;
-    file = fopen(fileName, "w");
 
-    //Check if the file could open
-    if (file == NULL) {
-        //Error: File could not be opened
-        errorToReturn = WRITE_ERROR;
-        return errorToReturn;
-    }
+    //Window of the file the tokenizer walks
+    char* buffer;
+    size_t capacity;
 
-    //Print the initial headings that must be in a VCard
-    fprintf(file, "BEGIN:VCARD\r\nVERSION:4.0\r\n");
+    Tokenizer tokenizer;
+};
 
-    //Call writeProperty for FN
-    writeProperty(file, obj->fn);
+//Starting size of a reader's window. The window only grows if a single content line does not fit in half of it
+#define READER_BUFFER_SIZE 65536
 
-    //Call writeDateTime for Anniversary
-    if (obj->anniversary != NULL) {
-        writeDateTime(file, obj->anniversary, true, false);
+/**
+ * refillReader: Slides a reader's window forward over its file (Tokenizer refill function)
+ * @param tokenizer: Tokenizer* of the reader, refillContext is the VCardReader*
+ * @return bool: true if more bytes were read, false at the end of the file
+ */
+static bool refillReader(Tokenizer* tokenizer) {
+    VCardReader* reader = tokenizer->refillContext;
+    size_t kept = (size_t)(tokenizer->end - tokenizer->current);
+
+    //Move the unscanned bytes to the front of the window
+    if (tokenizer->current != reader->buffer) {
+        memmove(reader->buffer, tokenizer->current, kept);
     }
 
-    //Call writeDateTime for BDay
-    if (obj->birthday != NULL) {
-        writeDateTime(file, obj->birthday, false, true);
+    //Grow the window if a long (Or heavily folded) line fills most of it
+    if (kept * 2 > reader->capacity) {
+        reader->capacity *= 2;
+        reader->buffer = realloc(reader->buffer, reader->capacity);
     }
 
-    //Call writeProperty for all optional Property* structures
-    if (obj->optionalProperties->length > 0) {
-        Node* temp = obj->optionalProperties->head;
-        while (temp != NULL) {
-            Property* toWrite = (Property*)(temp->data);
-            writeProperty(file, toWrite);
-            temp = temp->next;
-        }
+    size_t bytesRead = fread(reader->buffer + kept, 1, reader->capacity - kept, reader->file);
+
+    tokenizer->current = reader->buffer;
+    tokenizer->end = reader->buffer + kept + bytesRead;
+
+    if (DEBUG)printf("refillReader: kept %zu bytes, read %zu bytes\n", kept, bytesRead);
+
+    return bytesRead > 0;
+}
+
+VCardErrorCode openVCardReader(const char* fileName, VCardReader** reader) {
+    *reader = NULL;
+
+    //Check file name and extension
+    if (fileName == NULL || verifyFileName((char*)fileName) == false) {
+        return INV_FILE;
     }
 
-    //Print remaining required line
-    fprintf(file, "END:VCARD");
+    FILE* file = fopen(fileName, "r");
+    if (file == NULL) {
+        return INV_FILE;
+    }
 
-    //Close file
-    fclose(file);
+    //NOTE: REMEMBER TO FREE newReader (closeVCardReader)
+    VCardReader* newReader = malloc(sizeof(VCardReader));
+    newReader->file = file;
+    newReader->capacity = READER_BUFFER_SIZE;
+    newReader->buffer = malloc(newReader->capacity);
 
-    //Return OK on successful write
-    errorToReturn = OK;
-    return errorToReturn;
+    //Start with an empty window - The first line scanned pulls in the first block of the file
+    initializeWritableTokenizer(&newReader->tokenizer, newReader->buffer, 0);
+    newReader->tokenizer.endOfInput = false;
+    newReader->tokenizer.refill = refillReader;
+    newReader->tokenizer.refillContext = newReader;
 
+    *reader = newReader;
+    return OK;
 }
 
-VCardErrorCode validateCard(const Card* obj) {
-    //Create error code to return
-    VCardErrorCode errorToReturn;
+VCardErrorCode nextCard(VCardReader* reader, Card** newCardObject) {
+    return nextCardWithOptions(reader, newCardObject, NULL);
+}
 
-    //Check if Card* object is NULL
-    if (obj == NULL) {
+VCardErrorCode nextCardWithOptions(VCardReader* reader, Card** newCardObject, const ParseOptions* options) {
+    *newCardObject = NULL;
+
+    if (reader == NULL) {
+        return OTHER_ERROR;
+    }
+
+    //No more cards in the file
+    if (hasMoreContent(&reader->tokenizer) == false) {
+        return OK;
+    }
+
+    VCardErrorCode errorToReturn = parseCard(&reader->tokenizer, newCardObject, options);
+
+    //Skip the rest of an invalid card so the next call starts at the following BEGIN:VCARD
+    if (errorToReturn != OK) {
+        ContentLine line;
+        TokenStatus status;
+        while ((status = nextContentLine(&reader->tokenizer, &line)) != TOKEN_END) {
+            if (status == TOKEN_LINE && viewCaseEquals(line.line, "BEGIN:VCARD")) {
+                unreadContentLine(&reader->tokenizer, &line);
+                break;
+            }
+        }
+    }
+
+    return errorToReturn;
+}
+
+void closeVCardReader(VCardReader* reader) {
+    if (reader == NULL) {
+        return;
+    }
+
+    fclose(reader->file);
+    clearTokenizer(&reader->tokenizer);
+    free(reader->buffer);
+    free(reader);
+}
+
+VCardErrorCode serializeCard(const Card* obj, char** out, size_t* length) {
+    *out = NULL;
+    *length = 0;
+
+    //Check if Card* object is NULL
+    if (obj == NULL || obj->optionalProperties == NULL) {
+        return WRITE_ERROR;
+    }
+
+    //Sized once up front, so a card is rendered without growing the buffer
+    StringBuilder text;
+    initializeStringBuilder(&text, estimateCardText(obj));
+    appendCardText(&text, obj);
+
+    *length = text.length;
+    //NOTE: REMEMBER TO FREE out IN CALLING FUNCTION
+    *out = builderFinish(&text);
+    return OK;
+}
+
+/**
+ * writeAll: Writes a whole buffer to a file descriptor, continuing after partial writes and interrupts
+ * @param fd: int File descriptor to write to
+ * @param buffer: const char* Bytes to write
+ * @param length: size_t Number of bytes
+ * @return bool: true if every byte was written, false on error
+ */
+static bool writeAll(int fd, const char* buffer, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, buffer, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        buffer += written;
+        length -= (size_t)(written);
+    }
+    return true;
+}
+
+/**
+ * writeCardToFile: Writes a card's text to an open file and closes it
+ * @param fd: int File descriptor to write to (Closed on return, even on error)
+ * @param obj: const Card* to write
+ * @param sync: bool Whether to fsync the file before closing it
+ * @return VCardErrorCode: OK if the whole card was written, WRITE_ERROR otherwise
+ */
+static VCardErrorCode writeCardToFile(int fd, const Card* obj, bool sync) {
+    //NOTE: REMEMBER TO FREE text
+    char* text = NULL;
+    size_t length = 0;
+    if (serializeCard(obj, &text, &length) != OK) {
+        close(fd);
+        return WRITE_ERROR;
+    }
+
+    bool written = writeAll(fd, text, length);
+    free(text);
+
+    if (written && sync && fsync(fd) != 0) {
+        written = false;
+    }
+
+    //close can report a failed write too
+    if (close(fd) != 0 || written == false) {
+        return WRITE_ERROR;
+    }
+    return OK;
+}
+
+/**
+ * createTempFile: Creates a hidden temporary file in the same directory as fileName (rename only works within one file system)
+ * The name has a fixed length, so it fits wherever fileName does. ex. "uploads/card.vcf" -> "uploads/.vcf.Xa12Bc"
+ * @param fileName: const char* File the temporary file will be renamed to
+ * @param tempName: char** to store the temporary file's name into (NULL on error). Must be freed by the caller
+ * @return int: File descriptor of the new file, -1 on error
+ */
+static int createTempFile(const char* fileName, char** tempName) {
+    const char* slash = strrchr(fileName, '/');
+    size_t directoryLength = slash != NULL ? (size_t)(slash - fileName) + 1 : 0;
+
+    //NOTE: REMEMBER TO FREE tempName
+    *tempName = malloc(directoryLength + sizeof(".vcf.XXXXXX"));
+    memcpy(*tempName, fileName, directoryLength);
+    strcpy(*tempName + directoryLength, ".vcf.XXXXXX");
+
+    int fd = mkstemp(*tempName);
+    if (fd == -1) {
+        free(*tempName);
+        *tempName = NULL;
+        return -1;
+    }
+
+    /*  mkstemp creates the file readable by its owner only. Replacing a file keeps its mode - A new file gets the mode
+        open would give it (0666 less the umask, which can only be read by setting it, so it is set straight back)
+    */
+    struct stat fileStats;
+    mode_t mode = 0;
+    if (stat(fileName, &fileStats) == 0) {
+        mode = fileStats.st_mode & 07777;
+    }
+    else {
+        mode_t mask = umask(0);
+        umask(mask);
+        mode = 0666 & ~mask;
+    }
+    fchmod(fd, mode);
+    return fd;
+}
+
+/**
+ * syncDirectory: fsyncs the directory holding a file, so a rename into it survives a crash
+ * @param fileName: const char* File in the directory
+ * @return bool: true on success, false on error
+ */
+static bool syncDirectory(const char* fileName) {
+    const char* slash = strrchr(fileName, '/');
+
+    //NOTE: REMEMBER TO FREE directory
+    char* directory = NULL;
+    if (slash == NULL) {
+        directory = malloc(2);
+        strcpy(directory, ".");
+    }
+    else {
+        size_t length = slash == fileName ? 1 : (size_t)(slash - fileName);
+        directory = malloc(length + 1);
+        memcpy(directory, fileName, length);
+        directory[length] = '\0';
+    }
+
+    int fd = open(directory, O_RDONLY | O_DIRECTORY);
+    free(directory);
+    if (fd == -1) {
+        return false;
+    }
+
+    bool synced = fsync(fd) == 0;
+    close(fd);
+    return synced;
+}
+
+/**
+ * sameDirectory: Checks if two files are in the same directory (Compares the paths, not the directories themselves)
+ * @param first: const char* File name
+ * @param second: const char* File name
+ * @return bool: true if the paths up to their last '/' are the same
+ */
+static bool sameDirectory(const char* first, const char* second) {
+    const char* firstSlash = strrchr(first, '/');
+    const char* secondSlash = strrchr(second, '/');
+    size_t firstLength = firstSlash != NULL ? (size_t)(firstSlash - first) : 0;
+    size_t secondLength = secondSlash != NULL ? (size_t)(secondSlash - second) : 0;
+
+    return firstLength == secondLength && strncmp(first, second, firstLength) == 0;
+}
+
+VCardErrorCode writeCard(const char* fileName, const Card* obj) {
+    return writeCardWithOptions(fileName, obj, NULL);
+}
+
+VCardErrorCode writeCardWithOptions(const char* fileName, const Card* obj, const WriteOptions* options) {
+    //Create error code to return
+    VCardErrorCode errorToReturn;
+
+    //Check file name and extension
+    if (fileName == NULL || verifyFileName((char*)fileName) == false) {
+        errorToReturn = WRITE_ERROR;
+        return errorToReturn;
+    }
+
+    //A batch of one card
+    if (options != NULL && options->atomic) {
+        errorToReturn = writeCards(&fileName, &obj, 1, options);
+        return errorToReturn;
+    }
+
+    //Check if Card* object is NULL - Nothing is created on disk for a card that can not be written
+    if (obj == NULL || obj->optionalProperties == NULL) {
+        errorToReturn = WRITE_ERROR;
+        return errorToReturn;
+    }
+
+    //Create the file (Or truncate it) and write the card in one call
+    int fd = open(fileName, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+        errorToReturn = WRITE_ERROR;
+        return errorToReturn;
+    }
+
+    errorToReturn = writeCardToFile(fd, obj, options != NULL && options->sync);
+    return errorToReturn;
+}
+
+VCardErrorCode writeCards(const char** fileNames, const Card** cards, int count, const WriteOptions* options) {
+    bool sync = options != NULL && options->sync;
+
+    if (fileNames == NULL || cards == NULL || count < 0) {
+        return WRITE_ERROR;
+    }
+    for (int i = 0; i < count; i++) {
+        if (fileNames[i] == NULL || verifyFileName((char*)fileNames[i]) == false) {
+            return WRITE_ERROR;
+        }
+    }
+
+    //Write every card to its temporary file
+    //NOTE: REMEMBER TO FREE tempNames (And every name in it)
+    char** tempNames = calloc(count > 0 ? (size_t)(count) : 1, sizeof(char*));
+    VCardErrorCode errorToReturn = OK;
+    for (int i = 0; i < count && errorToReturn == OK; i++) {
+        int fd = createTempFile(fileNames[i], &tempNames[i]);
+        if (fd == -1) {
+            errorToReturn = WRITE_ERROR;
+        }
+        else {
+            errorToReturn = writeCardToFile(fd, cards[i], sync);
+        }
+    }
+
+    //Only once they are all written are they renamed into place
+    int renamed = 0;
+    if (errorToReturn == OK) {
+        for (; renamed < count; renamed++) {
+            if (rename(tempNames[renamed], fileNames[renamed]) != 0) {
+                errorToReturn = WRITE_ERROR;
+                break;
+            }
+            free(tempNames[renamed]);
+            tempNames[renamed] = NULL;
+        }
+    }
+
+    //Remove the temporary files that were not renamed
+    for (int i = 0; i < count; i++) {
+        if (tempNames[i] != NULL) {
+            unlink(tempNames[i]);
+            free(tempNames[i]);
+        }
+    }
+    free(tempNames);
+
+    //One fsync per directory makes every rename into it durable (Cards are usually written to the same directory)
+    if (sync) {
+        for (int i = 0; i < renamed; i++) {
+            bool synced = false;
+            for (int j = 0; j < i && synced == false; j++) {
+                synced = sameDirectory(fileNames[i], fileNames[j]);
+            }
+            if (synced == false && syncDirectory(fileNames[i]) == false && errorToReturn == OK) {
+                errorToReturn = WRITE_ERROR;
+            }
+        }
+    }
+
+    if(DEBUG)printf("writeCards: %d of %d cards written\n", renamed, count);
+
+    return errorToReturn;
+}
+
+struct vCardWriter {
+    int fd;
+
+    //Cards are rendered here, and written out once it holds WRITER_BUFFER_SIZE bytes
+    StringBuilder buffer;
+
+    //Set when a write fails - The file is incomplete from then on
+    bool failed;
+
+    //fsync the file (And with tempName, its directory) when the writer is closed
+    bool sync;
+
+    //Destination of the cards, and the temporary file they are written to until then (NULL unless atomic)
+    char* fileName;
+    char* tempName;
+};
+
+//Bytes of rendered cards a writer collects before writing them out
+#define WRITER_BUFFER_SIZE (1 << 20)
+
+/**
+ * flushWriter: Writes out the cards a writer has collected
+ * @param writer: VCardWriter* to flush
+ * @return bool: true on success, false if the write failed (The writer is marked as failed)
+ */
+static bool flushWriter(VCardWriter* writer) {
+    if (writer->failed == false && writeAll(writer->fd, writer->buffer.buffer, writer->buffer.length) == false) {
+        writer->failed = true;
+    }
+
+    //The buffer is reused for the next cards
+    writer->buffer.length = 0;
+    writer->buffer.buffer[0] = '\0';
+    return writer->failed == false;
+}
+
+VCardErrorCode openVCardWriter(const char* fileName, const WriteOptions* options, VCardWriter** writer) {
+    *writer = NULL;
+
+    //Check file name and extension
+    if (fileName == NULL || verifyFileName((char*)fileName) == false) {
+        return WRITE_ERROR;
+    }
+
+    char* tempName = NULL;
+    int fd = -1;
+    if (options != NULL && options->atomic) {
+        fd = createTempFile(fileName, &tempName);
+    }
+    else {
+        fd = open(fileName, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+    if (fd == -1) {
+        return WRITE_ERROR;
+    }
+
+    //NOTE: REMEMBER TO FREE newWriter (closeVCardWriter)
+    VCardWriter* newWriter = malloc(sizeof(VCardWriter));
+    newWriter->fd = fd;
+    initializeStringBuilder(&newWriter->buffer, WRITER_BUFFER_SIZE);
+    newWriter->failed = false;
+    newWriter->sync = options != NULL && options->sync;
+    newWriter->fileName = malloc(strlen(fileName) + 1);
+    strcpy(newWriter->fileName, fileName);
+    newWriter->tempName = tempName;
+
+    *writer = newWriter;
+    return OK;
+}
+
+VCardErrorCode appendCard(VCardWriter* writer, const Card* obj) {
+    if (writer == NULL || writer->failed) {
+        return WRITE_ERROR;
+    }
+
+    //Check if Card* object is NULL - Nothing is added to the file
+    if (obj == NULL || obj->optionalProperties == NULL) {
+        return WRITE_ERROR;
+    }
+
+    builderReserve(&writer->buffer, estimateCardText(obj));
+    appendCardText(&writer->buffer, obj);
+
+    if (writer->buffer.length >= WRITER_BUFFER_SIZE && flushWriter(writer) == false) {
+        return WRITE_ERROR;
+    }
+    return OK;
+}
+
+VCardErrorCode closeVCardWriter(VCardWriter* writer) {
+    if (writer == NULL) {
+        return WRITE_ERROR;
+    }
+
+    //Write out the last cards
+    flushWriter(writer);
+    if (writer->failed == false && writer->sync && fsync(writer->fd) != 0) {
+        writer->failed = true;
+    }
+    if (close(writer->fd) != 0) {
+        writer->failed = true;
+    }
+
+    //Replace the destination with the finished file, or throw the unfinished one away
+    if (writer->tempName != NULL) {
+        if (writer->failed == false && rename(writer->tempName, writer->fileName) == 0) {
+            if (writer->sync && syncDirectory(writer->fileName) == false) {
+                writer->failed = true;
+            }
+        }
+        else {
+            unlink(writer->tempName);
+            writer->failed = true;
+        }
+    }
+
+    VCardErrorCode errorToReturn = writer->failed ? WRITE_ERROR : OK;
+
+    clearStringBuilder(&writer->buffer);
+    free(writer->fileName);
+    free(writer->tempName);
+    free(writer);
+    return errorToReturn;
+}
+
+VCardErrorCode validateCard(const Card* obj) {
+    //Create error code to return
+    VCardErrorCode errorToReturn;
+
+    //Check if Card* object is NULL
+    if (obj == NULL) {
+        errorToReturn = INV_CARD;
+        return errorToReturn;
+    }
+    if (obj->fn == NULL) {
         errorToReturn = INV_CARD;
         return errorToReturn;
     }
-    if (obj->fn == NULL) {
-        errorToReturn = INV_CARD;
-        return errorToReturn;
+    if (obj->optionalProperties == NULL) {
+        errorToReturn = INV_CARD;
+        return errorToReturn;
+    }
+
+    //Number of optional properties of each kind, checked against the cardinality in the property spec table
+    int occurrences[PROPERTY_KIND_COUNT] = { 0 };
+
+    //Begin validation
+    //Verify obj->fn name/value constraints
+    if (errorCheckProperty(obj->fn) == INV_PROP) {
+        errorToReturn = INV_PROP;
+        return errorToReturn;
+    }
+    if (checkPropertyValueCount(obj->fn) == INV_PROP) {
+        errorToReturn = INV_PROP;
+        return errorToReturn;
+    }
+    if (propertyKind(obj->fn) != PROP_FN) {
+        errorToReturn = INV_PROP;
+        return errorToReturn;
+    }
+
+    //Verify obj->birthday
+    if (obj->birthday != NULL) {
+        DateTime* birthday = obj->birthday;
+        if (errorCheckDateTime(birthday) == INV_DT) {
+            errorToReturn = INV_DT;
+            return errorToReturn;
+        }
+    }
+
+    //Verify obj->anniversary
+    if (obj->anniversary != NULL) {
+        DateTime* anniversary = obj->anniversary;
+        if (errorCheckDateTime(anniversary) == INV_DT) {
+            errorToReturn = INV_DT;
+            return errorToReturn;
+        }
+    }
+
+    //Go through each optional Property* and verify the name && value count (Count each kind for cardinality validation)
+    if (obj->optionalProperties->length > 0) {
+        VectorIterator iter = createVectorIterator(&obj->optionalProperties->elements);
+        Property* tempProperty = NULL;
+        while ((tempProperty = nextVectorElement(&iter)) != NULL) {
+
+            //Validate property, its name and its value count
+            const char* reason = NULL;
+            errorToReturn = validateOptionalProperty(tempProperty, occurrences, &reason);
+            if (errorToReturn != OK) {
+                return errorToReturn;
+            }
+        }
+    }
+
+    //Check all counters to validate cardinality constraints
+    errorToReturn = checkCardinality(occurrences);
+    return errorToReturn;
+}
+
+void deleteCard(Card* obj) {
+    //Arena cards are freed all at once, the card itself included
+    if (obj != NULL && obj->optionalProperties != NULL && obj->optionalProperties->arena != NULL) {
+        releaseArena(obj->optionalProperties->arena);
+        return;
+    }
+
+    //Check if passed in Card* is NULL
+    if (obj != NULL) {
+        //Free fn Property* structure (FN Property* isn't allowed to be NULL
+        if (obj->fn != NULL) {
+            deleteProperty(obj->fn);
+        }
+
+        //Free birthday DateTime* structure
+        if (obj->birthday != NULL) {
+            deleteDate(obj->birthday);
+        }
+
+        //Free anniversary DateTime* structure
+        if (obj->anniversary != NULL) {
+            deleteDate(obj->anniversary);
+        }
+
+        //Free optionalProperties list* data structure
+        if (obj->optionalProperties != NULL) {
+            freeList(obj->optionalProperties);
+        }
+
+        //Free Card* structure
+        free(obj);
+    }
+}
+
+/**
+ * appendJSONString: Appends a string to a JSON document as a quoted, escaped JSON string
+ * @param json: StringBuilder* to append to
+ * @param string: const char* String to append (NULL is written as an empty string)
+ */
+static void appendJSONString(StringBuilder* json, const char* string) {
+    builderAppendChar(json, '"');
+    builderAppendEscaped(json, string);
+    builderAppendChar(json, '"');
+}
+
+/**
+ * strListJSONLength: Estimates the length of a list of strings' JSON array (Exact unless characters need escaping)
+ * @param strList: const List* of strings
+ * @return size_t: Number of bytes the JSON array takes up
+ */
+static size_t strListJSONLength(const List* strList) {
+    size_t stringCount = vectorLength(&strList->elements);
+    size_t length = 2;
+    for (size_t i = 0; i < stringCount; i++) {
+        const char* currentData = vectorGet(&strList->elements, i);
+        length += (currentData != NULL ? strlen(currentData) : 0) + 3;
+    }
+    return length;
+}
+
+/**
+ * propJSONLength: Estimates the length of a property's JSON object (Exact unless characters need escaping)
+ * @param prop: const Property* to measure
+ * @return size_t: Number of bytes the JSON object takes up
+ */
+static size_t propJSONLength(const Property* prop) {
+    size_t length = 32 + strListJSONLength(prop->values);
+    length += prop->group != NULL ? strlen(prop->group) : 0;
+    length += prop->name != NULL ? strlen(prop->name) : 0;
+    return length;
+}
+
+/**
+ * dtJSONLength: Estimates the length of a DateTime's JSON object (Exact unless characters need escaping)
+ * @param prop: const DateTime* to measure
+ * @return size_t: Number of bytes the JSON object takes up
+ */
+static size_t dtJSONLength(const DateTime* prop) {
+    return 64 + strlen(prop->date) + strlen(prop->time) + strlen(prop->text);
+}
+
+/**
+ * appendStrListJSON: Appends the JSON array of a list of strings to a string
+ * @param json: StringBuilder* to append to
+ * @param strList: const List* of strings to convert
+ */
+static void appendStrListJSON(StringBuilder* json, const List* strList) {
+    builderAppendChar(json, '[');
+
+    size_t stringCount = vectorLength(&strList->elements);
+    for (size_t i = 0; i < stringCount; i++) {
+        if (i > 0) {
+            builderAppendChar(json, ',');
+        }
+        appendJSONString(json, (char*)(vectorGet(&strList->elements, i)));
+    }
+
+    builderAppendChar(json, ']');
+}
+
+/**
+ * appendPropJSON: Appends the JSON object of a property to a string (See propToJSON)
+ * @param json: StringBuilder* to append to
+ * @param prop: const Property* to convert
+ */
+static void appendPropJSON(StringBuilder* json, const Property* prop) {
+    builderAppend(json, "{\"group\":");
+    appendJSONString(json, prop->group);
+
+    if (prop->name != NULL) {
+        builderAppend(json, ",\"name\":");
+        appendJSONString(json, prop->name);
+    }
+
+    if (prop->values->length > 0) {
+        builderAppend(json, ",\"values\":");
+        appendStrListJSON(json, prop->values);
+    }
+
+    builderAppendChar(json, '}');
+}
+
+/**
+ * appendDTJSON: Appends the JSON object of a DateTime to a string (See dtToJSON)
+ * @param json: StringBuilder* to append to
+ * @param prop: const DateTime* to convert
+ */
+static void appendDTJSON(StringBuilder* json, const DateTime* prop) {
+    builderAppend(json, prop->isText ? "{\"isText\":true," : "{\"isText\":false,");
+
+    builderAppend(json, "\"date\":");
+    appendJSONString(json, prop->date);
+
+    builderAppend(json, ",\"time\":");
+    appendJSONString(json, prop->time);
+
+    builderAppend(json, ",\"text\":");
+    appendJSONString(json, prop->text);
+
+    builderAppend(json, prop->UTC ? ",\"isUTC\":true}" : ",\"isUTC\":false}");
+}
+
+char* strListToJSON(const List* strList) {
+    //Check if list is NULL
+    if (strList == NULL) {
+        return NULL;
+    }
+
+    StringBuilder json;
+    initializeStringBuilder(&json, strListJSONLength(strList));
+    appendStrListJSON(&json, strList);
+
+    //NOTE: REMEMBER TO FREE toReturn IN CALLING FUNCTION
+    char* toReturn = builderFinish(&json);
+    return toReturn;
+}
+
+/**
+ * What an open JSON object or array describes while importing
+ */
+typedef enum jsonImportFrame { IMPORT_CARD, IMPORT_PROPERTY, IMPORT_DATE, IMPORT_STRINGS, IMPORT_PROPERTIES } JSONImportFrame;
+
+/**
+ * Member of the current object whose value comes next
+ */
+typedef enum jsonImportField {
+    FIELD_NONE, FIELD_UNKNOWN,
+    FIELD_GROUP, FIELD_NAME, FIELD_VALUES,
+    FIELD_IS_TEXT, FIELD_DATE, FIELD_TIME, FIELD_TEXT, FIELD_IS_UTC,
+    FIELD_FN, FIELD_BIRTHDAY, FIELD_ANNIVERSARY, FIELD_OPTIONAL_PROPERTIES
+} JSONImportField;
+
+//Card -> optionalProperties -> Property -> values is as deep as an import goes
+#define JSON_IMPORT_MAX_FRAMES 4
+
+/**
+ * State of a JSON import - The JSON reader's callbacks build the structs straight from the document
+ */
+typedef struct jsonImport {
+    //Open objects/arrays, the first one is what is being imported
+    JSONImportFrame frames[JSON_IMPORT_MAX_FRAMES];
+    int depth;
+
+    //Number of open objects/arrays inside a member that is being ignored
+    int skipDepth;
+
+    JSONImportField field;
+
+    //Structs being built. property and dateTime are only set until they are attached to card
+    Card* card;
+    Property* property;
+    DateTime* dateTime;
+    List* strings;
+
+    //Where a nested DateTime goes once it is complete
+    DateTime** dateTarget;
+
+    //DateTime members collected until the DateTime can be sized
+    bool isText;
+    bool UTC;
+    char date[9];
+    char time[7];
+    StringBuilder text;
+} JSONImport;
+
+/**
+ * importKeyEquals: Checks an object member's name, ignoring case
+ * @param key: const char* Unescaped member name (Not NUL terminated)
+ * @param length: size_t Length of the member name
+ * @param name: const char* Name to compare to
+ * @return bool: true if the names match
+ */
+static bool importKeyEquals(const char* key, size_t length, const char* name) {
+    StringView view = { key, length };
+    return viewCaseEquals(view, name);
+}
+
+/**
+ * importCopy: Copies an unescaped JSON string into a new NUL terminated string
+ * @param value: const char* String to copy (Not NUL terminated)
+ * @param length: size_t Length of the string
+ * @return char*: A dynamically created copy of the string
+ */
+static char* importCopy(const char* value, size_t length) {
+    StringView view = { value, length };
+    return viewToString(view);
+}
+
+/**
+ * importBeginProperty: Starts filling a new Property
+ * @param import: JSONImport* importing the Property
+ */
+static void importBeginProperty(JSONImport* import) {
+    import->property = createProperty(NULL);
+}
+
+/**
+ * importEndProperty: Fills in the members a JSON property left out. Nested properties are added to the card
+ * @param import: JSONImport* importing the Property
+ * @return bool: false if the card already has an FN
+ */
+static bool importEndProperty(JSONImport* import) {
+    Property* property = import->property;
+    if (property->group == NULL) {
+        property->group = calloc(1, sizeof(char));
+    }
+    if (property->name == NULL) {
+        property->name = calloc(1, sizeof(char));
+    }
+    property->kind = propertyKind(property);
+
+    //A root Property is handed to the caller as is
+    if (import->depth == 1) {
+        return true;
+    }
+
+    if (import->frames[import->depth - 2] == IMPORT_PROPERTIES) {
+        insertBack(import->card->optionalProperties, property);
+    }
+    else {
+        if (import->card->fn != NULL) {
+            return false;
+        }
+        import->card->fn = property;
+    }
+
+    import->property = NULL;
+    return true;
+}
+
+/**
+ * importBeginDate: Starts collecting the members of a new DateTime
+ * @param import: JSONImport* importing the DateTime
+ */
+static void importBeginDate(JSONImport* import) {
+    import->isText = false;
+    import->UTC = false;
+    import->date[0] = '\0';
+    import->time[0] = '\0';
+    import->text.length = 0;
+    import->text.buffer[0] = '\0';
+}
+
+/**
+ * importEndDate: Creates the DateTime from the collected members. Nested dates are added to the card
+ * @param import: JSONImport* importing the DateTime
+ * @return bool: false if the card already has that date
+ */
+static bool importEndDate(JSONImport* import) {
+    DateTime* newDate = createDateTime((int)(import->text.length) + 1, NULL);
+    newDate->isText = import->isText;
+    newDate->UTC = import->UTC;
+    strcpy(newDate->date, import->date);
+    strcpy(newDate->time, import->time);
+    strcpy(newDate->text, import->text.buffer);
+
+    if (import->depth == 1) {
+        import->dateTime = newDate;
+        return true;
+    }
+
+    if (*import->dateTarget != NULL) {
+        deleteDate(newDate);
+        return false;
+    }
+    *import->dateTarget = newDate;
+    return true;
+}
+
+/**
+ * importSkipValue: Checks if a value belongs to a member that is being ignored
+ * @param import: JSONImport* to check
+ * @param container: int 1 if the value opens an object/array, -1 if it closes one, 0 otherwise
+ * @return bool: true if the value must be ignored
+ */
+static bool importSkipValue(JSONImport* import, int container) {
+    if (import->skipDepth > 0) {
+        import->skipDepth += container;
+        return true;
+    }
+
+    //Unknown members are ignored, along with everything nested in them
+    if (import->field == FIELD_UNKNOWN) {
+        if (container > 0) {
+            import->skipDepth = 1;
+        }
+        import->field = FIELD_NONE;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * importPush: Opens a new object/array frame
+ * @param import: JSONImport* importing the document
+ * @param frame: JSONImportFrame What the object/array describes
+ * @return bool: false if the document nests deeper than any import can
+ */
+static bool importPush(JSONImport* import, JSONImportFrame frame) {
+    if (import->depth == JSON_IMPORT_MAX_FRAMES) {
+        return false;
+    }
+    import->frames[import->depth++] = frame;
+    import->field = FIELD_NONE;
+    return true;
+}
+
+static bool importStartObject(void* context) {
+    JSONImport* import = context;
+    if (importSkipValue(import, 1)) {
+        return true;
+    }
+
+    //The root object is what the caller asked for
+    if (import->depth == 0) {
+        JSONImportFrame root = import->frames[0];
+        if (root == IMPORT_PROPERTY) {
+            importBeginProperty(import);
+        }
+        else if (root == IMPORT_DATE) {
+            importBeginDate(import);
+        }
+        else if (root == IMPORT_CARD) {
+            import->card = initializeCard(NULL);
+        }
+        else {
+            return false;
+        }
+        return importPush(import, root);
+    }
+
+    JSONImportFrame parent = import->frames[import->depth - 1];
+    if (parent == IMPORT_PROPERTIES || (parent == IMPORT_CARD && import->field == FIELD_FN)) {
+        importBeginProperty(import);
+        return importPush(import, IMPORT_PROPERTY);
     }
-    if (obj->optionalProperties == NULL) {
-        errorToReturn = INV_CARD;
-        return errorToReturn;
+    if (parent == IMPORT_CARD && (import->field == FIELD_BIRTHDAY || import->field == FIELD_ANNIVERSARY)) {
+        import->dateTarget = import->field == FIELD_BIRTHDAY ? &import->card->birthday : &import->card->anniversary;
+        importBeginDate(import);
+        return importPush(import, IMPORT_DATE);
     }
 
-    //Create a list of valid properties
-    //NOTE: REMEMBER TO FREE validProperties
-    List* validProperties = initializeList(printValue, deleteValue, compareValues);
-    populatePropertyList(validProperties);
-
-    //Initialize counters for Property* cardinality
-    //KIND MAY only appear once
-    int KINDCounter = 0;
-    //N MAY only appear once
-    int NCounter = 0;
-    //GENDER MAY only appear once
-    int GENDERCounter = 0;
-    //PRODID MAY only appear once
-    int PRODIDCounter = 0;
-    //REV MAY only appear once
-    int REVCounter = 0;
-    //UID MAY only appear once
-    int UIDCounter = 0;
+    return false;
+}
 
-    //Begin validation
-    //Verify obj->fn name/value constraints
-    if (errorCheckProperty(obj->fn) == INV_PROP) {
-        freeList(validProperties);
-        errorToReturn = INV_PROP;
-        return errorToReturn;
+static bool importEndObject(void* context) {
+    JSONImport* import = context;
+    if (importSkipValue(import, -1)) {
+        return true;
     }
-    if (checkPropertyValueCount(obj->fn) == INV_PROP) {
-        freeList(validProperties);
-        errorToReturn = INV_PROP;
-        return errorToReturn;
+
+    bool accepted = true;
+    JSONImportFrame frame = import->frames[import->depth - 1];
+    if (frame == IMPORT_PROPERTY) {
+        accepted = importEndProperty(import);
     }
-    if (stringCaseCompare(obj->fn->name, "FN") != 0) {
-        freeList(validProperties);
-        errorToReturn = INV_PROP;
-        return errorToReturn;
+    else if (frame == IMPORT_DATE) {
+        accepted = importEndDate(import);
     }
 
-    //Verify obj->birthday
-    if (obj->birthday != NULL) {
-        DateTime* birthday = obj->birthday;
-        if (errorCheckDateTime(birthday) == INV_DT) {
-            freeList(validProperties);
-            errorToReturn = INV_DT;
-            return errorToReturn;
-        }
-    }
+    import->depth--;
+    import->field = FIELD_NONE;
+    return accepted;
+}
 
-    //Verify obj->anniversary
-    if (obj->anniversary != NULL) {
-        DateTime* anniversary = obj->anniversary;
-        if (errorCheckDateTime(anniversary) == INV_DT) {
-            freeList(validProperties);
-            errorToReturn = INV_DT;
-            return errorToReturn;
-        }
+static bool importStartArray(void* context) {
+    JSONImport* import = context;
+    if (importSkipValue(import, 1)) {
+        return true;
     }
 
-    //Go through each optional Property* and verify the name && value count (Increment counters if name is flagged)
-    if (obj->optionalProperties->length > 0) {
-        Node* temp = obj->optionalProperties->head;
-        while (temp) {
-            Property* tempProperty = (Property*)(temp->data);
+    if (import->depth == 0) {
+        return import->frames[0] == IMPORT_STRINGS && importPush(import, IMPORT_STRINGS);
+    }
 
-            //Validate property
-            if (errorCheckProperty(tempProperty) == INV_PROP) {
-                freeList(validProperties);
-                errorToReturn = INV_PROP;
-                return errorToReturn;
-            }
+    JSONImportFrame parent = import->frames[import->depth - 1];
+    if (parent == IMPORT_PROPERTY && import->field == FIELD_VALUES) {
+        import->strings = import->property->values;
+        return importPush(import, IMPORT_STRINGS);
+    }
+    if (parent == IMPORT_CARD && import->field == FIELD_OPTIONAL_PROPERTIES) {
+        return importPush(import, IMPORT_PROPERTIES);
+    }
 
-            //Validate property name
-            if (stringCaseCompare(tempProperty->name, "VERSION") == 0 || stringCaseCompare(tempProperty->name, "BEGIN") == 0 || stringCaseCompare(tempProperty->name, "END") == 0) {
-                freeList(validProperties);
-                errorToReturn = INV_CARD;
-                return errorToReturn;
-            }
+    return false;
+}
 
-            if (stringCaseCompare(tempProperty->name, "BDAY") == 0 || stringCaseCompare(tempProperty->name, "ANNIVERSARY") == 0) {
-                freeList(validProperties);
-                errorToReturn = INV_DT;
-                return errorToReturn;
-            }
+static bool importEndArray(void* context) {
+    JSONImport* import = context;
+    if (importSkipValue(import, -1)) {
+        return true;
+    }
 
-            if (listPropertyNameSearch(validProperties, tempProperty->name) == false) {
-                freeList(validProperties);
-                errorToReturn = INV_PROP;
-                return errorToReturn;
-            }
+    import->depth--;
+    import->field = FIELD_NONE;
+    return true;
+}
 
-            //Check if the name needs to be incremented for cardinality validation purposes
-            if (stringCaseCompare(tempProperty->name, "KIND") == 0) {
-                KINDCounter++;
-            }
-            if (stringCaseCompare(tempProperty->name, "N") == 0) {
-                NCounter++;
-            }
-            if (stringCaseCompare(tempProperty->name, "GENDER") == 0) {
-                GENDERCounter++;
-            }
-            if (stringCaseCompare(tempProperty->name, "PRODID") == 0) {
-                PRODIDCounter++;
-            }
-            if (stringCaseCompare(tempProperty->name, "REV") == 0) {
-                REVCounter++;
-            }
-            if (stringCaseCompare(tempProperty->name, "UID") == 0) {
-                UIDCounter++;
-            }
+static bool importKey(void* context, const char* key, size_t length) {
+    JSONImport* import = context;
+    if (import->skipDepth > 0) {
+        return true;
+    }
 
-            //Validate property value count
-            if (checkPropertyValueCount(tempProperty) == INV_PROP) {
-                freeList(validProperties);
-                errorToReturn = INV_PROP;
-                return errorToReturn;
-            }
+    JSONImportFrame frame = import->frames[import->depth - 1];
+    import->field = FIELD_UNKNOWN;
 
-            temp = temp->next;
+    if (frame == IMPORT_PROPERTY) {
+        if (importKeyEquals(key, length, "group")) {
+            import->field = FIELD_GROUP;
+        }
+        else if (importKeyEquals(key, length, "name")) {
+            import->field = FIELD_NAME;
+        }
+        else if (importKeyEquals(key, length, "values")) {
+            import->field = FIELD_VALUES;
         }
     }
-
-    //Check all flagged counters to validate cardinality constraints
-    if (KINDCounter > 1) {
-        freeList(validProperties);
-        errorToReturn = INV_PROP;
-        return errorToReturn;
+    else if (frame == IMPORT_DATE) {
+        if (importKeyEquals(key, length, "isText")) {
+            import->field = FIELD_IS_TEXT;
+        }
+        else if (importKeyEquals(key, length, "date")) {
+            import->field = FIELD_DATE;
+        }
+        else if (importKeyEquals(key, length, "time")) {
+            import->field = FIELD_TIME;
+        }
+        else if (importKeyEquals(key, length, "text")) {
+            import->field = FIELD_TEXT;
+        }
+        else if (importKeyEquals(key, length, "isUTC")) {
+            import->field = FIELD_IS_UTC;
+        }
     }
-    if (NCounter > 1) {
-        freeList(validProperties);
-        errorToReturn = INV_PROP;
-        return errorToReturn;
+    else if (frame == IMPORT_CARD) {
+        if (importKeyEquals(key, length, "fn")) {
+            import->field = FIELD_FN;
+        }
+        else if (importKeyEquals(key, length, "birthday")) {
+            import->field = FIELD_BIRTHDAY;
+        }
+        else if (importKeyEquals(key, length, "anniversary")) {
+            import->field = FIELD_ANNIVERSARY;
+        }
+        else if (importKeyEquals(key, length, "optionalProperties")) {
+            import->field = FIELD_OPTIONAL_PROPERTIES;
+        }
     }
-    if (GENDERCounter > 1) {
-        freeList(validProperties);
-        errorToReturn = INV_PROP;
-        return errorToReturn;
+
+    return true;
+}
+
+static bool importBoolean(void* context, bool value) {
+    JSONImport* import = context;
+    if (importSkipValue(import, 0)) {
+        return true;
     }
-    if (PRODIDCounter > 1) {
-        freeList(validProperties);
-        errorToReturn = INV_PROP;
-        return errorToReturn;
+
+    if (import->field == FIELD_IS_TEXT) {
+        import->isText = value;
     }
-    if (REVCounter > 1) {
-        freeList(validProperties);
-        errorToReturn = INV_PROP;
-        return errorToReturn;
+    else if (import->field == FIELD_IS_UTC) {
+        import->UTC = value;
     }
-    if (UIDCounter > 1) {
-        freeList(validProperties);
-        errorToReturn = INV_PROP;
-        return errorToReturn;
+    else {
+        return false;
     }
 
-    //Free list and content
-    freeList(validProperties);
-
-    //Return OK
-    errorToReturn = OK;
-    return errorToReturn;
+    import->field = FIELD_NONE;
+    return true;
 }
 
-void deleteCard(Card* obj) {
-    //Check if passed in Card* is NULL
-    if (obj != NULL) {
-        //Free fn Property* structure (FN Property* isn't allowed to be NULL
-        if (obj->fn != NULL) {
-            deleteProperty(obj->fn);
-        }
-
-        //Free birthday DateTime* structure
-        if (obj->birthday != NULL) {
-            deleteDate(obj->birthday);
-        }
-
-        //Free anniversary DateTime* structure
-        if (obj->anniversary != NULL) {
-            deleteDate(obj->anniversary);
-        }
-
-        //Free optionalProperties list* data structure
-        if (obj->optionalProperties != NULL) {
-            if (obj->optionalProperties->length > 0) {
-                freeList(obj->optionalProperties);
+static bool importString(void* context, const char* value, size_t length) {
+    JSONImport* import = context;
+    if (importSkipValue(import, 0)) {
+        return true;
+    }
+
+    //Nothing is imported from a bare string
+    if (import->depth == 0) {
+        return false;
+    }
+
+    JSONImportFrame frame = import->frames[import->depth - 1];
+    if (frame == IMPORT_STRINGS) {
+        insertBack(import->strings, importCopy(value, length));
+        return true;
+    }
+
+    JSONImportField field = import->field;
+    import->field = FIELD_NONE;
+
+    switch (field) {
+        case FIELD_GROUP:
+            free(import->property->group);
+            import->property->group = importCopy(value, length);
+            return true;
+        case FIELD_NAME:
+            free(import->property->name);
+            import->property->name = importCopy(value, length);
+            return true;
+        case FIELD_IS_TEXT:
+            //Older exports quote their booleans
+            import->isText = importKeyEquals(value, length, "true");
+            return true;
+        case FIELD_IS_UTC:
+            import->UTC = importKeyEquals(value, length, "true");
+            return true;
+        case FIELD_DATE:
+            if (length >= sizeof(import->date)) {
+                return false;
             }
-            else {
-                free(obj->optionalProperties);
+            memcpy(import->date, value, length);
+            import->date[length] = '\0';
+            return true;
+        case FIELD_TIME:
+            if (length >= sizeof(import->time)) {
+                return false;
             }
+            memcpy(import->time, value, length);
+            import->time[length] = '\0';
+            return true;
+        case FIELD_TEXT:
+            import->text.length = 0;
+            builderAppendBytes(&import->text, value, length);
+            return true;
+        case FIELD_FN: {
+            //The FN only form ({"FN":"Simon Perreault"}) the card creation form sends
+            if (import->card->fn != NULL) {
+                return false;
+            }
+            Property* fn = createProperty(NULL);
+            fn->group = calloc(1, sizeof(char));
+            fn->name = importCopy("FN", 2);
+            fn->kind = PROP_FN;
+            insertBack(fn->values, importCopy(value, length));
+            import->card->fn = fn;
+            return true;
         }
-
-        //Free Card* structure
-        free(obj);
+        default:
+            return false;
     }
 }
 
-char* strListToJSON(const List* strList) {
-    //Check if list is NULL
-    if (strList == NULL) {
-        return NULL;
+static bool importNull(void* context) {
+    JSONImport* import = context;
+    if (importSkipValue(import, 0)) {
+        return true;
     }
 
-    char* toReturn = NULL;
-
-    if (strList->length == 0) {
-        toReturn = calloc(3, sizeof(char));
-	strcpy(toReturn, "[]");
-	return toReturn;
-    }
-
-    //Check length of list
-    if (strList->length > 0) {
-        Node* current = strList->head;
-        toReturn = calloc(2, sizeof(char));
-        strcpy(toReturn, "[");
-        while (current) {
-            //Add current->data to toReturn
-            int currentDataLength = 0;
-            if (current->data != NULL) {
-                currentDataLength = (int)(strlen(current->data));
-            }
+    //Missing dates are written as null
+    if (import->field == FIELD_BIRTHDAY || import->field == FIELD_ANNIVERSARY) {
+        import->field = FIELD_NONE;
+        return true;
+    }
 
-            toReturn = realloc(toReturn, strlen(toReturn) + currentDataLength + 4);
-            strcat(toReturn, "\"");
-            strcat(toReturn, current->data);
+    return false;
+}
 
-            if (current->next != NULL) {
-                strcat(toReturn, "\",");
-            }
-            else {
-                strcat(toReturn, "\"");
-            }
+static bool importNumber(void* context, const char* text, size_t length) {
+    //No imported member is a number
+    return importSkipValue(context, 0);
+}
 
-            current = current->next;
+/**
+ * importJSON: Imports a JSON document straight into the structs it describes, without building a document tree
+ * @param str: const char* JSON document
+ * @param root: JSONImportFrame What the document describes
+ * @param import: JSONImport* to import into (import->strings must be set for IMPORT_STRINGS)
+ * @return bool: true if the document was imported. On false, everything import owned has been freed
+ */
+static bool importJSON(const char* str, JSONImportFrame root, JSONImport* import) {
+    import->frames[0] = root;
+    import->depth = 0;
+    import->skipDepth = 0;
+    import->field = FIELD_NONE;
+    import->card = NULL;
+    import->property = NULL;
+    import->dateTime = NULL;
+    import->dateTarget = NULL;
+    initializeStringBuilder(&import->text, 0);
+
+    JSONHandler handler = {
+        .context = import,
+        .startObject = importStartObject,
+        .endObject = importEndObject,
+        .startArray = importStartArray,
+        .endArray = importEndArray,
+        .key = importKey,
+        .string = importString,
+        .number = importNumber,
+        .boolean = importBoolean,
+        .null = importNull
+    };
+
+    bool imported = readJSON(str, strlen(str), &handler);
+    clearStringBuilder(&import->text);
+
+    //A card is only complete once it has its FN
+    if (imported && root == IMPORT_CARD && import->card->fn == NULL) {
+        imported = false;
+    }
+
+    if (imported == false) {
+        if (import->property != NULL) {
+            deleteProperty(import->property);
         }
-        toReturn = realloc(toReturn, strlen(toReturn) + 2);
-        strcat(toReturn, "]");
+        if (import->card != NULL) {
+            deleteCard(import->card);
+        }
+        if (import->dateTime != NULL) {
+            deleteDate(import->dateTime);
+        }
+        import->property = NULL;
+        import->card = NULL;
+        import->dateTime = NULL;
     }
 
-    return toReturn;
+    return imported;
 }
 
 List* JSONtoStrList(const char* str) {
@@ -757,36 +1863,15 @@ List* JSONtoStrList(const char* str) {
         return NULL;
     }
 
-    //NOTE: REMEMBER TO FREE strCopyPointer
-    char* strCopy = calloc(strlen(str) + 1, sizeof(char));
-    strcpy(strCopy, str);
-    char* strCopyPointer = strCopy;
-
-    //Convert str into a List*
     List* toReturn = initializeList(printValue, deleteValue, compareValues);
-    int numberOfValues = numberOfCharacters(strCopy, '"');
-    numberOfValues = numberOfValues / 2;
 
-    strCopy = strtok(strCopy, "[]\"");
-    while (strCopy) {
-        if (strcmp(strCopy, ",") != 0) {
-            //Add to list
-            char* toAdd = calloc(strlen(strCopy) + 1, sizeof(char));
-            strcpy(toAdd, strCopy);
-            insertBack(toReturn, toAdd);
-        }
-        strCopy = strtok(NULL, "[]\"");
-    }
-
-    if (toReturn->length < numberOfValues) {
-        int currentLength = toReturn->length;
-        for (int i = currentLength; i < numberOfValues; i++) {
-            char* toAdd = calloc(1, sizeof(char));
-            insertBack(toReturn, toAdd);
-        }
+    JSONImport import;
+    import.strings = toReturn;
+    if (importJSON(str, IMPORT_STRINGS, &import) == false) {
+        freeList(toReturn);
+        return NULL;
     }
 
-    free(strCopyPointer);
     return toReturn;
 }
 
@@ -795,290 +1880,114 @@ char* propToJSON(const Property* prop) {
         return NULL;
     }
 
-    char* toReturn = NULL;
-    toReturn = calloc(11, sizeof(char));
-    strcpy(toReturn, "{\"group\":\"");
-
-    if (prop->group != NULL) {
-        int groupLength = (int)(strlen(prop->group));
-        toReturn = realloc(toReturn, strlen(toReturn) + groupLength + 2);
-        strcat(toReturn, prop->group);
-        strcat(toReturn, "\"");
-    }
-
-    if (prop->name != NULL) {
-        int nameLength = (int)(strlen(prop->name));
-        toReturn = realloc(toReturn, strlen(toReturn) + nameLength + 11);
-        strcat(toReturn, ",\"name\":\"");
-        strcat(toReturn, prop->name);
-        strcat(toReturn, "\"");
-    }
-
-    if (prop->values->length > 0) {
-        char* returnedValues = strListToJSON(prop->values);
-        int valuesLength = (int)(strlen(returnedValues));
-        toReturn = realloc(toReturn, strlen(toReturn) + valuesLength + 11);
-        strcat(toReturn, ",\"values\":");
-        strcat(toReturn, returnedValues);
-        free(returnedValues);
-    }
-
-    toReturn = realloc(toReturn, strlen(toReturn) + 2);
-    strcat(toReturn, "}");
+    StringBuilder json;
+    initializeStringBuilder(&json, propJSONLength(prop));
+    appendPropJSON(&json, prop);
 
+    //NOTE: REMEMBER TO FREE toReturn IN CALLING FUNCTION
+    char* toReturn = builderFinish(&json);
     return toReturn;
 }
 
 Property* JSONtoProp(const char* str) {
-    /*
-     * Algorithm:
-     * strtok on {}:,
-     * Check if section contains two "
-     * If it does and length of string is 2, it's an empty string to add
-     * Else remove all occurrences of " and check the value of section
-     * Add the section to the Property*
-     */
-
     if (str == NULL) {
         return NULL;
     }
 
-    //NOTE: REMEMBER TO FREE strCopyPointer
-    char* strCopy = calloc(strlen(str) + 1, sizeof(char));
-    strcpy(strCopy, str);
-    char* strCopyPointer = strCopy;
-
-    Property* toReturn = createProperty();
-
-    strCopy = strtok(strCopy, "{}:,");
-    while (strCopy) {
-        if (strcmp(strCopy, "\"group\"") == 0) {
-            strCopy = strtok(NULL, "{}:,");
-            //strCopy should be the group now unless empty
-            if (strCopy != NULL) {
-                if (numberOfCharacters(strCopy, '\"') == 2 && strlen(strCopy) == 2) {
-                    //Group is empty
-                    toReturn->group = calloc(1, sizeof(char));
-                    strcpy(toReturn->group, "");
-                }
-                else {
-                    removeChar(strCopy, '\"');
-                    toReturn->group = calloc(strlen(strCopy) + 1, sizeof(char));
-                    strcpy(toReturn->group, strCopy);
-                }
-            }
-        }
+    JSONImport import;
+    if (importJSON(str, IMPORT_PROPERTY, &import) == false) {
+        return NULL;
+    }
 
-        if (strcmp(strCopy, "\"name\"") == 0) {
-            strCopy = strtok(NULL, "{}:,");
-            if (strCopy != NULL) {
-                //Remove all quotation marks from string
-                removeChar(strCopy, '\"');
-                toReturn->name = calloc(strlen(strCopy) + 1, sizeof(char));
-                strcpy(toReturn->name, strCopy);
-            }
-        }
+    return import.property;
+}
 
-        if (strcmp(strCopy, "\"values\"") == 0) {
-            strCopy = strtok(NULL, "[]{}:,");
-            int numberOfValues = 0;
+char* dtToJSON(const DateTime* prop) {
+    if (prop == NULL) {
+        return NULL;
+    }
 
-            while(strCopy) {
-                //Can't strtok on , due to , being allowed in value
-                removeChar(strCopy, '\"');
-                if (strcmp(strCopy, ",") != 0) {
-                    char* valueToAdd = calloc(strlen(strCopy) + 1, sizeof(char));
-                    strcpy(valueToAdd, strCopy);
-                    insertBack(toReturn->values, valueToAdd);
-                    numberOfValues++;
-                }
-                else {
-                    //Empty value to add later
-                    numberOfValues++;
-                }
-                strCopy = strtok(NULL, "\"]}");
-            }
+    StringBuilder json;
+    initializeStringBuilder(&json, dtJSONLength(prop));
+    appendDTJSON(&json, prop);
 
-            for (int j = toReturn->values->length; j < numberOfValues - 1; j++) {
-                char* emptyValueToAdd = calloc(1, sizeof(char));
-                strcpy(emptyValueToAdd, "");
-                insertBack(toReturn->values, emptyValueToAdd);
-            }
-        }
+    //NOTE: REMEMBER TO FREE toReturn IN CALLING FUNCTION
+    char* toReturn = builderFinish(&json);
+    return toReturn;
+}
 
-        strCopy = strtok(NULL, "{}:,");
+DateTime* JSONtoDT(const char* str) {
+    if (str == NULL) {
+        return NULL;
     }
 
-    free(strCopyPointer);
-
-    if (toReturn->group == NULL) {
-        toReturn->group = calloc(1, sizeof(char));
-        strcpy(toReturn->group, "");
+    JSONImport import;
+    if (importJSON(str, IMPORT_DATE, &import) == false) {
+        return NULL;
     }
 
-    return toReturn;
+    return import.dateTime;
 }
 
-char* dtToJSON(const DateTime* prop) {
-    if (prop == NULL) {
+char* cardToJSON(const Card* obj) {
+    if (obj == NULL) {
         return NULL;
     }
 
-    char* toReturn = NULL;
-    toReturn = calloc(11, sizeof(char));
-    strcpy(toReturn, "{\"isText\":");
-
-    if (prop->isText == false) {
-        toReturn = realloc(toReturn, strlen(toReturn) + 8);
-        strcat(toReturn, "false,\"");
+    //Size the whole document up front so the card is written without growing the buffer
+    size_t length = 96;
+    if (obj->fn != NULL) {
+        length += propJSONLength(obj->fn);
     }
-    else {
-        toReturn = realloc(toReturn, strlen(toReturn) + 7);
-        strcat(toReturn, "true,\"");
+    if (obj->birthday != NULL) {
+        length += dtJSONLength(obj->birthday);
     }
-
-    if (prop->date[0] != '\0') {
-        toReturn = realloc(toReturn, strlen(toReturn) + 19);
-        strcat(toReturn, "date\":\"");
-        strcat(toReturn, prop->date);
-        strcat(toReturn, "\",");
+    if (obj->anniversary != NULL) {
+        length += dtJSONLength(obj->anniversary);
     }
-    else {
-        toReturn = realloc(toReturn, strlen(toReturn) + 10);
-        strcat(toReturn, "date\":\"\",");
+    size_t propertyCount = obj->optionalProperties != NULL ? vectorLength(&obj->optionalProperties->elements) : 0;
+    for (size_t i = 0; i < propertyCount; i++) {
+        length += propJSONLength(vectorGet(&obj->optionalProperties->elements, i)) + 1;
     }
 
-    if (prop->time[0] != '\0') {
-        toReturn = realloc(toReturn, strlen(toReturn) + 18);
-        strcat(toReturn, "\"time\":\"");
-        strcat(toReturn, prop->time);
-        strcat(toReturn, "\",");
+    StringBuilder json;
+    initializeStringBuilder(&json, length);
+
+    builderAppend(&json, "{\"fn\":");
+    if (obj->fn != NULL) {
+        appendPropJSON(&json, obj->fn);
     }
     else {
-        toReturn = realloc(toReturn, strlen(toReturn) + 11);
-        strcat(toReturn, "\"time\":\"\",");
+        builderAppend(&json, "null");
     }
 
-    if (prop->text[0] != '\0') {
-        int textLength = (int)(strlen(prop->text));
-        toReturn = realloc(toReturn, strlen(toReturn) + textLength + 11);
-        strcat(toReturn, "\"text\":\"");
-        strcat(toReturn, prop->text);
-        strcat(toReturn, "\",");
+    builderAppend(&json, ",\"birthday\":");
+    if (obj->birthday != NULL) {
+        appendDTJSON(&json, obj->birthday);
     }
     else {
-        toReturn = realloc(toReturn, strlen(toReturn) + 11);
-        strcat(toReturn, "\"text\":\"\",");
+        builderAppend(&json, "null");
     }
 
-    if (prop->UTC == false) {
-        toReturn = realloc(toReturn, strlen(toReturn) + 14);
-        strcat(toReturn, "\"isUTC\":false");
+    builderAppend(&json, ",\"anniversary\":");
+    if (obj->anniversary != NULL) {
+        appendDTJSON(&json, obj->anniversary);
     }
     else {
-        toReturn = realloc(toReturn, strlen(toReturn) + 13);
-        strcat(toReturn, "\"isUTC\":true");
-    }
-
-    toReturn = realloc(toReturn, strlen(toReturn) + 2);
-    strcat(toReturn, "}");
-
-    return toReturn;
-}
-
-DateTime* JSONtoDT(const char* str) {
-    if (str == NULL) {
-        return NULL;
+        builderAppend(&json, "null");
     }
 
-    //NOTE: REMEMBER TO FREE strCopyPointer
-    char* strCopy = calloc(strlen(str) + 1, sizeof(char));
-    strcpy(strCopy, str);
-    char* strCopyPointer = strCopy;
-
-    bool isText = false;
-    bool UTC = false;
-    //NOTE: REMEMBER TO FREE date, time, and text
-    char* date = calloc(1, sizeof(char));
-    strcpy(date, "");
-    char* time = calloc(1, sizeof(char));
-    strcpy(time, "");
-    char* text = calloc(1, sizeof(char));
-    strcpy(text, "");
-
-    strCopy = strtok(strCopy, "{}:,");
-    while (strCopy) {
-        if (strcmp(strCopy, "\"isText\"") == 0) {
-            strCopy = strtok(NULL, "{}:,");
-            //strCopy should be the group now unless empty
-            if (strCopy != NULL) {
-                if (strcmp(strCopy, "true") == 0 || strcmp(strCopy, "\"true\"") == 0) {
-                    isText = true;
-                }
-                else {
-                    isText = false;
-                }
-            }
-        }
-
-        if (strcmp(strCopy, "\"date\"") == 0) {
-            strCopy = strtok(NULL, "{}:,");
-            if (strCopy != NULL) {
-                //Remove all quotation marks from string
-                removeChar(strCopy, '\"');
-                date = realloc(date, strlen(strCopy) + 1);
-                strcpy(date, strCopy);
-            }
-        }
-
-        if (strcmp(strCopy, "\"time\"") == 0) {
-            strCopy = strtok(NULL, "{}:,");
-            if (strCopy != NULL) {
-                //Remove all quotation marks from string
-                removeChar(strCopy, '\"');
-                time = realloc(time, strlen(strCopy) + 1);
-                strcpy(time, strCopy);
-            }
-        }
-
-        if (strcmp(strCopy, "\"text\"") == 0) {
-            strCopy = strtok(NULL, "{}:,");
-            if (strCopy != NULL) {
-                //Remove all quotation marks from string
-                removeChar(strCopy, '\"');
-                text = realloc(text, strlen(strCopy) + 1);
-                strcpy(text, strCopy);
-            }
-        }
-
-        if (strcmp(strCopy, "\"isUTC\"") == 0) {
-            strCopy = strtok(NULL, "{}:,");
-            //strCopy should be the group now unless empty
-            if (strCopy != NULL) {
-                if (strcmp(strCopy, "true") == 0 || strcmp(strCopy, "\"true\"") == 0) {
-                    UTC = true;
-                }
-                else {
-                    UTC = false;
-                }
-            }
+    builderAppend(&json, ",\"optionalProperties\":[");
+    for (size_t i = 0; i < propertyCount; i++) {
+        if (i > 0) {
+            builderAppendChar(&json, ',');
         }
-
-        strCopy = strtok(NULL, "{}:,");
+        appendPropJSON(&json, vectorGet(&obj->optionalProperties->elements, i));
     }
+    builderAppend(&json, "]}");
 
-
-    DateTime* toReturn = createDateTime((int)(strlen(text)) + 1);
-    toReturn->UTC = UTC;
-    toReturn->isText = isText;
-    strcpy(toReturn->date, date);
-    strcpy(toReturn->time, time);
-    strcpy(toReturn->text, text);
-
-    free(date);
-    free(time);
-    free(text);
-    free(strCopyPointer);
+    //NOTE: REMEMBER TO FREE toReturn IN CALLING FUNCTION
+    char* toReturn = builderFinish(&json);
     return toReturn;
 }
 
@@ -1087,32 +1996,13 @@ Card* JSONtoCard(const char* str) {
         return NULL;
     }
 
-    //NOTE: REMEMBER TO FREE strCopyPointer
-    char* strCopy = calloc(strlen(str) + 1, sizeof(char));
-    strcpy(strCopy, str);
-    char* strCopyPointer = strCopy;
-
-    Card* toReturn = initializeCard();
-    toReturn->fn = createProperty();
-    toReturn->fn->group = calloc(1, sizeof(char));
-
-    strCopy = strtok(strCopy, "{}:\"");
-    if (strCopy != NULL) {
-        if (stringCaseCompare(strCopy, "FN") == 0) {
-            strCopy = strtok(NULL, "{}:\"");
-            if (strCopy != NULL) {
-                toReturn->fn->name = calloc(3, sizeof(char));
-                strcpy(toReturn->fn->name, "FN");
-
-                char* toAddFNValue = calloc(strlen(strCopy) + 1, sizeof(char));
-                strcpy(toAddFNValue, strCopy);
-                insertBack(toReturn->fn->values, toAddFNValue);
-            }
-        }
+    //Accepts both the cardToJSON format and the FN only form ({"FN":"Simon Perreault"})
+    JSONImport import;
+    if (importJSON(str, IMPORT_CARD, &import) == false) {
+        return NULL;
     }
 
-    free(strCopyPointer);
-    return toReturn;
+    return import.card;
 }
 
 void addProperty(Card* card, const Property* toBeAdded) {
@@ -1125,6 +2015,11 @@ void addProperty(Card* card, const Property* toBeAdded) {
     }
 
     insertBack(card->optionalProperties, (void*)(toBeAdded));
+
+    //The property was allocated by the caller, so an arena card has to free it on its own
+    if (card->optionalProperties->arena != NULL) {
+        arenaAddCleanup(card->optionalProperties->arena, deleteProperty, (void*)(toBeAdded));
+    }
 }
 
 char* printCard(const Card* obj) {
@@ -1229,6 +2124,12 @@ void deleteProperty(void* toBeDeleted) {
     if (toBeDeleted != NULL) {
         //Typecast toBeDeleted into Property structure
         Property* property = (Property*)(toBeDeleted);
+
+        //Arena properties are freed with their arena
+        if (property->values != NULL && property->values->arena != NULL) {
+            return;
+        }
+
         //Free inner structure strings
         free(property->name);
         free(property->group);
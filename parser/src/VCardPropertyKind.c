@@ -0,0 +1,180 @@
+/**
+ * @file VCardPropertyKind.c
+ * @brief This file contains the VCard file's property name lookup.
+ * @author ADD LATER
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include "VCardParser.h"
+#include "VCardTokenizer.h"
+#include "VCardPropertyKind.h"
+
+//CLIENTPIDMAP is the longest known name
+#define PROPERTY_NAME_MAX_LENGTH 12
+
+/*  What RFC 6350 (And this parser) allows for each kind of property. BEGIN/END/VERSION only frame the card, and
+    BDAY/ANNIVERSARY go into their own Card members, so finding them among the optional properties is an error.
+    N, GENDER and TEL use the structured value counts this parser splits on ';'
+*/
+static const PropertySpec propertySpecs[PROPERTY_KIND_COUNT] = {
+    //PROP_UNKNOWN - Any other name (Including x-names) is not allowed on a card
+    [PROP_UNKNOWN] = { NULL, CARDINALITY_ANY, 1, 1, INV_PROP },
+    [PROP_BEGIN] = { "BEGIN", CARDINALITY_ONE, 1, 1, INV_CARD },
+    [PROP_END] = { "END", CARDINALITY_ONE, 1, 1, INV_CARD },
+    [PROP_SOURCE] = { "SOURCE", CARDINALITY_ANY, 1, 1, OK },
+    [PROP_KIND] = { "KIND", CARDINALITY_AT_MOST_ONE, 1, 1, OK },
+    [PROP_XML] = { "XML", CARDINALITY_ANY, 1, 1, OK },
+    [PROP_FN] = { "FN", CARDINALITY_ONE_OR_MORE, 1, 1, OK },
+    [PROP_N] = { "N", CARDINALITY_AT_MOST_ONE, 5, 5, OK },
+    [PROP_NICKNAME] = { "NICKNAME", CARDINALITY_ANY, 1, 0, OK },
+    [PROP_PHOTO] = { "PHOTO", CARDINALITY_ANY, 1, 1, OK },
+    [PROP_BDAY] = { "BDAY", CARDINALITY_AT_MOST_ONE, 1, 1, INV_DT },
+    [PROP_ANNIVERSARY] = { "ANNIVERSARY", CARDINALITY_AT_MOST_ONE, 1, 1, INV_DT },
+    [PROP_GENDER] = { "GENDER", CARDINALITY_AT_MOST_ONE, 1, 2, OK },
+    [PROP_ADR] = { "ADR", CARDINALITY_ANY, 7, 7, OK },
+    [PROP_TEL] = { "TEL", CARDINALITY_ANY, 1, 2, OK },
+    [PROP_EMAIL] = { "EMAIL", CARDINALITY_ANY, 1, 1, OK },
+    [PROP_IMPP] = { "IMPP", CARDINALITY_ANY, 1, 1, OK },
+    [PROP_LANG] = { "LANG", CARDINALITY_ANY, 1, 1, OK },
+    [PROP_TZ] = { "TZ", CARDINALITY_ANY, 1, 1, OK },
+    [PROP_GEO] = { "GEO", CARDINALITY_ANY, 1, 1, OK },
+    [PROP_TITLE] = { "TITLE", CARDINALITY_ANY, 1, 1, OK },
+    [PROP_ROLE] = { "ROLE", CARDINALITY_ANY, 1, 1, OK },
+    [PROP_LOGO] = { "LOGO", CARDINALITY_ANY, 1, 1, OK },
+    [PROP_ORG] = { "ORG", CARDINALITY_ANY, 1, 0, OK },
+    [PROP_MEMBER] = { "MEMBER", CARDINALITY_ANY, 1, 1, OK },
+    [PROP_RELATED] = { "RELATED", CARDINALITY_ANY, 1, 1, OK },
+    [PROP_CATEGORIES] = { "CATEGORIES", CARDINALITY_ANY, 1, 0, OK },
+    [PROP_NOTE] = { "NOTE", CARDINALITY_ANY, 1, 1, OK },
+    [PROP_PRODID] = { "PRODID", CARDINALITY_AT_MOST_ONE, 1, 1, OK },
+    [PROP_REV] = { "REV", CARDINALITY_AT_MOST_ONE, 1, 1, OK },
+    [PROP_SOUND] = { "SOUND", CARDINALITY_ANY, 1, 1, OK },
+    [PROP_UID] = { "UID", CARDINALITY_AT_MOST_ONE, 1, 1, OK },
+    [PROP_CLIENTPIDMAP] = { "CLIENTPIDMAP", CARDINALITY_ANY, 2, 2, OK },
+    [PROP_URL] = { "URL", CARDINALITY_ANY, 1, 1, OK },
+    [PROP_VERSION] = { "VERSION", CARDINALITY_ONE, 1, 1, INV_CARD },
+    [PROP_KEY] = { "KEY", CARDINALITY_ANY, 1, 1, OK },
+    [PROP_FBURL] = { "FBURL", CARDINALITY_ANY, 1, 1, OK },
+    [PROP_CALADRURI] = { "CALADRURI", CARDINALITY_ANY, 1, 1, OK },
+    [PROP_CALURI] = { "CALURI", CARDINALITY_ANY, 1, 1, OK },
+};
+
+/*  propertyHash maps every RFC 6350 name to its own slot of propertyHashTable (A perfect hash). The multipliers
+    were found by searching for the first combination without collisions - Re-run the search if a name is added
+*/
+#define PROPERTY_HASH_SIZE 64
+
+//Empty slots are PROP_UNRESOLVED (0)
+static const PropertyKind propertyHashTable[PROPERTY_HASH_SIZE] = {
+    [0] = PROP_FBURL,
+    [3] = PROP_CALADRURI,
+    [4] = PROP_KEY,
+    [5] = PROP_GENDER,
+    [6] = PROP_ANNIVERSARY,
+    [7] = PROP_UID,
+    [8] = PROP_XML,
+    [9] = PROP_CATEGORIES,
+    [13] = PROP_N,
+    [15] = PROP_LANG,
+    [17] = PROP_CLIENTPIDMAP,
+    [18] = PROP_LOGO,
+    [19] = PROP_IMPP,
+    [20] = PROP_REV,
+    [22] = PROP_TZ,
+    [25] = PROP_NOTE,
+    [26] = PROP_TITLE,
+    [28] = PROP_FN,
+    [32] = PROP_BEGIN,
+    [33] = PROP_CALURI,
+    [35] = PROP_NICKNAME,
+    [37] = PROP_EMAIL,
+    [38] = PROP_END,
+    [39] = PROP_KIND,
+    [40] = PROP_BDAY,
+    [42] = PROP_GEO,
+    [45] = PROP_PHOTO,
+    [46] = PROP_RELATED,
+    [49] = PROP_ORG,
+    [50] = PROP_PRODID,
+    [52] = PROP_TEL,
+    [54] = PROP_ADR,
+    [57] = PROP_MEMBER,
+    [58] = PROP_URL,
+    [59] = PROP_SOUND,
+    [60] = PROP_SOURCE,
+    [61] = PROP_ROLE,
+    [62] = PROP_VERSION,
+};
+
+/**
+ * propertyHash: Hashes a name by its length and its first, middle and last characters (Case insensitive)
+ * @param name: StringView Name to hash (Not empty)
+ * @return unsigned int: Slot of propertyHashTable
+ */
+static unsigned int propertyHash(StringView name) {
+    unsigned int first = (unsigned int)toupper((unsigned char)(name.start[0]));
+    unsigned int middle = (unsigned int)toupper((unsigned char)(name.start[name.length / 2]));
+    unsigned int last = (unsigned int)toupper((unsigned char)(name.start[name.length - 1]));
+    return (7 * (unsigned int)(name.length) + 31 * first + 3 * last + 3 * middle) & (PROPERTY_HASH_SIZE - 1);
+}
+
+PropertyKind lookupPropertyKind(StringView name) {
+    if (name.length == 0 || name.length > PROPERTY_NAME_MAX_LENGTH) {
+        return PROP_UNKNOWN;
+    }
+
+    //A single compare confirms the name really is the one hashed to the slot
+    PropertyKind kind = propertyHashTable[propertyHash(name)];
+    if (kind == PROP_UNRESOLVED || viewCaseEquals(name, propertySpecs[kind].name) == false) {
+        return PROP_UNKNOWN;
+    }
+
+    return kind;
+}
+
+PropertyKind propertyKind(const Property* prop) {
+    if (prop == NULL || prop->name == NULL) {
+        return PROP_UNKNOWN;
+    }
+
+    //prop->kind may be unset (Or stale/garbage on a Property built by hand), so it is only trusted if the name agrees
+    StringView name = { prop->name, strlen(prop->name) };
+    PropertyKind kind = prop->kind;
+    if (kind > PROP_UNKNOWN && kind < PROPERTY_KIND_COUNT && viewCaseEquals(name, propertySpecs[kind].name)) {
+        return kind;
+    }
+
+    return lookupPropertyKind(name);
+}
+
+const char* propertyKindName(PropertyKind kind) {
+    return propertySpec(kind)->name;
+}
+
+const PropertySpec* propertySpec(PropertyKind kind) {
+    if (kind <= PROP_UNKNOWN || kind >= PROPERTY_KIND_COUNT) {
+        return &propertySpecs[PROP_UNKNOWN];
+    }
+    return &propertySpecs[kind];
+}
+
+VCardErrorCode checkValueCount(PropertyKind kind, int valueCount) {
+    const PropertySpec* spec = propertySpec(kind);
+    if (valueCount < spec->minValues || (spec->maxValues > 0 && valueCount > spec->maxValues)) {
+        return INV_PROP;
+    }
+    return OK;
+}
+
+VCardErrorCode checkCardinality(const int occurrences[PROPERTY_KIND_COUNT]) {
+    for (int kind = PROP_UNKNOWN + 1; kind < PROPERTY_KIND_COUNT; kind++) {
+        if (propertySpecs[kind].cardinality == CARDINALITY_AT_MOST_ONE && occurrences[kind] > 1) {
+            return INV_PROP;
+        }
+    }
+    return OK;
+}
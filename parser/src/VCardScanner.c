@@ -0,0 +1,83 @@
+/**
+ * @file VCardScanner.c
+ * @brief This file contains the VCard file's vectorized byte scanner, used to find line breaks and delimiters.
+ * @author ADD LATER
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "VCardScanner.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SCANNER_BLOCK 32
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SCANNER_BLOCK 16
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+
+/**
+ * matchMask: Compares one block of bytes against two characters
+ * @param block: const char* Start of SCANNER_BLOCK readable bytes
+ * @param first: char Character to look for
+ * @param second: char Other character to look for (Pass first again to look for a single character)
+ * @return unsigned int: Bit i is set if byte i of the block matches
+ */
+static inline unsigned int matchMask(const char* block, char first, char second) {
+#if defined(__AVX2__)
+    __m256i bytes = _mm256_loadu_si256((const __m256i*)(block));
+    __m256i matches = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(first)), _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(second)));
+    return (unsigned int)(_mm256_movemask_epi8(matches));
+#else
+    __m128i bytes = _mm_loadu_si128((const __m128i*)(block));
+    __m128i matches = _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(first)), _mm_cmpeq_epi8(bytes, _mm_set1_epi8(second)));
+    return (unsigned int)(_mm_movemask_epi8(matches));
+#endif
+}
+
+#endif
+
+const char* scanForEither(const char* start, const char* end, char first, char second) {
+    const char* p = start;
+
+#ifdef SCANNER_BLOCK
+    //Whole blocks first - The lowest set bit of the mask is the first match
+    while (end - p >= SCANNER_BLOCK) {
+        unsigned int mask = matchMask(p, first, second);
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += SCANNER_BLOCK;
+    }
+#endif
+
+    //Scalar fallback, also used for the bytes after the last whole block
+    while (p < end && *p != first && *p != second) {
+        p++;
+    }
+    return p;
+}
+
+size_t countCharacter(const char* start, const char* end, char toCount) {
+    const char* p = start;
+    size_t count = 0;
+
+#ifdef SCANNER_BLOCK
+    while (end - p >= SCANNER_BLOCK) {
+        count += (size_t)(__builtin_popcount(matchMask(p, toCount, toCount)));
+        p += SCANNER_BLOCK;
+    }
+#endif
+
+    while (p < end) {
+        if (*p == toCount) {
+            count++;
+        }
+        p++;
+    }
+    return count;
+}
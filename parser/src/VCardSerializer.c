@@ -0,0 +1,256 @@
+/**
+ * @file VCardSerializer.c
+ * @brief This file contains the VCard file's card to text rendering, used to write cards.
+ * @author ADD LATER
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "VCardParser.h"
+#include "VCardStringBuilder.h"
+#include "VCardSerializer.h"
+#include "VCardVector.h"
+#include "LinkedListAPI.h"
+
+/**
+ * A content line being appended to a builder, folded as it grows
+ */
+typedef struct foldingWriter {
+    StringBuilder* out;
+
+    //Octets on the current physical line
+    size_t column;
+} FoldingWriter;
+
+/**
+ * foldedAppend: Appends bytes to the current content line, starting a continuation line whenever the
+ * physical line is full. A fold never lands inside a UTF-8 character
+ * @param writer: FoldingWriter* to append to
+ * @param bytes: const char* Bytes to append
+ * @param length: size_t Number of bytes
+ */
+static void foldedAppend(FoldingWriter* writer, const char* bytes, size_t length) {
+    while (length > 0) {
+        size_t room = FOLD_LINE_LENGTH - writer->column;
+        if (length <= room) {
+            builderAppendBytes(writer->out, bytes, length);
+            writer->column += length;
+            return;
+        }
+
+        //Back up to the first byte of a UTF-8 character (Continuation bytes are 10xxxxxx). A character has at most
+        //3 continuation bytes - Longer runs are not UTF-8, and are cut anywhere so the line always makes progress
+        size_t cut = room;
+        while (cut > 0 && room - cut < 3 && ((unsigned char)(bytes[cut]) & 0xC0) == 0x80) {
+            cut--;
+        }
+        if (((unsigned char)(bytes[cut]) & 0xC0) == 0x80) {
+            cut = room;
+        }
+
+        builderAppendBytes(writer->out, bytes, cut);
+        builderAppendBytes(writer->out, "\r\n ", 3);
+        bytes += cut;
+        length -= cut;
+
+        //The leading space counts towards the continuation line
+        writer->column = 1;
+    }
+}
+
+/**
+ * foldedAppendString: Appends a NUL terminated string to the current content line (See foldedAppend)
+ * @param writer: FoldingWriter* to append to
+ * @param string: const char* String to append (NULL is ignored)
+ */
+static void foldedAppendString(FoldingWriter* writer, const char* string) {
+    if (string != NULL) {
+        foldedAppend(writer, string, strlen(string));
+    }
+}
+
+/**
+ * foldedAppendValue: Appends a value to the current content line, escaping what would otherwise end the value
+ * (\\ becomes \\\\, a newline becomes \\n and ; becomes \\;). Commas are kept as list separators
+ * @param writer: FoldingWriter* to append to
+ * @param value: const char* Value to append (NULL is ignored)
+ */
+static void foldedAppendValue(FoldingWriter* writer, const char* value) {
+    if (value == NULL) {
+        return;
+    }
+
+    const char* runStart = value;
+    const char* p = value;
+    for (p = value; *p != '\0'; p++) {
+        if (*p != '\\' && *p != ';' && *p != '\n' && *p != '\r') {
+            continue;
+        }
+
+        //Copy the plain characters before the escape in one go
+        foldedAppend(writer, runStart, (size_t)(p - runStart));
+        runStart = p + 1;
+
+        if (*p == '\r') {
+            //A \r\n pair is one newline
+            if (p[1] == '\n') {
+                continue;
+            }
+            foldedAppend(writer, "\\n", 2);
+        }
+        else if (*p == '\n') {
+            foldedAppend(writer, "\\n", 2);
+        }
+        else {
+            char escape[2] = { '\\', *p };
+            foldedAppend(writer, escape, 2);
+        }
+    }
+    foldedAppend(writer, runStart, (size_t)(p - runStart));
+}
+
+/**
+ * endContentLine: Ends the current content line
+ * @param writer: FoldingWriter* to end the line of
+ */
+static void endContentLine(FoldingWriter* writer) {
+    builderAppendBytes(writer->out, "\r\n", 2);
+    writer->column = 0;
+}
+
+/**
+ * appendPropertyText: Renders one property as a content line - group.NAME;PARAM=value:value;value
+ * @param writer: FoldingWriter* to append to
+ * @param prop: const Property* to render
+ */
+static void appendPropertyText(FoldingWriter* writer, const Property* prop) {
+    if (prop->group != NULL && prop->group[0] != '\0') {
+        foldedAppendString(writer, prop->group);
+        foldedAppend(writer, ".", 1);
+    }
+    foldedAppendString(writer, prop->name);
+
+    size_t parameterCount = vectorLength(&prop->parameters->elements);
+    for (size_t i = 0; i < parameterCount; i++) {
+        const Parameter* parameter = vectorGet(&prop->parameters->elements, i);
+        foldedAppend(writer, ";", 1);
+        foldedAppendString(writer, parameter->name);
+        foldedAppend(writer, "=", 1);
+        foldedAppendString(writer, parameter->value);
+    }
+    foldedAppend(writer, ":", 1);
+
+    //Every value after the first is preceded by a ';' - An empty last value is written as nothing after its ';'
+    size_t valueCount = vectorLength(&prop->values->elements);
+    for (size_t i = 0; i < valueCount; i++) {
+        if (i > 0) {
+            foldedAppend(writer, ";", 1);
+        }
+        foldedAppendValue(writer, vectorGet(&prop->values->elements, i));
+    }
+
+    endContentLine(writer);
+}
+
+/**
+ * appendDateTimeText: Renders a BDAY/ANNIVERSARY as a content line
+ * @param writer: FoldingWriter* to append to
+ * @param name: const char* Property name
+ * @param date: const DateTime* to render
+ */
+static void appendDateTimeText(FoldingWriter* writer, const char* name, const DateTime* date) {
+    foldedAppendString(writer, name);
+
+    if (date->isText) {
+        foldedAppendString(writer, ";VALUE=text:");
+        foldedAppendValue(writer, date->text);
+    }
+    else {
+        foldedAppend(writer, ":", 1);
+        foldedAppendString(writer, date->date);
+        if (date->time[0] != '\0') {
+            foldedAppend(writer, "T", 1);
+            foldedAppendString(writer, date->time);
+        }
+    }
+
+    //Must append a 'Z' to the end
+    if (date->UTC) {
+        foldedAppend(writer, "Z", 1);
+    }
+
+    endContentLine(writer);
+}
+
+/**
+ * estimatePropertyText: Estimates the unfolded length of a property's content line
+ * @param prop: const Property* to estimate
+ * @return size_t: Number of bytes
+ */
+static size_t estimatePropertyText(const Property* prop) {
+    size_t length = strlen(prop->name) + (prop->group != NULL ? strlen(prop->group) : 0) + 4;
+
+    size_t parameterCount = vectorLength(&prop->parameters->elements);
+    for (size_t i = 0; i < parameterCount; i++) {
+        const Parameter* parameter = vectorGet(&prop->parameters->elements, i);
+        length += strlen(parameter->name) + strlen(parameter->value) + 2;
+    }
+
+    size_t valueCount = vectorLength(&prop->values->elements);
+    for (size_t i = 0; i < valueCount; i++) {
+        length += strlen(vectorGet(&prop->values->elements, i)) + 1;
+    }
+
+    return length;
+}
+
+size_t estimateCardText(const Card* card) {
+    //BEGIN:VCARD, VERSION:4.0 and END:VCARD lines, plus room for both dates
+    size_t length = 40 + 2 * 48;
+
+    if (card->fn != NULL) {
+        length += estimatePropertyText(card->fn);
+    }
+    if (card->birthday != NULL && card->birthday->isText) {
+        length += strlen(card->birthday->text);
+    }
+    if (card->anniversary != NULL && card->anniversary->isText) {
+        length += strlen(card->anniversary->text);
+    }
+
+    VectorIterator iter = createVectorIterator(&card->optionalProperties->elements);
+    Property* prop = NULL;
+    while ((prop = nextVectorElement(&iter)) != NULL) {
+        length += estimatePropertyText(prop);
+    }
+
+    //Every folded physical line adds a \r\n and a space
+    return length + length / (FOLD_LINE_LENGTH - 1) * 3;
+}
+
+void appendCardText(StringBuilder* out, const Card* card) {
+    FoldingWriter writer = { out, 0 };
+
+    //Print the initial headings that must be in a VCard
+    builderAppend(out, "BEGIN:VCARD\r\nVERSION:4.0\r\n");
+
+    if (card->fn != NULL) {
+        appendPropertyText(&writer, card->fn);
+    }
+    if (card->anniversary != NULL) {
+        appendDateTimeText(&writer, "ANNIVERSARY", card->anniversary);
+    }
+    if (card->birthday != NULL) {
+        appendDateTimeText(&writer, "BDAY", card->birthday);
+    }
+
+    VectorIterator iter = createVectorIterator(&card->optionalProperties->elements);
+    Property* prop = NULL;
+    while ((prop = nextVectorElement(&iter)) != NULL) {
+        appendPropertyText(&writer, prop);
+    }
+
+    builderAppend(out, "END:VCARD\r\n");
+}
@@ -0,0 +1,143 @@
+/**
+ * @file VCardStringBuilder.c
+ * @brief This file contains the VCard file's growable string, used to build JSON output.
+ * @author ADD LATER
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "VCardStringBuilder.h"
+
+//Large enough for most property objects without growing
+#define STRING_BUILDER_INITIAL_CAPACITY 64
+
+void initializeStringBuilder(StringBuilder* builder, size_t initialCapacity) {
+    if (initialCapacity == 0) {
+        initialCapacity = STRING_BUILDER_INITIAL_CAPACITY;
+    }
+
+    //One extra byte for the NUL terminator
+    builder->buffer = malloc(initialCapacity + 1);
+    builder->buffer[0] = '\0';
+    builder->length = 0;
+    builder->capacity = initialCapacity;
+}
+
+void clearStringBuilder(StringBuilder* builder) {
+    free(builder->buffer);
+    builder->buffer = NULL;
+    builder->length = 0;
+    builder->capacity = 0;
+}
+
+void builderReserve(StringBuilder* builder, size_t additional) {
+    if (builder->length + additional <= builder->capacity) {
+        return;
+    }
+
+    //Double the capacity so n appends copy O(n) bytes in total
+    size_t newCapacity = builder->capacity == 0 ? STRING_BUILDER_INITIAL_CAPACITY : builder->capacity * 2;
+    while (newCapacity < builder->length + additional) {
+        newCapacity *= 2;
+    }
+
+    builder->buffer = realloc(builder->buffer, newCapacity + 1);
+    builder->capacity = newCapacity;
+}
+
+void builderAppendBytes(StringBuilder* builder, const char* bytes, size_t length) {
+    builderReserve(builder, length);
+    memcpy(builder->buffer + builder->length, bytes, length);
+    builder->length += length;
+    builder->buffer[builder->length] = '\0';
+}
+
+void builderAppend(StringBuilder* builder, const char* string) {
+    if (string == NULL) {
+        return;
+    }
+    builderAppendBytes(builder, string, strlen(string));
+}
+
+void builderAppendChar(StringBuilder* builder, char character) {
+    builderReserve(builder, 1);
+    builder->buffer[builder->length++] = character;
+    builder->buffer[builder->length] = '\0';
+}
+
+void builderAppendInt(StringBuilder* builder, long number) {
+    char digits[24];
+    int length = snprintf(digits, sizeof(digits), "%ld", number);
+    builderAppendBytes(builder, digits, (size_t)length);
+}
+
+void builderAppendEscaped(StringBuilder* builder, const char* string) {
+    if (string == NULL) {
+        return;
+    }
+
+    //Most strings need no escaping, so reserve for the plain copy and grow only when an escape is written
+    size_t length = strlen(string);
+    builderReserve(builder, length);
+
+    const char* runStart = string;
+    const char* p = string;
+    for (p = string; *p != '\0'; p++) {
+        unsigned char c = (unsigned char)(*p);
+        if (c != '"' && c != '\\' && c >= 0x20) {
+            continue;
+        }
+
+        //Copy the plain characters before the escape in one go
+        builderAppendBytes(builder, runStart, (size_t)(p - runStart));
+        runStart = p + 1;
+
+        builderAppendChar(builder, '\\');
+        switch (c) {
+            case '"':
+                builderAppendChar(builder, '"');
+                break;
+            case '\\':
+                builderAppendChar(builder, '\\');
+                break;
+            case '\n':
+                builderAppendChar(builder, 'n');
+                break;
+            case '\r':
+                builderAppendChar(builder, 'r');
+                break;
+            case '\t':
+                builderAppendChar(builder, 't');
+                break;
+            case '\b':
+                builderAppendChar(builder, 'b');
+                break;
+            case '\f':
+                builderAppendChar(builder, 'f');
+                break;
+            default: {
+                //Remaining control characters have no short form
+                char hex[8];
+                snprintf(hex, sizeof(hex), "u%04x", c);
+                builderAppendBytes(builder, hex, 5);
+                break;
+            }
+        }
+    }
+
+    builderAppendBytes(builder, runStart, (size_t)(p - runStart));
+}
+
+char* builderFinish(StringBuilder* builder) {
+    char* toReturn = builder->buffer;
+    if (toReturn == NULL) {
+        toReturn = calloc(1, sizeof(char));
+    }
+
+    builder->buffer = NULL;
+    builder->length = 0;
+    builder->capacity = 0;
+    return toReturn;
+}
@@ -0,0 +1,400 @@
+/**
+ * @file VCardTokenizer.c
+ * @brief This file contains the VCard file's single pass content line tokenizer.
+ * @author ADD LATER
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include "VCardParser.h"
+#include "VCardTokenizer.h"
+#include "VCardScanner.h"
+
+/**
+ * appendToScratch: Appends a segment of a folded line to the tokenizer's scratch space
+ * @param tokenizer: Tokenizer* owning the scratch space
+ * @param used: size_t Number of bytes already in the scratch space
+ * @param segment: const char* Start of the segment
+ * @param length: size_t Length of the segment
+ */
+static void appendToScratch(Tokenizer* tokenizer, size_t used, const char* segment, size_t length) {
+    if (used + length > tokenizer->scratchCapacity) {
+        //Grow geometrically so long folded values are not reallocated on every continuation line
+        size_t newCapacity = tokenizer->scratchCapacity == 0 ? 256 : tokenizer->scratchCapacity;
+        while (newCapacity < used + length) {
+            newCapacity *= 2;
+        }
+        tokenizer->scratch = realloc(tokenizer->scratch, newCapacity);
+        tokenizer->scratchCapacity = newCapacity;
+    }
+    memcpy(tokenizer->scratch + used, segment, length);
+}
+
+/**
+ * unfoldLine: Unfolds a line inside the buffer, moving every segment down over the line break and whitespace before it
+ * @param start: char* Start of the line
+ * @param end: const char* End of the line's last segment - Every \r before it starts a fold (\r\n then a space or tab)
+ * @return size_t: Length of the unfolded line
+ */
+static size_t unfoldLine(char* start, const char* end) {
+    char* write = start;
+    const char* read = start;
+
+    while (true) {
+        const char* lineBreak = scanForEither(read, end, '\r', '\r');
+        size_t segmentLength = (size_t)(lineBreak - read);
+        if (write != read) {
+            memmove(write, read, segmentLength);
+        }
+        write += segmentLength;
+
+        if (lineBreak == end) {
+            break;
+        }
+        read = lineBreak + 3;
+    }
+
+    return (size_t)(write - start);
+}
+
+/**
+ * requestMoreInput: Asks the tokenizer's refill function for more bytes
+ * @param tokenizer: Tokenizer* to refill
+ * @return bool: true if bytes were added, false at the end of the input
+ */
+static bool requestMoreInput(Tokenizer* tokenizer) {
+    if (tokenizer->endOfInput) {
+        return false;
+    }
+
+    if (tokenizer->refill == NULL || tokenizer->refill(tokenizer) == false) {
+        tokenizer->endOfInput = true;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * scanContentLine: Scans one content line starting at tokenizer->current
+ * @param tokenizer: Tokenizer* to scan
+ * @param line: ContentLine* to store the line into
+ * @param needMore: bool* set to true if the line runs past the buffered bytes and more input may follow
+ * @return TokenStatus: TOKEN_LINE or TOKEN_ERROR (Meaningless if needMore was set)
+ */
+static TokenStatus scanContentLine(Tokenizer* tokenizer, ContentLine* line, bool* needMore) {
+    const char* end = tokenizer->end;
+    //Only written to if the buffer is writable
+    char* lineStart = (char*)(tokenizer->current);
+    const char* segmentStart = tokenizer->current;
+    const char* p = tokenizer->current;
+    int lineNumber = tokenizer->lineNumber;
+    size_t scratchUsed = 0;
+    size_t longestPhysicalLine = 0;
+    bool folded = false;
+
+    *needMore = false;
+    line->lineNumber = lineNumber;
+    line->byteOffset = tokenizer->offset;
+    line->line.start = NULL;
+    line->line.length = 0;
+    line->name.start = NULL;
+    line->name.length = 0;
+
+    while (true) {
+        //Find the end of the physical line
+        p = scanForEither(p, end, '\r', '\n');
+
+        //Continuation lines also count their leading whitespace character
+        size_t physicalLength = (size_t)(p - segmentStart) + (folded ? 1 : 0);
+        if (physicalLength > longestPhysicalLine) {
+            longestPhysicalLine = physicalLength;
+        }
+
+        //Can not tell if the line ends here (Or if a \r is followed by a \n) until more bytes are read
+        if ((p == end || (*p == '\r' && p + 1 == end)) && tokenizer->endOfInput == false) {
+            *needMore = true;
+            return TOKEN_ERROR;
+        }
+
+        //Last line of the input does not need a \r\n
+        if (p == end) {
+            tokenizer->offset += (size_t)(end - tokenizer->current);
+            tokenizer->current = end;
+            break;
+        }
+
+        //Every \n must have a \r before it, and every \r must be followed by a \n
+        if (*p == '\n' || p + 1 >= end || p[1] != '\n') {
+            //Continue after the offending character on the next call
+            tokenizer->offset += (size_t)(p + 1 - tokenizer->current);
+            tokenizer->current = p + 1;
+            tokenizer->lineNumber = lineNumber + 1;
+            return TOKEN_ERROR;
+        }
+
+        lineNumber++;
+
+        //A physical line starting with a space or tab continues the previous one
+        const char* next = p + 2;
+        if (next == end && tokenizer->endOfInput == false) {
+            *needMore = true;
+            return TOKEN_ERROR;
+        }
+        if (next < end && (*next == ' ' || *next == '\t')) {
+            //Writable buffers are unfolded once the whole line is known, since a refill can still restart the scan
+            if (tokenizer->unfoldInPlace == false) {
+                appendToScratch(tokenizer, scratchUsed, segmentStart, (size_t)(p - segmentStart));
+                scratchUsed += (size_t)(p - segmentStart);
+            }
+            folded = true;
+
+            //Remove the single whitespace character
+            segmentStart = next + 1;
+            p = segmentStart;
+            continue;
+        }
+
+        tokenizer->offset += (size_t)(next - tokenizer->current);
+        tokenizer->current = next;
+        break;
+    }
+
+    tokenizer->lineNumber = lineNumber;
+    line->longestPhysicalLine = longestPhysicalLine;
+
+    if (folded && tokenizer->unfoldInPlace) {
+        line->line.start = lineStart;
+        line->line.length = unfoldLine(lineStart, p);
+    }
+    else if (folded) {
+        appendToScratch(tokenizer, scratchUsed, segmentStart, (size_t)(p - segmentStart));
+        scratchUsed += (size_t)(p - segmentStart);
+        line->line.start = tokenizer->scratch;
+        line->line.length = scratchUsed;
+    }
+    else {
+        line->line.start = segmentStart;
+        line->line.length = (size_t)(p - segmentStart);
+    }
+
+    return TOKEN_LINE;
+}
+
+void initializeTokenizer(Tokenizer* tokenizer, const char* buffer, size_t length) {
+    tokenizer->current = buffer;
+    tokenizer->end = buffer + length;
+    tokenizer->lineNumber = 1;
+    tokenizer->offset = 0;
+    tokenizer->endOfInput = true;
+    tokenizer->unfoldInPlace = false;
+    tokenizer->refill = NULL;
+    tokenizer->refillContext = NULL;
+    tokenizer->hasPending = false;
+    tokenizer->scratch = NULL;
+    tokenizer->scratchCapacity = 0;
+}
+
+void initializeWritableTokenizer(Tokenizer* tokenizer, char* buffer, size_t length) {
+    initializeTokenizer(tokenizer, buffer, length);
+    tokenizer->unfoldInPlace = true;
+}
+
+void clearTokenizer(Tokenizer* tokenizer) {
+    free(tokenizer->scratch);
+    tokenizer->scratch = NULL;
+    tokenizer->scratchCapacity = 0;
+}
+
+bool hasMoreContent(Tokenizer* tokenizer) {
+    if (tokenizer->hasPending) {
+        return true;
+    }
+
+    while (true) {
+        //Two bytes are needed to recognise an empty line
+        if (tokenizer->end - tokenizer->current < 2 && requestMoreInput(tokenizer)) {
+            continue;
+        }
+
+        //Skip empty lines
+        if (tokenizer->current + 1 < tokenizer->end && tokenizer->current[0] == '\r' && tokenizer->current[1] == '\n') {
+            tokenizer->current += 2;
+            tokenizer->offset += 2;
+            tokenizer->lineNumber++;
+            continue;
+        }
+
+        return tokenizer->current < tokenizer->end;
+    }
+}
+
+TokenStatus nextContentLine(Tokenizer* tokenizer, ContentLine* line) {
+    if (tokenizer->hasPending) {
+        *line = tokenizer->pending;
+        tokenizer->hasPending = false;
+        return TOKEN_LINE;
+    }
+
+    if (hasMoreContent(tokenizer) == false) {
+        return TOKEN_END;
+    }
+
+    while (true) {
+        bool needMore = false;
+        TokenStatus status = scanContentLine(tokenizer, line, &needMore);
+        if (needMore == false) {
+            return status;
+        }
+
+        //Rescan the line once more bytes are buffered (Or once the end of the input is known)
+        requestMoreInput(tokenizer);
+    }
+}
+
+void unreadContentLine(Tokenizer* tokenizer, const ContentLine* line) {
+    tokenizer->pending = *line;
+    tokenizer->hasPending = true;
+}
+
+VCardErrorCode splitContentLine(ContentLine* line) {
+    const char* p = line->line.start;
+    const char* end = line->line.start + line->line.length;
+    const char* nameStart = p;
+    bool groupFound = false;
+
+    line->group.start = p;
+    line->group.length = 0;
+
+    //Name section ends at the first ';' or ':' - A '.' before that ends the group
+    while (p < end && *p != ';' && *p != ':') {
+        if (*p == '.' && groupFound == false) {
+            line->group.length = (size_t)(p - nameStart);
+            nameStart = p + 1;
+            groupFound = true;
+        }
+        p++;
+    }
+
+    line->name.start = nameStart;
+    line->name.length = (size_t)(p - nameStart);
+
+    if (p == end) {
+        return INV_PROP;
+    }
+
+    line->hasParameters = false;
+    line->parameters.start = p;
+    line->parameters.length = 0;
+
+    if (*p == ';') {
+        //Parameters end at the first ':' that is not inside a quoted parameter value
+        bool inQuotes = false;
+        p++;
+        line->parameters.start = p;
+        while (p < end && (inQuotes || *p != ':')) {
+            if (*p == '"') {
+                inQuotes = !inQuotes;
+            }
+            p++;
+        }
+
+        if (p == end) {
+            return INV_PROP;
+        }
+
+        line->parameters.length = (size_t)(p - line->parameters.start);
+        line->hasParameters = true;
+    }
+
+    //Skip the ':'
+    p++;
+    line->values.start = p;
+    line->values.length = (size_t)(end - p);
+
+    return OK;
+}
+
+bool nextViewSection(StringView* remaining, char delimiter, bool respectQuotes, StringView* section) {
+    if (remaining->start == NULL) {
+        return false;
+    }
+
+    const char* p = remaining->start;
+    const char* end = remaining->start + remaining->length;
+    bool inQuotes = false;
+
+    while (p < end) {
+        if (respectQuotes && *p == '"') {
+            inQuotes = !inQuotes;
+        }
+        else if (inQuotes == false && *p == delimiter) {
+            break;
+        }
+        p++;
+    }
+
+    section->start = remaining->start;
+    section->length = (size_t)(p - remaining->start);
+
+    if (p < end) {
+        remaining->start = p + 1;
+        remaining->length = (size_t)(end - p - 1);
+    }
+    else {
+        //Mark the view as exhausted - A trailing delimiter still yields a final empty section
+        remaining->start = NULL;
+        remaining->length = 0;
+    }
+
+    return true;
+}
+
+bool nextValueSection(StringView* remaining, StringView* section) {
+    if (remaining->start == NULL) {
+        return false;
+    }
+
+    const char* p = remaining->start;
+    const char* end = remaining->start + remaining->length;
+
+    while ((p = scanForEither(p, end, ';', '\\')) < end && *p == '\\') {
+        //Skip whatever a backslash escapes (A trailing backslash is kept as is)
+        p += p + 1 < end ? 2 : 1;
+    }
+
+    section->start = remaining->start;
+    section->length = (size_t)(p - remaining->start);
+
+    if (p < end) {
+        remaining->start = p + 1;
+        remaining->length = (size_t)(end - p - 1);
+    }
+    else {
+        remaining->start = NULL;
+        remaining->length = 0;
+    }
+
+    return true;
+}
+
+bool viewCaseEquals(StringView view, const char* string) {
+    size_t i = 0;
+    for (i = 0; i < view.length; i++) {
+        if (string[i] == '\0' || tolower((unsigned char)(view.start[i])) != tolower((unsigned char)(string[i]))) {
+            return false;
+        }
+    }
+    return string[i] == '\0';
+}
+
+char* viewToString(StringView view) {
+    //NOTE: REMEMBER TO FREE toReturn IN CALLING FUNCTION
+    char* toReturn = malloc(view.length + 1);
+    memcpy(toReturn, view.start, view.length);
+    toReturn[view.length] = '\0';
+    return toReturn;
+}
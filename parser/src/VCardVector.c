@@ -0,0 +1,110 @@
+/**
+ * @file VCardVector.c
+ * @brief This file contains the VCard file's contiguous growable array.
+ * @author ADD LATER
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "VCardVector.h"
+#include "VCardArena.h"
+
+//Most properties have a handful of parameters and values
+#define VECTOR_INITIAL_CAPACITY 4
+
+/**
+ * growVector: Makes room for at least one more item, doubling the capacity
+ * @param vector: Vector* to grow
+ */
+static void growVector(Vector* vector) {
+    size_t newCapacity = vector->capacity == 0 ? VECTOR_INITIAL_CAPACITY : vector->capacity * 2;
+
+    if (vector->arena != NULL) {
+        //Arena memory can not be resized - The old array is left to the arena
+        void** newItems = arenaAlloc(vector->arena, newCapacity * sizeof(void*));
+        if (vector->length > 0) {
+            memcpy(newItems, vector->items, vector->length * sizeof(void*));
+        }
+        vector->items = newItems;
+    }
+    else {
+        vector->items = realloc(vector->items, newCapacity * sizeof(void*));
+    }
+
+    vector->capacity = newCapacity;
+}
+
+void initializeVector(Vector* vector, struct arena* arena) {
+    vector->items = NULL;
+    vector->length = 0;
+    vector->capacity = 0;
+    vector->arena = arena;
+}
+
+void clearVectorStorage(Vector* vector) {
+    if (vector->arena == NULL) {
+        free(vector->items);
+    }
+    vector->items = NULL;
+    vector->length = 0;
+    vector->capacity = 0;
+}
+
+void vectorPushBack(Vector* vector, void* item) {
+    if (vector->length == vector->capacity) {
+        growVector(vector);
+    }
+    vector->items[vector->length++] = item;
+}
+
+void vectorInsert(Vector* vector, size_t index, void* item) {
+    if (index > vector->length) {
+        index = vector->length;
+    }
+
+    if (vector->length == vector->capacity) {
+        growVector(vector);
+    }
+
+    memmove(vector->items + index + 1, vector->items + index, (vector->length - index) * sizeof(void*));
+    vector->items[index] = item;
+    vector->length++;
+}
+
+void* vectorRemove(Vector* vector, size_t index) {
+    if (index >= vector->length) {
+        return NULL;
+    }
+
+    void* toReturn = vector->items[index];
+    memmove(vector->items + index, vector->items + index + 1, (vector->length - index - 1) * sizeof(void*));
+    vector->length--;
+    return toReturn;
+}
+
+void* vectorGet(const Vector* vector, size_t index) {
+    if (index >= vector->length) {
+        return NULL;
+    }
+    return vector->items[index];
+}
+
+size_t vectorLength(const Vector* vector) {
+    return vector->length;
+}
+
+VectorIterator createVectorIterator(const Vector* vector) {
+    VectorIterator iter;
+    iter.vector = vector;
+    iter.index = 0;
+    return iter;
+}
+
+void* nextVectorElement(VectorIterator* iter) {
+    if (iter->index >= iter->vector->length) {
+        return NULL;
+    }
+    return iter->vector->items[iter->index++];
+}
@@ -0,0 +1,248 @@
+/**
+ * @file VCardJSONTest.c
+ * @brief This file contains the tests of the JSON reader, and of converting cards to JSON and back.
+ * @author ADD LATER
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "VCardParser.h"
+#include "LinkedListAPI.h"
+#include "VCardJSONReader.h"
+#include "VCardStringBuilder.h"
+#include "VCardTest.h"
+
+//Fixtures holding valid cards (Run from the directory of the makefile)
+static const char* validFixtures[] = {
+    "test/fixtures/testCard.vcf",
+    "test/fixtures/folded.vcf",
+    "test/fixtures/escapes.vcf",
+    "test/fixtures/utf8.vcf"
+};
+
+/**
+ * traceEvent: Appends one reader event to the trace, followed by a space
+ * @param context: void* StringBuilder* of the trace
+ * @param event: const char* Event name
+ * @param text: const char* Text of the event (NULL if it has none)
+ * @param length: size_t Length of the text
+ * @return bool: true, so the reader keeps going
+ */
+static bool traceEvent(void* context, const char* event, const char* text, size_t length) {
+    StringBuilder* trace = context;
+    builderAppend(trace, event);
+    if (text != NULL) {
+        builderAppendChar(trace, '<');
+        builderAppendBytes(trace, text, length);
+        builderAppendChar(trace, '>');
+    }
+    builderAppendChar(trace, ' ');
+    return true;
+}
+
+static bool traceStartObject(void* context) { return traceEvent(context, "{", NULL, 0); }
+static bool traceEndObject(void* context) { return traceEvent(context, "}", NULL, 0); }
+static bool traceStartArray(void* context) { return traceEvent(context, "[", NULL, 0); }
+static bool traceEndArray(void* context) { return traceEvent(context, "]", NULL, 0); }
+static bool traceKey(void* context, const char* key, size_t length) { return traceEvent(context, "key", key, length); }
+static bool traceString(void* context, const char* value, size_t length) { return traceEvent(context, "string", value, length); }
+static bool traceNumber(void* context, const char* text, size_t length) { return traceEvent(context, "number", text, length); }
+static bool traceBoolean(void* context, bool value) { return traceEvent(context, value ? "true" : "false", NULL, 0); }
+static bool traceNull(void* context) { return traceEvent(context, "null", NULL, 0); }
+
+/**
+ * stopAtNumber: Number callback that stops the reader
+ */
+static bool stopAtNumber(void* context, const char* text, size_t length) {
+    return false;
+}
+
+/**
+ * traceJSON: Reads a document, tracing every event
+ * @param json: const char* Document to read
+ * @param handlerOverride: const JSONHandler* whose non NULL callbacks replace the tracing ones (May be NULL)
+ * @param valid: bool* to store the result of readJSON into
+ * @return char*: The trace, freed by the caller
+ */
+static char* traceJSON(const char* json, const JSONHandler* handlerOverride, bool* valid) {
+    StringBuilder trace;
+    initializeStringBuilder(&trace, 0);
+
+    JSONHandler handler = { &trace, traceStartObject, traceEndObject, traceStartArray, traceEndArray,
+                            traceKey, traceString, traceNumber, traceBoolean, traceNull };
+    if (handlerOverride != NULL && handlerOverride->number != NULL) {
+        handler.number = handlerOverride->number;
+    }
+
+    *valid = readJSON(json, strlen(json), &handler);
+    return builderFinish(&trace);
+}
+
+/**
+ * testReader: The reader reports every value in order, unescaped, and rejects malformed documents
+ */
+static void testReader(void) {
+    bool valid = false;
+    char* trace = traceJSON(" {\"a\": [1, -2.5e3, true, false, null], \"b\\\"c\": \"x\\ny\\\\z\\/\", \"\\u00e9\\ud83d\\ude00\": {}} ",
+                            NULL, &valid);
+    CHECK(valid);
+    CHECK_STRING(trace, "{ key<a> [ number<1> number<-2.5e3> true false null ] key<b\"c> string<x\ny\\z/> "
+                        "key<\xC3\xA9\xF0\x9F\x98\x80> { } } ");
+    free(trace);
+
+    const char* malformed[] = {
+        "", "{", "{\"a\":}", "[1,]", "[1 2]", "\"unterminated", "{\"a\" 1}", "{} x", "{'a':1}", "[tru]",
+        "\"\\x\"", "\"\\ud83d\"", "[01]", "{\"a\":1,}"
+    };
+    for (size_t i = 0; i < sizeof(malformed) / sizeof(malformed[0]); i++) {
+        trace = traceJSON(malformed[i], NULL, &valid);
+        if (valid) {
+            printf("Accepted malformed JSON: %s\n", malformed[i]);
+        }
+        CHECK(valid == false);
+        free(trace);
+    }
+
+    //Nesting is limited, so a hostile document can not exhaust the stack
+    char deep[1001];
+    memset(deep, '[', 1000);
+    deep[1000] = '\0';
+    trace = traceJSON(deep, NULL, &valid);
+    CHECK(valid == false);
+    free(trace);
+
+    //A callback returning false stops the reader
+    JSONHandler stop = { .number = stopAtNumber };
+    trace = traceJSON("[\"a\", 1, \"b\"]", &stop, &valid);
+    CHECK(valid == false);
+    CHECK_STRING(trace, "[ string<a> ");
+    free(trace);
+}
+
+/**
+ * testStringList: A list of strings survives strListToJSON/JSONtoStrList, escapes included
+ */
+static void testStringList(void) {
+    const char* values[] = { "plain", "quote \" backslash \\ slash /", "new\nline\ttab", "Zo\xC3\xAB", "" };
+    size_t valueCount = sizeof(values) / sizeof(values[0]);
+
+    List* list = initializeList(printValue, deleteValue, compareValues);
+    for (size_t i = 0; i < valueCount; i++) {
+        insertBack(list, strcpy(malloc(strlen(values[i]) + 1), values[i]));
+    }
+
+    char* json = strListToJSON(list);
+    CHECK_STRING(json, "[\"plain\",\"quote \\\" backslash \\\\ slash /\",\"new\\nline\\ttab\",\"Zo\xC3\xAB\",\"\"]");
+
+    List* imported = JSONtoStrList(json);
+    CHECK(imported != NULL && getLength(imported) == (int)(valueCount));
+    if (imported != NULL) {
+        ListIterator iterator = createIterator(imported);
+        for (size_t i = 0; i < valueCount; i++) {
+            CHECK_STRING(nextElement(&iterator), values[i]);
+        }
+        freeList(imported);
+    }
+
+    CHECK(JSONtoStrList("[\"a\",1]") == NULL);
+    CHECK(JSONtoStrList("{\"a\":\"b\"}") == NULL);
+    CHECK(JSONtoStrList(NULL) == NULL);
+
+    free(json);
+    freeList(list);
+}
+
+/**
+ * testCardRoundTrip: JSONtoCard(cardToJSON(card)) gives back the same card (As far as JSON goes - It has no parameters)
+ * @param fileName: const char* Fixture to read
+ */
+static void testCardRoundTrip(const char* fileName) {
+    Card* card = NULL;
+    CHECK(createCard((char*)fileName, &card) == OK);
+    if (card == NULL) {
+        printf("Could not read %s\n", fileName);
+        return;
+    }
+
+    char* json = cardToJSON(card);
+    Card* imported = JSONtoCard(json);
+    CHECK(imported != NULL);
+    if (imported != NULL) {
+        CHECK(validateCard(imported) == OK);
+
+        char* importedJSON = cardToJSON(imported);
+        CHECK_STRING(importedJSON, json);
+        free(importedJSON);
+
+        //Each part on its own
+        char* fnJSON = propToJSON(card->fn);
+        Property* fn = JSONtoProp(fnJSON);
+        char* importedFnJSON = propToJSON(fn);
+        CHECK_STRING(importedFnJSON, fnJSON);
+        free(fnJSON);
+        free(importedFnJSON);
+        deleteProperty(fn);
+
+        if (card->birthday != NULL) {
+            char* birthdayJSON = dtToJSON(card->birthday);
+            DateTime* birthday = JSONtoDT(birthdayJSON);
+            char* importedBirthdayJSON = dtToJSON(birthday);
+            CHECK_STRING(importedBirthdayJSON, birthdayJSON);
+            free(birthdayJSON);
+            free(importedBirthdayJSON);
+            deleteDate(birthday);
+        }
+
+        deleteCard(imported);
+    }
+
+    free(json);
+    deleteCard(card);
+}
+
+/**
+ * testMalformedCards: JSONtoCard turns away documents that are not cards
+ */
+static void testMalformedCards(void) {
+    const char* malformed[] = {
+        "", "null", "[]", "{\"fn\":", "{\"fn\":null}", "{\"FN\":1}",
+        "{\"fn\":{\"group\":\"\",\"name\":\"FN\",\"values\":[\"Jane\"],\"parameters\":[]},\"optionalProperties\":[1]}"
+    };
+    for (size_t i = 0; i < sizeof(malformed) / sizeof(malformed[0]); i++) {
+        Card* card = JSONtoCard(malformed[i]);
+        if (card != NULL) {
+            printf("Accepted malformed card JSON: %s\n", malformed[i]);
+            deleteCard(card);
+        }
+        CHECK(card == NULL);
+    }
+    CHECK(JSONtoCard(NULL) == NULL);
+}
+
+/**
+ * testFNOnlyCard: JSONtoCard also takes the FN only form the card creation form sends
+ */
+static void testFNOnlyCard(void) {
+    Card* card = JSONtoCard("{\"FN\":\"Jane \\\"JD\\\" Doe\"}");
+    CHECK(card != NULL);
+    if (card != NULL) {
+        CHECK_STRING(card->fn->name, "FN");
+        CHECK_STRING(getFromFront(card->fn->values), "Jane \"JD\" Doe");
+        CHECK(getLength(card->optionalProperties) == 0);
+        CHECK(validateCard(card) == OK);
+        deleteCard(card);
+    }
+}
+
+int main(void) {
+    testReader();
+    testStringList();
+    for (size_t i = 0; i < sizeof(validFixtures) / sizeof(validFixtures[0]); i++) {
+        testCardRoundTrip(validFixtures[i]);
+    }
+    testMalformedCards();
+    testFNOnlyCard();
+    return testSummary("VCardJSONTest");
+}
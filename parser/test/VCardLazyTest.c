@@ -0,0 +1,240 @@
+/**
+ * @file VCardLazyTest.c
+ * @brief This file contains the tests of lazy cards (Scanning a card, and decoding its properties on first access).
+ * @author ADD LATER
+ */
+
+//Needed for getpid under -std=c11
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "VCardParser.h"
+#include "VCardLazy.h"
+#include "VCardPropertyKind.h"
+#include "LinkedListAPI.h"
+#include "VCardTest.h"
+
+//Fixtures holding valid cards (Run from the directory of the makefile)
+static const char* validFixtures[] = {
+    "test/fixtures/testCard.vcf",
+    "test/fixtures/folded.vcf",
+    "test/fixtures/escapes.vcf",
+    "test/fixtures/utf8.vcf"
+};
+
+//The TEL parameter has no '=' - The scan accepts the line, decoding it fails
+static const char malformedParameterCard[] =
+    "BEGIN:VCARD\r\n"
+    "VERSION:4.0\r\n"
+    "FN:Jane\r\n"
+    "TEL;work:+1-555-555-5555\r\n"
+    "EMAIL:jane@example.com\r\n"
+    "END:VCARD\r\n";
+
+/**
+ * checkSameProperty: Checks a decoded property against the one createCard built
+ * @param decoded: Property* from cardGetProperty
+ * @param expected: Property* from createCard
+ */
+static void checkSameProperty(Property* decoded, Property* expected) {
+    CHECK(decoded != NULL);
+    if (decoded == NULL) {
+        return;
+    }
+    char* decodedText = printProperty(decoded);
+    char* expectedText = printProperty(expected);
+    CHECK_STRING(decodedText, expectedText);
+    CHECK(propertyKind(decoded) == propertyKind(expected));
+    free(decodedText);
+    free(expectedText);
+}
+
+/**
+ * testFixture: A lazy card has the same properties, in file order, as the card createCard builds
+ * @param fileName: const char* Fixture to read
+ */
+static void testFixture(const char* fileName) {
+    Card* card = NULL;
+    LazyCard* lazy = NULL;
+    CHECK(createCard((char*)fileName, &card) == OK);
+    CHECK(createLazyCard((char*)fileName, &lazy) == OK);
+    if (card == NULL || lazy == NULL) {
+        printf("Could not read %s\n", fileName);
+        deleteCard(card);
+        deleteLazyCard(lazy);
+        return;
+    }
+
+    //FN, BDAY and ANNIVERSARY are counted along with the optional properties
+    int expectedCount = 1 + getLength(card->optionalProperties) + (card->birthday != NULL) + (card->anniversary != NULL);
+    CHECK(cardPropertyCount(lazy) == expectedCount);
+    CHECK(cardFindProperty(lazy, PROP_FN, 0) == lazy->fnIndex);
+
+    ListIterator iterator = createIterator(card->optionalProperties);
+    for (int i = 0; i < cardPropertyCount(lazy); i++) {
+        PropertyKind kind = cardGetPropertyKind(lazy, i);
+        CHECK(kind != PROP_UNRESOLVED && kind != PROP_UNKNOWN);
+        CHECK(cardFindProperty(lazy, kind, i) == i);
+
+        Property* decoded = cardGetProperty(lazy, i);
+        CHECK(decoded != NULL);
+        CHECK(cardGetProperty(lazy, i) == decoded);
+
+        if (i == lazy->fnIndex) {
+            checkSameProperty(decoded, card->fn);
+        }
+        else if (kind != PROP_BDAY && kind != PROP_ANNIVERSARY) {
+            Property* expected = nextElement(&iterator);
+            CHECK(expected != NULL);
+            if (expected != NULL) {
+                checkSameProperty(decoded, expected);
+            }
+        }
+    }
+    CHECK(nextElement(&iterator) == NULL);
+
+    deleteLazyCard(lazy);
+    deleteCard(card);
+}
+
+/**
+ * testFolded: Folded properties are decoded unfolded, group and parameters included
+ */
+static void testFolded(void) {
+    LazyCard* lazy = NULL;
+    CHECK(createLazyCard("test/fixtures/folded.vcf", &lazy) == OK);
+    if (lazy == NULL) {
+        return;
+    }
+
+    int index = cardFindProperty(lazy, PROP_NOTE, 0);
+    CHECK(index >= 0);
+    Property* note = cardGetProperty(lazy, index);
+    CHECK(note != NULL && getLength(note->values) == 1);
+    CHECK_STRING(note != NULL ? getFromFront(note->values) : NULL,
+                 "This note is long enough that it has to be folded over more than one physical line when it is "
+                 "written back out by writeCard");
+    CHECK(cardFindProperty(lazy, PROP_NOTE, index + 1) == -1);
+
+    index = cardFindProperty(lazy, PROP_ADR, 0);
+    CHECK(index >= 0);
+    Property* address = cardGetProperty(lazy, index);
+    CHECK(address != NULL);
+    if (address != NULL) {
+        CHECK_STRING(address->group, "item1");
+        CHECK_STRING(address->name, "ADR");
+        CHECK(getLength(address->parameters) == 2);
+        CHECK(getLength(address->values) == 7);
+
+        const char* expectedValues[] = { "", "", "12 MainSt", "Springfield", "", "", "USA" };
+        ListIterator iterator = createIterator(address->values);
+        for (size_t i = 0; i < sizeof(expectedValues) / sizeof(expectedValues[0]); i++) {
+            CHECK_STRING(nextElement(&iterator), expectedValues[i]);
+        }
+    }
+
+    deleteLazyCard(lazy);
+}
+
+/**
+ * testMalformedParameters: A property with malformed parameters decodes to NULL, every time, without affecting the
+ * other properties - createCard rejects the same card
+ * @param tempFile: const char* File to write the card to
+ */
+static void testMalformedParameters(const char* tempFile) {
+    FILE* file = fopen(tempFile, "wb");
+    CHECK(file != NULL);
+    if (file == NULL) {
+        return;
+    }
+    fputs(malformedParameterCard, file);
+    fclose(file);
+
+    Card* card = NULL;
+    CHECK(createCard((char*)tempFile, &card) == INV_PROP);
+
+    LazyCard* lazy = NULL;
+    CHECK(createLazyCard((char*)tempFile, &lazy) == OK);
+    if (lazy == NULL) {
+        return;
+    }
+    CHECK(cardPropertyCount(lazy) == 3);
+
+    int index = cardFindProperty(lazy, PROP_TEL, 0);
+    CHECK(index == 1);
+    CHECK(cardGetPropertyKind(lazy, index) == PROP_TEL);
+    CHECK(cardGetProperty(lazy, index) == NULL);
+    CHECK(cardGetProperty(lazy, index) == NULL);
+
+    Property* email = cardGetProperty(lazy, cardFindProperty(lazy, PROP_EMAIL, 0));
+    CHECK_STRING(email != NULL ? getFromFront(email->values) : NULL, "jane@example.com");
+
+    deleteLazyCard(lazy);
+}
+
+/**
+ * testOutOfRange: Indexes outside the card, and a NULL card, give nothing back
+ */
+static void testOutOfRange(void) {
+    LazyCard* lazy = NULL;
+    CHECK(createLazyCard("test/fixtures/escapes.vcf", &lazy) == OK);
+    if (lazy == NULL) {
+        return;
+    }
+
+    int count = cardPropertyCount(lazy);
+    const int indexes[] = { -1, count, count + 1, -1000 };
+    for (size_t i = 0; i < sizeof(indexes) / sizeof(indexes[0]); i++) {
+        CHECK(cardGetPropertyKind(lazy, indexes[i]) == PROP_UNRESOLVED);
+        CHECK(cardGetProperty(lazy, indexes[i]) == NULL);
+    }
+
+    //Searches past the end find nothing, and a negative start searches from the first property
+    CHECK(cardFindProperty(lazy, PROP_FN, count) == -1);
+    CHECK(cardFindProperty(lazy, PROP_FN, -5) == lazy->fnIndex);
+    CHECK(cardFindProperty(lazy, PROP_TEL, 0) == -1);
+
+    deleteLazyCard(lazy);
+
+    CHECK(cardPropertyCount(NULL) == 0);
+    CHECK(cardGetPropertyKind(NULL, 0) == PROP_UNRESOLVED);
+    CHECK(cardFindProperty(NULL, PROP_FN, 0) == -1);
+    CHECK(cardGetProperty(NULL, 0) == NULL);
+    deleteLazyCard(NULL);
+}
+
+/**
+ * testStructureErrors: The scan returns the same errors as createCard for the card's structure
+ */
+static void testStructureErrors(void) {
+    const char* fileNames[] = { "test/fixtures/missingFN.vcf", "test/fixtures/badProperty.vcf",
+                                "test/fixtures/noSuchFile.vcf", "test/fixtures/testCard.txt" };
+    const VCardErrorCode errors[] = { INV_CARD, INV_PROP, INV_FILE, INV_FILE };
+    for (size_t i = 0; i < sizeof(fileNames) / sizeof(fileNames[0]); i++) {
+        LazyCard* lazy = NULL;
+        CHECK(createLazyCard((char*)fileNames[i], &lazy) == errors[i]);
+        CHECK(lazy == NULL);
+
+        Card* card = NULL;
+        CHECK(createCard((char*)fileNames[i], &card) == errors[i]);
+    }
+}
+
+int main(void) {
+    char tempFile[64];
+    sprintf(tempFile, "/tmp/VCardLazyTest-%d.vcf", (int)(getpid()));
+
+    for (size_t i = 0; i < sizeof(validFixtures) / sizeof(validFixtures[0]); i++) {
+        testFixture(validFixtures[i]);
+    }
+    testFolded();
+    testMalformedParameters(tempFile);
+    testOutOfRange();
+    testStructureErrors();
+
+    remove(tempFile);
+    return testSummary("VCardLazyTest");
+}
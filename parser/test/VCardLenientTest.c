@@ -0,0 +1,203 @@
+/**
+ * @file VCardLenientTest.c
+ * @brief This file contains the tests of lenient parsing (Dropping and quarantining bad properties) and of diagnostics.
+ * @author ADD LATER
+ */
+
+//Needed for getpid under -std=c11
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "VCardParser.h"
+#include "HelperFunctions.h"
+#include "VCardDiagnostics.h"
+#include "LinkedListAPI.h"
+#include "VCardTest.h"
+
+//TEL can not be split, N has the wrong number of values and X-CUSTOM is not allowed - The rest of the card is fine
+static const char badPropertiesCard[] =
+    "BEGIN:VCARD\r\n"
+    "VERSION:4.0\r\n"
+    "FN:Lenient\r\n"
+    "TEL;TYPE=work\r\n"
+    "N:Doe;Jane\r\n"
+    "X-CUSTOM:value\r\n"
+    "NOTE:fol\r\n"
+    " ded\r\n"
+    "EMAIL:ok@example.com\r\n"
+    "END:VCARD\r\n";
+
+//The same card without its FN
+static const char missingFNCard[] =
+    "BEGIN:VCARD\r\n"
+    "VERSION:4.0\r\n"
+    "TEL;TYPE=work\r\n"
+    "EMAIL:ok@example.com\r\n"
+    "END:VCARD\r\n";
+
+/**
+ * writeFile: Writes a string into a file
+ * @param fileName: const char* File to write
+ * @param contents: const char* What to write
+ */
+static void writeFile(const char* fileName, const char* contents) {
+    FILE* file = fopen(fileName, "wb");
+    CHECK(file != NULL);
+    if (file != NULL) {
+        fputs(contents, file);
+        fclose(file);
+    }
+}
+
+/**
+ * checkDiagnostic: Checks one diagnostic
+ * @param diagnostic: const Diagnostic* to check
+ * @param lineNumber: int Expected line number
+ * @param propertyName: const char* Expected property name (NULL if the line could not be split)
+ */
+static void checkDiagnostic(const Diagnostic* diagnostic, int lineNumber, const char* propertyName) {
+    CHECK(diagnostic->error == INV_PROP);
+    CHECK(diagnostic->lineNumber == lineNumber);
+    CHECK_STRING(diagnostic->propertyName, propertyName);
+    CHECK(diagnostic->reason != NULL);
+}
+
+/**
+ * checkQuarantine: Checks the lines lenient mode dropped
+ * @param quarantine: List* of dropped lines
+ * @param expectedLines: const char** Expected lines, in file order
+ * @param count: int Number of expected lines
+ */
+static void checkQuarantine(List* quarantine, const char** expectedLines, int count) {
+    CHECK(getLength(quarantine) == count);
+    ListIterator iterator = createIterator(quarantine);
+    for (int i = 0; i < count; i++) {
+        CHECK_STRING(nextElement(&iterator), expectedLines[i]);
+    }
+}
+
+/**
+ * testStrict: Without lenient mode, the first bad property rejects the card - With collectErrors, every one is reported
+ * @param tempFile: const char* File holding badPropertiesCard
+ */
+static void testStrict(char* tempFile) {
+    Card* card = NULL;
+    CHECK(createCard(tempFile, &card) == INV_PROP);
+    CHECK(card == NULL);
+
+    Diagnostics diagnostics;
+    initializeDiagnostics(&diagnostics);
+    ParseOptions options = { .validate = true, .collectErrors = true, .diagnostics = &diagnostics };
+    CHECK(createCardWithOptions(tempFile, &card, &options) == INV_PROP);
+    CHECK(card == NULL);
+    CHECK(diagnostics.count == 3);
+    if (diagnostics.count == 3) {
+        checkDiagnostic(&diagnostics.entries[0], 4, NULL);
+        checkDiagnostic(&diagnostics.entries[1], 5, "N");
+        checkDiagnostic(&diagnostics.entries[2], 6, "X-CUSTOM");
+    }
+    clearDiagnostics(&diagnostics);
+}
+
+/**
+ * testLenient: Lenient mode drops what can not be parsed, and with validate set what is not valid, keeping the card
+ * @param tempFile: const char* File holding badPropertiesCard
+ */
+static void testLenient(char* tempFile) {
+    //Parse errors only - N and X-CUSTOM are kept, as they are only invalid
+    List* quarantine = initializeList(printValue, deleteValue, compareValues);
+    Diagnostics diagnostics;
+    initializeDiagnostics(&diagnostics);
+    ParseOptions options = { .lenient = true, .diagnostics = &diagnostics, .quarantine = quarantine };
+
+    Card* card = NULL;
+    CHECK(createCardWithOptions(tempFile, &card, &options) == OK);
+    CHECK(card != NULL);
+    if (card != NULL) {
+        CHECK(getLength(card->optionalProperties) == 4);
+        CHECK(validateCard(card) == INV_PROP);
+        deleteCard(card);
+    }
+    const char* parseErrorLines[] = { "TEL;TYPE=work" };
+    checkQuarantine(quarantine, parseErrorLines, 1);
+    CHECK(diagnostics.count == 1);
+    if (diagnostics.count == 1) {
+        checkDiagnostic(&diagnostics.entries[0], 4, NULL);
+    }
+    clearDiagnostics(&diagnostics);
+    clearList(quarantine);
+
+    //Validation errors too - What is left is a valid card, and the quarantined lines are kept unfolded
+    options.validate = true;
+    CHECK(createCardWithOptions(tempFile, &card, &options) == OK);
+    CHECK(card != NULL);
+    if (card != NULL) {
+        CHECK(getLength(card->optionalProperties) == 2);
+        CHECK(validateCard(card) == OK);
+        Property* note = getFromFront(card->optionalProperties);
+        CHECK_STRING(note != NULL ? note->name : NULL, "NOTE");
+        CHECK_STRING(note != NULL ? getFromFront(note->values) : NULL, "folded");
+        deleteCard(card);
+    }
+    const char* validationErrorLines[] = { "TEL;TYPE=work", "N:Doe;Jane", "X-CUSTOM:value" };
+    checkQuarantine(quarantine, validationErrorLines, 3);
+    CHECK(diagnostics.count == 3);
+    if (diagnostics.count == 3) {
+        checkDiagnostic(&diagnostics.entries[0], 4, NULL);
+        checkDiagnostic(&diagnostics.entries[1], 5, "N");
+        checkDiagnostic(&diagnostics.entries[2], 6, "X-CUSTOM");
+    }
+    clearDiagnostics(&diagnostics);
+
+    freeList(quarantine);
+}
+
+/**
+ * testCardErrors: Errors that concern the whole card still reject it in lenient mode
+ * @param tempFile: const char* File to write the card to
+ */
+static void testCardErrors(char* tempFile) {
+    writeFile(tempFile, missingFNCard);
+
+    List* quarantine = initializeList(printValue, deleteValue, compareValues);
+    ParseOptions options = { .lenient = true, .validate = true, .quarantine = quarantine };
+    Card* card = NULL;
+    CHECK(createCardWithOptions(tempFile, &card, &options) == INV_CARD);
+    CHECK(card == NULL);
+    freeList(quarantine);
+}
+
+/**
+ * testFileDiagnostics: getFileDiagnostics reports every error as JSON, and [] for a valid card
+ */
+static void testFileDiagnostics(void) {
+    char* json = getFileDiagnostics("test/fixtures/badProperty.vcf");
+    CHECK_STRING(json, "[{\"error\":\"INV_PROP\",\"line\":4,\"offset\":39,\"property\":null,"
+                       "\"reason\":\"Line has no ':' before its value\"}]");
+    free(json);
+
+    json = getFileDiagnostics("test/fixtures/testCard.vcf");
+    CHECK_STRING(json, "[]");
+    free(json);
+
+    json = getFileDiagnostics("test/fixtures/missingFN.vcf");
+    CHECK(json != NULL && strstr(json, "\"error\":\"INV_CARD\"") != NULL);
+    free(json);
+}
+
+int main(void) {
+    char tempFile[64];
+    sprintf(tempFile, "/tmp/VCardLenientTest-%d.vcf", (int)(getpid()));
+
+    writeFile(tempFile, badPropertiesCard);
+    testStrict(tempFile);
+    testLenient(tempFile);
+    testCardErrors(tempFile);
+    testFileDiagnostics();
+
+    remove(tempFile);
+    return testSummary("VCardLenientTest");
+}
@@ -0,0 +1,179 @@
+/**
+ * @file VCardPropertyKindTest.c
+ * @brief This file contains the tests of the property name lookup, and of validating cards built by hand.
+ * @author ADD LATER
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include "VCardParser.h"
+#include "VCardTokenizer.h"
+#include "VCardPropertyKind.h"
+#include "VCardTest.h"
+
+/**
+ * copyString: Copies a string onto the heap
+ * @param string: const char* to copy
+ * @return char*: New string
+ */
+static char* copyString(const char* string) {
+    //NOTE: REMEMBER TO FREE toReturn IN CALLING FUNCTION
+    char* toReturn = malloc(strlen(string) + 1);
+    strcpy(toReturn, string);
+    return toReturn;
+}
+
+/**
+ * buildProperty: Builds a Property the way a caller of the library would, without createProperty
+ * @param name: const char* Property name
+ * @param values: const char* ';' separated values (Split here, not unescaped)
+ * @param kind: PropertyKind to leave in the kind member (Standing in for uninitialized or stale memory)
+ * @return Property*: New Property, freed with deleteProperty
+ */
+static Property* buildProperty(const char* name, const char* values, PropertyKind kind) {
+    Property* prop = malloc(sizeof(Property));
+    prop->name = copyString(name);
+    prop->group = copyString("");
+    prop->parameters = initializeList(printParameter, deleteParameter, compareParameters);
+    prop->values = initializeList(printValue, deleteValue, compareValues);
+    prop->kind = kind;
+
+    char* copy = copyString(values);
+    char* value = copy;
+    while (true) {
+        char* separator = strchr(value, ';');
+        if (separator != NULL) {
+            *separator = '\0';
+        }
+        insertBack(prop->values, copyString(value));
+        if (separator == NULL) {
+            break;
+        }
+        value = separator + 1;
+    }
+    free(copy);
+
+    return prop;
+}
+
+/**
+ * buildCard: Builds a Card around an FN property, without createCard
+ * @param fn: Property* FN of the card
+ * @return Card*: New Card, freed with deleteCard
+ */
+static Card* buildCard(Property* fn) {
+    Card* card = malloc(sizeof(Card));
+    card->fn = fn;
+    card->optionalProperties = initializeList(printProperty, deleteProperty, compareProperties);
+    card->birthday = NULL;
+    card->anniversary = NULL;
+    return card;
+}
+
+/**
+ * testLookup: Every RFC 6350 name hashes to its own kind in any case, and nothing else resolves
+ */
+static void testLookup(void) {
+    for (int kind = PROP_UNKNOWN + 1; kind < PROPERTY_KIND_COUNT; kind++) {
+        const char* name = propertyKindName(kind);
+        CHECK(name != NULL);
+        if (name == NULL) {
+            continue;
+        }
+
+        StringView view = { name, strlen(name) };
+        CHECK(lookupPropertyKind(view) == kind);
+
+        char lower[32];
+        size_t length = strlen(name);
+        for (size_t i = 0; i <= length; i++) {
+            lower[i] = (char)tolower((unsigned char)(name[i]));
+        }
+        StringView lowerView = { lower, length };
+        CHECK(lookupPropertyKind(lowerView) == kind);
+    }
+
+    const char* unknownNames[] = { "", "X-FOO", "FNX", "TELL", "F", "BDAYS", "CLIENTPIDMAPS", "NOT" };
+    for (size_t i = 0; i < sizeof(unknownNames) / sizeof(unknownNames[0]); i++) {
+        StringView view = { unknownNames[i], strlen(unknownNames[i]) };
+        CHECK(lookupPropertyKind(view) == PROP_UNKNOWN);
+    }
+
+    CHECK(PROP_UNRESOLVED == 0);
+    CHECK(propertyKindName(PROP_UNRESOLVED) == NULL);
+    CHECK(propertyKindName(PROP_UNKNOWN) == NULL);
+}
+
+/**
+ * testPropertyKind: The kind member is only a hint - The name decides
+ */
+static void testPropertyKind(void) {
+    Property* prop = buildProperty("fn", "Jane", PROP_UNRESOLVED);
+    CHECK(propertyKind(prop) == PROP_FN);
+
+    //Garbage and stale kinds
+    prop->kind = PROP_TEL;
+    CHECK(propertyKind(prop) == PROP_FN);
+    prop->kind = (PropertyKind)(12345);
+    CHECK(propertyKind(prop) == PROP_FN);
+    prop->kind = (PropertyKind)(-7);
+    CHECK(propertyKind(prop) == PROP_FN);
+
+    //Renamed without touching the kind
+    prop->kind = PROP_FN;
+    free(prop->name);
+    prop->name = copyString("X-FN");
+    CHECK(propertyKind(prop) == PROP_UNKNOWN);
+
+    deleteProperty(prop);
+    CHECK(propertyKind(NULL) == PROP_UNKNOWN);
+}
+
+/**
+ * testHandBuiltCard: validateCard judges a card built by hand by its names, whatever its kind members hold
+ */
+static void testHandBuiltCard(void) {
+    //Zeroed, stale and garbage kinds on valid properties
+    Card* card = buildCard(buildProperty("FN", "Jane Doe", PROP_UNRESOLVED));
+    CHECK(validateCard(card) == OK);
+    insertBack(card->optionalProperties, buildProperty("N", "Doe;Jane;;;", PROP_UNRESOLVED));
+    insertBack(card->optionalProperties, buildProperty("TEL", "tel:+1-555-555-5555", PROP_NOTE));
+    insertBack(card->optionalProperties, buildProperty("Email", "jane@example.com", (PropertyKind)(9999)));
+    CHECK(validateCard(card) == OK);
+    card->fn->kind = PROP_TEL;
+    CHECK(validateCard(card) == OK);
+    deleteCard(card);
+
+    //A property that is not FN in the fn slot, even if its kind claims FN
+    card = buildCard(buildProperty("NOTE", "Jane Doe", PROP_FN));
+    CHECK(validateCard(card) == INV_PROP);
+    deleteCard(card);
+
+    //An unknown name among the optional properties, even if its kind claims NOTE
+    card = buildCard(buildProperty("FN", "Jane Doe", PROP_UNRESOLVED));
+    insertBack(card->optionalProperties, buildProperty("X-NOTE", "Hello", PROP_NOTE));
+    CHECK(validateCard(card) == INV_PROP);
+    deleteCard(card);
+
+    //Value counts come from the name too (N takes exactly 5 values)
+    card = buildCard(buildProperty("FN", "Jane Doe", PROP_UNRESOLVED));
+    insertBack(card->optionalProperties, buildProperty("N", "Doe;Jane", PROP_NOTE));
+    CHECK(validateCard(card) == INV_PROP);
+    deleteCard(card);
+
+    //BDAY belongs in its own member
+    card = buildCard(buildProperty("FN", "Jane Doe", PROP_UNRESOLVED));
+    insertBack(card->optionalProperties, buildProperty("BDAY", "19540203", PROP_NOTE));
+    CHECK(validateCard(card) == INV_DT);
+    deleteCard(card);
+}
+
+int main(void) {
+    testLookup();
+    testPropertyKind();
+    testHandBuiltCard();
+    return testSummary("VCardPropertyKindTest");
+}
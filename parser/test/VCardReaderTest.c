@@ -0,0 +1,289 @@
+/**
+ * @file VCardReaderTest.c
+ * @brief This file contains the tests of the multi-card reader (Sliding and growing its window, and skipping bad cards).
+ * @author ADD LATER
+ */
+
+//Needed for getpid under -std=c11
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "VCardParser.h"
+#include "VCardStringBuilder.h"
+#include "LinkedListAPI.h"
+#include "VCardTest.h"
+
+//Fixtures the export is made of (Run from the directory of the makefile)
+static const char* cardFixtures[] = {
+    "test/fixtures/testCard.vcf",
+    "test/fixtures/folded.vcf",
+    "test/fixtures/utf8.vcf"
+};
+#define FIXTURE_COUNT (sizeof(cardFixtures) / sizeof(cardFixtures[0]))
+
+//Copies of each fixture in the export, and how often a copy gets a long note
+#define COPIES 150
+#define LONG_NOTE_EVERY 10
+
+//Physical lines of a long note - About 100 KB, so one content line is larger than the reader's 64 KB window
+#define LONG_NOTE_LINES 1400
+
+/**
+ * readFixture: Reads a whole fixture into a string
+ * @param fileName: const char* Fixture to read
+ * @return char*: The contents, NULL if the file can not be read. Must be freed by the caller
+ */
+static char* readFixture(const char* fileName) {
+    FILE* file = fopen(fileName, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+
+    StringBuilder text;
+    initializeStringBuilder(&text, 0);
+    char block[512];
+    size_t bytesRead = 0;
+    while ((bytesRead = fread(block, 1, sizeof(block), file)) > 0) {
+        builderAppendBytes(&text, block, bytesRead);
+    }
+    fclose(file);
+
+    return builderFinish(&text);
+}
+
+/**
+ * appendLongNote: Appends a NOTE of about 100 KB, folded every 74 octets
+ * @param text: StringBuilder* to append to
+ */
+static void appendLongNote(StringBuilder* text) {
+    builderAppend(text, "NOTE:");
+    char line[80];
+    for (int i = 0; i < LONG_NOTE_LINES; i++) {
+        sprintf(line, "Line %04d of a note long enough to slide and grow the reader's window.%s", i,
+                i + 1 < LONG_NOTE_LINES ? "\r\n " : "\r\n");
+        builderAppend(text, line);
+    }
+}
+
+/**
+ * withLongNote: Copies a card, adding a long note just before its END:VCARD
+ * @param card: const char* Text of one card, ending in END:VCARD\r\n
+ * @return char*: The new text. Must be freed by the caller
+ */
+static char* withLongNote(const char* card) {
+    size_t bodyLength = strlen(card) - strlen("END:VCARD\r\n");
+
+    StringBuilder text;
+    initializeStringBuilder(&text, 0);
+    builderAppendBytes(&text, card, bodyLength);
+    appendLongNote(&text);
+    builderAppend(&text, card + bodyLength);
+    return builderFinish(&text);
+}
+
+/**
+ * printSingleCard: Parses one card on its own with createCard
+ * @param text: const char* Text of the card
+ * @param tempFile: const char* File to write the card to
+ * @return char*: printCard of the card, NULL if it is not valid. Must be freed by the caller
+ */
+static char* printSingleCard(const char* text, const char* tempFile) {
+    FILE* file = fopen(tempFile, "wb");
+    if (file == NULL) {
+        return NULL;
+    }
+    fputs(text, file);
+    fclose(file);
+
+    Card* card = NULL;
+    if (createCard((char*)tempFile, &card) != OK) {
+        return NULL;
+    }
+    char* printed = printCard(card);
+    deleteCard(card);
+    return printed;
+}
+
+/**
+ * writeExport: Writes COPIES of every fixture (Every LONG_NOTE_EVERY-th with a long note), with two invalid cards in
+ * the middle - One without an FN, and one whose bad property comes before a long note the reader has to skip
+ * @param fileName: const char* File to write
+ * @param cards: char** Text of every card, by fixture then plain/long note
+ * @return bool: true if the file was written
+ */
+static bool writeExport(const char* fileName, char** cards) {
+    FILE* file = fopen(fileName, "wb");
+    if (file == NULL) {
+        return false;
+    }
+
+    for (int i = 0; i < (int)(FIXTURE_COUNT) * COPIES; i++) {
+        if (i == (int)(FIXTURE_COUNT) * COPIES / 2) {
+            StringBuilder invalid;
+            initializeStringBuilder(&invalid, 0);
+            builderAppend(&invalid, "BEGIN:VCARD\r\nVERSION:4.0\r\nNOTE:No FN\r\nEND:VCARD\r\n");
+            builderAppend(&invalid, "BEGIN:VCARD\r\nVERSION:4.0\r\nTEL;TYPE=work\r\n");
+            appendLongNote(&invalid);
+            builderAppend(&invalid, "FN:Skipped\r\nEND:VCARD\r\n");
+            char* text = builderFinish(&invalid);
+            fputs(text, file);
+            free(text);
+        }
+        fputs(cards[(i % FIXTURE_COUNT) * 2 + (i % LONG_NOTE_EVERY == 0)], file);
+    }
+
+    fclose(file);
+    return true;
+}
+
+/**
+ * testExport: Every card of a large export reads back the same as it does on its own, and the invalid cards in the
+ * middle are reported and skipped without losing the cards after them
+ * @param tempFile: const char* File to write the export to
+ * @param cardFile: const char* File to write single cards to
+ */
+static void testExport(const char* tempFile, const char* cardFile) {
+    char* cards[FIXTURE_COUNT * 2] = { NULL };
+    char* expected[FIXTURE_COUNT * 2] = { NULL };
+    for (size_t i = 0; i < FIXTURE_COUNT; i++) {
+        cards[i * 2] = readFixture(cardFixtures[i]);
+        CHECK(cards[i * 2] != NULL);
+        if (cards[i * 2] == NULL) {
+            printf("Could not read %s\n", cardFixtures[i]);
+            return;
+        }
+        cards[i * 2 + 1] = withLongNote(cards[i * 2]);
+    }
+    for (size_t i = 0; i < FIXTURE_COUNT * 2; i++) {
+        expected[i] = printSingleCard(cards[i], cardFile);
+        CHECK(expected[i] != NULL);
+    }
+    CHECK(writeExport(tempFile, cards));
+
+    VCardReader* reader = NULL;
+    CHECK(openVCardReader(tempFile, &reader) == OK);
+    if (reader != NULL) {
+        int count = 0;
+        int mismatches = 0;
+        VCardErrorCode errors[4];
+        int errorPositions[4];
+        int errorCount = 0;
+        while (true) {
+            Card* card = NULL;
+            VCardErrorCode error = nextCard(reader, &card);
+            if (error != OK) {
+                CHECK(card == NULL);
+                if (errorCount < 4) {
+                    errors[errorCount] = error;
+                    errorPositions[errorCount] = count;
+                }
+                errorCount++;
+                continue;
+            }
+            if (card == NULL) {
+                break;
+            }
+
+            char* printed = printCard(card);
+            const char* expectedCard = expected[(count % FIXTURE_COUNT) * 2 + (count % LONG_NOTE_EVERY == 0)];
+            if (expectedCard == NULL || strcmp(printed, expectedCard) != 0) {
+                mismatches++;
+            }
+            free(printed);
+            deleteCard(card);
+            count++;
+        }
+        closeVCardReader(reader);
+
+        CHECK(count == (int)(FIXTURE_COUNT) * COPIES);
+        CHECK(mismatches == 0);
+        CHECK(errorCount == 2);
+        if (errorCount == 2) {
+            CHECK(errors[0] == INV_CARD && errorPositions[0] == (int)(FIXTURE_COUNT) * COPIES / 2);
+            CHECK(errors[1] == INV_PROP && errorPositions[1] == (int)(FIXTURE_COUNT) * COPIES / 2);
+        }
+    }
+
+    //Lenient mode keeps the card with the bad property, long note and all
+    reader = NULL;
+    CHECK(openVCardReader(tempFile, &reader) == OK);
+    if (reader != NULL) {
+        ParseOptions options = { .lenient = true };
+        int count = 0;
+        int errorCount = 0;
+        bool foundSkipped = false;
+        while (true) {
+            Card* card = NULL;
+            if (nextCardWithOptions(reader, &card, &options) != OK) {
+                errorCount++;
+                continue;
+            }
+            if (card == NULL) {
+                break;
+            }
+            if (strcmp(getFromFront(card->fn->values), "Skipped") == 0) {
+                foundSkipped = true;
+                Property* note = getFromFront(card->optionalProperties);
+                CHECK(note != NULL && strlen(getFromFront(note->values)) > 65536);
+            }
+            deleteCard(card);
+            count++;
+        }
+        closeVCardReader(reader);
+
+        CHECK(count == (int)(FIXTURE_COUNT) * COPIES + 1);
+        CHECK(errorCount == 1);
+        CHECK(foundSkipped);
+    }
+
+    for (size_t i = 0; i < FIXTURE_COUNT * 2; i++) {
+        free(cards[i]);
+        free(expected[i]);
+    }
+}
+
+/**
+ * testOpenErrors: Files that can not be read as vCards are turned away, and a file with no cards reads as empty
+ * @param tempFile: const char* File to write to
+ */
+static void testOpenErrors(const char* tempFile) {
+    VCardReader* reader = NULL;
+    CHECK(openVCardReader("test/fixtures/testCard.txt", &reader) == INV_FILE);
+    CHECK(reader == NULL);
+    CHECK(openVCardReader("test/fixtures/noSuchFile.vcf", &reader) == INV_FILE);
+    CHECK(reader == NULL);
+    CHECK(openVCardReader(NULL, &reader) == INV_FILE);
+
+    Card* card = NULL;
+    CHECK(nextCard(NULL, &card) == OTHER_ERROR);
+    CHECK(card == NULL);
+
+    FILE* file = fopen(tempFile, "wb");
+    CHECK(file != NULL);
+    if (file != NULL) {
+        fclose(file);
+    }
+    CHECK(openVCardReader(tempFile, &reader) == OK);
+    if (reader != NULL) {
+        CHECK(nextCard(reader, &card) == OK);
+        CHECK(card == NULL);
+        closeVCardReader(reader);
+    }
+}
+
+int main(void) {
+    char tempFile[64];
+    char cardFile[64];
+    sprintf(tempFile, "/tmp/VCardReaderTest-%d.vcf", (int)(getpid()));
+    sprintf(cardFile, "/tmp/VCardReaderTest-%d-card.vcf", (int)(getpid()));
+
+    testExport(tempFile, cardFile);
+    testOpenErrors(tempFile);
+
+    remove(tempFile);
+    remove(cardFile);
+    return testSummary("VCardReaderTest");
+}
@@ -0,0 +1,276 @@
+/**
+ * @file VCardRoundTripTest.c
+ * @brief This file contains the tests of writing cards (Escaping and folding), and of reading written cards back.
+ * @author ADD LATER
+ */
+
+//Needed for getpid under -std=c11
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "VCardParser.h"
+#include "LinkedListAPI.h"
+#include "VCardTest.h"
+
+//Fixtures holding valid cards (Run from the directory of the makefile)
+static const char* validFixtures[] = {
+    "test/fixtures/testCard.vcf",
+    "test/fixtures/folded.vcf",
+    "test/fixtures/escapes.vcf",
+    "test/fixtures/utf8.vcf"
+};
+
+//Physical line limit of RFC 6350 section 3.2, without the \r\n
+#define FOLD_LIMIT 75
+
+/**
+ * findProperty: Grabs the first optional property with a name
+ * @param card: Card* to search
+ * @param name: const char* Property name
+ * @return Property*: The property (Owned by the card), NULL if there is no such property
+ */
+static Property* findProperty(Card* card, const char* name) {
+    ListIterator iterator = createIterator(card->optionalProperties);
+    Property* prop = NULL;
+    while ((prop = nextElement(&iterator)) != NULL) {
+        if (strcmp(prop->name, name) == 0) {
+            return prop;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * findValue: Grabs the first value of the first optional property with a name
+ * @param card: Card* to search
+ * @param name: const char* Property name
+ * @return char*: The value (Owned by the card), NULL if there is no such property
+ */
+static char* findValue(Card* card, const char* name) {
+    Property* prop = findProperty(card, name);
+    return prop != NULL ? getFromFront(prop->values) : NULL;
+}
+
+/**
+ * checkFolding: Checks every physical line of card text against the fold limit
+ * Continuation lines must start with one space, and must not start inside a UTF-8 character
+ * @param text: const char* Card text
+ * @return bool: true if every line is folded correctly
+ */
+static bool checkFolding(const char* text) {
+    const char* line = text;
+    while (*line != '\0') {
+        const char* end = strstr(line, "\r\n");
+        if (end == NULL || (size_t)(end - line) > FOLD_LIMIT) {
+            return false;
+        }
+        if (line[0] == ' ' && ((unsigned char)(line[1]) & 0xC0) == 0x80) {
+            return false;
+        }
+        line = end + 2;
+    }
+    return true;
+}
+
+/**
+ * testFixtureRoundTrip: A written card reads back as the same card, and is written the same way again (The fixture is
+ * also parsed mapped, which must give the same card)
+ * @param fileName: const char* Fixture to read
+ * @param tempFile: const char* File to write the card to
+ */
+static void testFixtureRoundTrip(const char* fileName, const char* tempFile) {
+    Card* card = NULL;
+    CHECK(createCard((char*)fileName, &card) == OK);
+    if (card == NULL) {
+        printf("Could not read %s\n", fileName);
+        return;
+    }
+
+    char* text = NULL;
+    size_t length = 0;
+    CHECK(serializeCard(card, &text, &length) == OK);
+    CHECK(text != NULL && strlen(text) == length);
+    CHECK(text != NULL && checkFolding(text));
+
+    //A mapped file parses the same as one read onto the heap
+    ParseOptions mapped = { .mapFile = true };
+    Card* mappedCard = NULL;
+    CHECK(createCardWithOptions((char*)fileName, &mappedCard, &mapped) == OK);
+    if (mappedCard != NULL) {
+        char* printed = printCard(card);
+        char* mappedPrinted = printCard(mappedCard);
+        CHECK_STRING(mappedPrinted, printed);
+        free(printed);
+        free(mappedPrinted);
+        deleteCard(mappedCard);
+    }
+
+    WriteOptions atomic = { .atomic = true, .sync = false };
+    const WriteOptions* writeOptions[] = { NULL, &atomic };
+    for (size_t i = 0; i < sizeof(writeOptions) / sizeof(writeOptions[0]); i++) {
+        CHECK(writeCardWithOptions(tempFile, card, writeOptions[i]) == OK);
+
+        Card* reread = NULL;
+        CHECK(createCard((char*)tempFile, &reread) == OK);
+        if (reread == NULL) {
+            continue;
+        }
+        CHECK(validateCard(reread) == OK);
+
+        char* rereadText = NULL;
+        size_t rereadLength = 0;
+        CHECK(serializeCard(reread, &rereadText, &rereadLength) == OK);
+        CHECK_STRING(rereadText, text);
+
+        char* printed = printCard(card);
+        char* rereadPrinted = printCard(reread);
+        CHECK_STRING(rereadPrinted, printed);
+
+        free(printed);
+        free(rereadPrinted);
+        free(rereadText);
+        deleteCard(reread);
+    }
+
+    free(text);
+    deleteCard(card);
+}
+
+/**
+ * testEscaping: Values are written with \\, \; and \n escaped, and read back unescaped
+ * @param tempFile: const char* File to write the card to
+ */
+static void testEscaping(const char* tempFile) {
+    Card* card = NULL;
+    CHECK(createCard("test/fixtures/escapes.vcf", &card) == OK);
+    if (card == NULL) {
+        return;
+    }
+    CHECK_STRING(getFromFront(card->fn->values), "Smith, John; Jr.");
+    CHECK_STRING(findValue(card, "NOTE"), "Line one\nLine two\nthree\\four,five");
+
+    char* text = NULL;
+    size_t length = 0;
+    CHECK(serializeCard(card, &text, &length) == OK);
+    CHECK(text != NULL && strstr(text, "\r\nFN:Smith, John\\; Jr.\r\n") != NULL);
+    CHECK(text != NULL && strstr(text, "\r\nNOTE:Line one\\nLine two\\nthree\\\\four,five\r\n") != NULL);
+    CHECK(text != NULL && strstr(text, "\r\nN:Smith;John;;Jr.\\;III;\r\n") != NULL);
+    free(text);
+
+    CHECK(writeCard(tempFile, card) == OK);
+    Card* reread = NULL;
+    CHECK(createCard((char*)tempFile, &reread) == OK);
+    if (reread != NULL) {
+        CHECK_STRING(getFromFront(reread->fn->values), "Smith, John; Jr.");
+        CHECK_STRING(findValue(reread, "NOTE"), "Line one\nLine two\nthree\\four,five");
+        deleteCard(reread);
+    }
+
+    deleteCard(card);
+}
+
+/**
+ * testFolding: Long values are folded at 75 octets without splitting UTF-8 characters, and unfolded when read back
+ * @param tempFile: const char* File to write the card to
+ */
+static void testFolding(const char* tempFile) {
+    Card* card = NULL;
+    CHECK(createCard("test/fixtures/utf8.vcf", &card) == OK);
+    if (card == NULL) {
+        return;
+    }
+
+    //Give the note a second value that needs several continuation lines, with a ';' to escape in the middle
+    char longNote[301];
+    memset(longNote, 'a', 300);
+    longNote[300] = '\0';
+    longNote[149] = ';';
+    Property* note = findProperty(card, "NOTE");
+    CHECK(note != NULL);
+    char* japanese = NULL;
+    if (note != NULL) {
+        japanese = getFromFront(note->values);
+        japanese = strcpy(malloc(strlen(japanese) + 1), japanese);
+        insertBack(note->values, strcpy(malloc(sizeof(longNote)), longNote));
+    }
+
+    char* text = NULL;
+    size_t length = 0;
+    CHECK(serializeCard(card, &text, &length) == OK);
+    CHECK(text != NULL && checkFolding(text));
+    free(text);
+
+    CHECK(writeCard(tempFile, card) == OK);
+    Card* reread = NULL;
+    CHECK(createCard((char*)tempFile, &reread) == OK);
+    if (reread != NULL) {
+        CHECK_STRING(findValue(reread, "NOTE"), japanese);
+        Property* rereadNote = findProperty(reread, "NOTE");
+        CHECK(rereadNote != NULL && getLength(rereadNote->values) == 2);
+        CHECK_STRING(rereadNote != NULL ? getFromBack(rereadNote->values) : NULL, longNote);
+        CHECK_STRING(findValue(reread, "TITLE"), "Ärztin für Allgemeinmedizin und Naturheilverfahren in München-Schwabing");
+        deleteCard(reread);
+    }
+
+    free(japanese);
+    deleteCard(card);
+}
+
+/**
+ * testContinuationBytes: A value of stray UTF-8 continuation bytes (Accepted by the parser) is still folded and
+ * written back byte for byte
+ * @param tempFile: const char* File to write the card to
+ */
+static void testContinuationBytes(const char* tempFile) {
+    char value[101];
+    memset(value, 0x80, 100);
+    value[100] = '\0';
+
+    FILE* file = fopen(tempFile, "wb");
+    CHECK(file != NULL);
+    if (file == NULL) {
+        return;
+    }
+    fprintf(file, "BEGIN:VCARD\r\nVERSION:4.0\r\nFN:%s\r\nEND:VCARD\r\n", value);
+    fclose(file);
+
+    Card* card = NULL;
+    CHECK(createCard((char*)tempFile, &card) == OK);
+    if (card == NULL) {
+        return;
+    }
+
+    char* text = NULL;
+    size_t length = 0;
+    CHECK(serializeCard(card, &text, &length) == OK);
+    CHECK(text != NULL && length < 200);
+    free(text);
+
+    CHECK(writeCard(tempFile, card) == OK);
+    Card* reread = NULL;
+    CHECK(createCard((char*)tempFile, &reread) == OK);
+    if (reread != NULL) {
+        CHECK_STRING(getFromFront(reread->fn->values), value);
+        deleteCard(reread);
+    }
+
+    deleteCard(card);
+}
+
+int main(void) {
+    char tempFile[64];
+    sprintf(tempFile, "/tmp/VCardRoundTripTest-%d.vcf", (int)(getpid()));
+
+    for (size_t i = 0; i < sizeof(validFixtures) / sizeof(validFixtures[0]); i++) {
+        testFixtureRoundTrip(validFixtures[i], tempFile);
+    }
+    testEscaping(tempFile);
+    testFolding(tempFile);
+    testContinuationBytes(tempFile);
+
+    remove(tempFile);
+    return testSummary("VCardRoundTripTest");
+}
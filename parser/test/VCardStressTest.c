@@ -0,0 +1,241 @@
+/**
+ * @file VCardStressTest.c
+ * @brief This file contains the parser's concurrency stress test, used to check that the parser is reentrant.
+ * Build and run it with "make stress" (Built with -fsanitize=thread, so any data race is reported)
+ * @author ADD LATER
+ */
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <dirent.h>
+#include "VCardParser.h"
+#include "HelperFunctions.h"
+#include "VCardBatch.h"
+
+/**
+ * What one file gives single threaded - Every thread must get exactly the same
+ */
+typedef struct expectedResult {
+    char* fileName;
+    VCardErrorCode createError;
+    VCardErrorCode validateError;
+
+    //NULL where the call returns NULL (Or the card could not be created)
+    char* cardJSON;
+    char* reparsedJSON;
+    char* fileLog;
+    char* cardView;
+    char* diagnostics;
+} ExpectedResult;
+
+/**
+ * Shared by every thread
+ */
+typedef struct stressTest {
+    ExpectedResult* expected;
+    int fileCount;
+    int iterations;
+    char* directory;
+    char* directoryLog;
+    atomic_int mismatches;
+} StressTest;
+
+/**
+ * Arguments of one thread
+ */
+typedef struct stressThread {
+    StressTest* test;
+    int index;
+    pthread_t thread;
+} StressThread;
+
+/**
+ * sameString: Compares two results that may be NULL
+ * @param first: const char* Result (May be NULL)
+ * @param second: const char* Result (May be NULL)
+ * @return bool: true if both are NULL or both hold the same text
+ */
+static bool sameString(const char* first, const char* second) {
+    if (first == NULL || second == NULL) {
+        return first == second;
+    }
+    return strcmp(first, second) == 0;
+}
+
+/**
+ * runFile: Runs every parser entry point on one file
+ * @param fileName: char* File to parse
+ * @param result: ExpectedResult* to store the results into (Freed with clearResult)
+ */
+static void runFile(char* fileName, ExpectedResult* result) {
+    Card* card = NULL;
+    result->fileName = fileName;
+    result->createError = createCard(fileName, &card);
+    result->validateError = OK;
+    result->cardJSON = NULL;
+    result->reparsedJSON = NULL;
+
+    if (card != NULL) {
+        result->validateError = validateCard(card);
+        result->cardJSON = cardToJSON(card);
+
+        //Only FN survives the JSON, so the reparsed card is compared by its own JSON
+        Card* reparsed = JSONtoCard(result->cardJSON);
+        if (reparsed != NULL) {
+            result->reparsedJSON = cardToJSON(reparsed);
+            deleteCard(reparsed);
+        }
+        deleteCard(card);
+    }
+
+    result->fileLog = getFileLog(fileName);
+    result->cardView = getCardView(fileName);
+    result->diagnostics = getFileDiagnostics(fileName);
+}
+
+/**
+ * clearResult: Frees the results of runFile
+ * @param result: ExpectedResult* to free the results of
+ */
+static void clearResult(ExpectedResult* result) {
+    free(result->cardJSON);
+    free(result->reparsedJSON);
+    free(result->fileLog);
+    free(result->cardView);
+    free(result->diagnostics);
+}
+
+/**
+ * sameResult: Compares the results of two runs of the same file
+ * @param first: const ExpectedResult* Result
+ * @param second: const ExpectedResult* Result
+ * @return bool: true if every result is the same
+ */
+static bool sameResult(const ExpectedResult* first, const ExpectedResult* second) {
+    return first->createError == second->createError && first->validateError == second->validateError
+        && sameString(first->cardJSON, second->cardJSON) && sameString(first->reparsedJSON, second->reparsedJSON)
+        && sameString(first->fileLog, second->fileLog) && sameString(first->cardView, second->cardView)
+        && sameString(first->diagnostics, second->diagnostics);
+}
+
+/**
+ * runStressThread: Parses every file over and over, each thread starting at a different file
+ * @param argument: void* The StressThread
+ * @return void*: NULL
+ */
+static void* runStressThread(void* argument) {
+    StressThread* self = argument;
+    StressTest* test = self->test;
+
+    for (int i = 0; i < test->iterations; i++) {
+        for (int j = 0; j < test->fileCount; j++) {
+            ExpectedResult* expected = &test->expected[(j + self->index) % test->fileCount];
+            ExpectedResult result;
+            runFile(expected->fileName, &result);
+            if (sameResult(expected, &result) == false) {
+                printf("Thread %d: %s parsed differently\n", self->index, expected->fileName);
+                atomic_fetch_add(&test->mismatches, 1);
+            }
+            clearResult(&result);
+        }
+
+        //The batch parser runs its own threads inside this one
+        char* directoryLog = parseDirectory(test->directory, 2);
+        if (sameString(directoryLog, test->directoryLog) == false) {
+            printf("Thread %d: %s parsed differently as a directory\n", self->index, test->directory);
+            atomic_fetch_add(&test->mismatches, 1);
+        }
+        free(directoryLog);
+    }
+
+    return NULL;
+}
+
+/**
+ * compareNames: qsort comparison for file names
+ */
+static int compareNames(const void* first, const void* second) {
+    return strcmp(*(char* const*)first, *(char* const*)second);
+}
+
+int main(int argc, char** argv) {
+    if (argc != 4) {
+        printf("Usage: %s threads iterations fixtureDirectory\n", argv[0]);
+        return 1;
+    }
+
+    int threadCount = atoi(argv[1]);
+    StressTest test;
+    test.iterations = atoi(argv[2]);
+    test.directory = argv[3];
+    atomic_init(&test.mismatches, 0);
+    if (threadCount < 1 || test.iterations < 1) {
+        printf("threads and iterations must be at least 1\n");
+        return 1;
+    }
+
+    //Collect the fixtures
+    DIR* directory = opendir(test.directory);
+    if (directory == NULL) {
+        printf("Can not open %s\n", test.directory);
+        return 1;
+    }
+    char** fileNames = NULL;
+    test.fileCount = 0;
+    struct dirent* entry = NULL;
+    while ((entry = readdir(directory)) != NULL) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        fileNames = realloc(fileNames, (size_t)(test.fileCount + 1) * sizeof(char*));
+        fileNames[test.fileCount] = malloc(strlen(test.directory) + strlen(entry->d_name) + 2);
+        sprintf(fileNames[test.fileCount], "%s/%s", test.directory, entry->d_name);
+        test.fileCount++;
+    }
+    closedir(directory);
+    if (test.fileCount == 0) {
+        printf("No fixtures in %s\n", test.directory);
+        return 1;
+    }
+    qsort(fileNames, (size_t)(test.fileCount), sizeof(char*), compareNames);
+
+    //Single threaded results first
+    test.expected = malloc((size_t)(test.fileCount) * sizeof(ExpectedResult));
+    for (int i = 0; i < test.fileCount; i++) {
+        runFile(fileNames[i], &test.expected[i]);
+    }
+    test.directoryLog = parseDirectory(test.directory, 2);
+
+    StressThread* threads = malloc((size_t)(threadCount) * sizeof(StressThread));
+    for (int i = 0; i < threadCount; i++) {
+        threads[i].test = &test;
+        threads[i].index = i;
+        if (pthread_create(&threads[i].thread, NULL, runStressThread, &threads[i]) != 0) {
+            printf("Could not create thread %d\n", i);
+            return 1;
+        }
+    }
+    for (int i = 0; i < threadCount; i++) {
+        pthread_join(threads[i].thread, NULL);
+    }
+
+    int mismatches = atomic_load(&test.mismatches);
+    printf("Stress test: %d threads x %d iterations over %d files, %d mismatches\n",
+           threadCount, test.iterations, test.fileCount, mismatches);
+
+    for (int i = 0; i < test.fileCount; i++) {
+        clearResult(&test.expected[i]);
+        free(fileNames[i]);
+    }
+    free(test.expected);
+    free(test.directoryLog);
+    free(fileNames);
+    free(threads);
+
+    return mismatches == 0 ? 0 : 1;
+}
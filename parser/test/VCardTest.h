@@ -0,0 +1,53 @@
+/**
+ * @file VCardTest.h
+ * @brief This file contains the checks shared by the parser's test programs (Built and run with "make test").
+ * @author ADD LATER
+ */
+
+#ifndef ASSIGNMENT_1_VCARDTEST_H
+#define ASSIGNMENT_1_VCARDTEST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+//Number of failed checks in the test program
+static int testFailures = 0;
+
+/**
+ * CHECK: Reports a failed condition with its file and line, and counts it
+ */
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("%s:%d: Check failed: %s\n", __FILE__, __LINE__, #condition); \
+            testFailures++; \
+        } \
+    } while (0)
+
+/**
+ * CHECK_STRING: Reports two strings that differ (Either may be NULL), and counts it
+ */
+#define CHECK_STRING(actual, expected) \
+    do { \
+        const char* checkActual = (actual); \
+        const char* checkExpected = (expected); \
+        if (checkActual == NULL || checkExpected == NULL ? checkActual != checkExpected : strcmp(checkActual, checkExpected) != 0) { \
+            printf("%s:%d: Check failed: %s is \"%s\", expected \"%s\"\n", __FILE__, __LINE__, #actual, \
+                   checkActual != NULL ? checkActual : "(null)", checkExpected != NULL ? checkExpected : "(null)"); \
+            testFailures++; \
+        } \
+    } while (0)
+
+/**
+ * testSummary: Prints the result of a test program
+ * @param testName: const char* Name of the test program
+ * @return int: Exit code of the test program - 0 if every check passed
+ */
+static inline int testSummary(const char* testName) {
+    printf("%s: %s\n", testName, testFailures == 0 ? "passed" : "FAILED");
+    return testFailures == 0 ? 0 : 1;
+}
+
+#endif //ASSIGNMENT_1_VCARDTEST_H
@@ -0,0 +1,231 @@
+/**
+ * @file VCardTokenizerTest.c
+ * @brief This file contains the tests of the tokenizer (Unfolding and splitting content lines) and of the multi-card reader.
+ * @author ADD LATER
+ */
+
+//Needed for getpid under -std=c11
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "VCardParser.h"
+#include "VCardTokenizer.h"
+#include "LinkedListAPI.h"
+#include "VCardTest.h"
+
+//Folded with a space and with a tab, with an empty line between two content lines
+static const char foldedInput[] =
+    "BEGIN:VCARD\r\n"
+    "FN:Ja\r\n"
+    " ne\r\n"
+    "\t Doe\r\n"
+    "\r\n"
+    "NOTE:one\r\n"
+    "END:VCARD\r\n";
+
+/**
+ * viewEquals: Compares a view to a string, case included
+ * @param view: StringView to compare
+ * @param string: const char* to compare to
+ * @return bool: true if they hold the same bytes
+ */
+static bool viewEquals(StringView view, const char* string) {
+    return view.length == strlen(string) && memcmp(view.start, string, view.length) == 0;
+}
+
+/**
+ * checkFoldedLines: Reads foldedInput through a tokenizer, checking every unfolded line
+ * @param tokenizer: Tokenizer* initialized over foldedInput (Or a copy of it)
+ */
+static void checkFoldedLines(Tokenizer* tokenizer) {
+    const char* expectedLines[] = { "BEGIN:VCARD", "FN:Jane Doe", "NOTE:one", "END:VCARD" };
+    const int expectedLineNumbers[] = { 1, 2, 6, 7 };
+    const size_t expectedOffsets[] = { 0, 13, 34, 44 };
+
+    ContentLine line;
+    for (size_t i = 0; i < sizeof(expectedLines) / sizeof(expectedLines[0]); i++) {
+        CHECK(nextContentLine(tokenizer, &line) == TOKEN_LINE);
+        CHECK(viewEquals(line.line, expectedLines[i]));
+        CHECK(line.lineNumber == expectedLineNumbers[i]);
+        CHECK(line.byteOffset == expectedOffsets[i]);
+    }
+    CHECK(nextContentLine(tokenizer, &line) == TOKEN_END);
+    CHECK(hasMoreContent(tokenizer) == false);
+}
+
+/**
+ * testUnfolding: Folded lines are unfolded the same way in read-only and writable buffers
+ */
+static void testUnfolding(void) {
+    Tokenizer tokenizer;
+
+    //Read-only - The buffer must not change
+    char* readOnly = strcpy(malloc(sizeof(foldedInput)), foldedInput);
+    initializeTokenizer(&tokenizer, readOnly, sizeof(foldedInput) - 1);
+    checkFoldedLines(&tokenizer);
+    clearTokenizer(&tokenizer);
+    CHECK_STRING(readOnly, foldedInput);
+    free(readOnly);
+
+    //Writable - Unfolded in place
+    char* writable = strcpy(malloc(sizeof(foldedInput)), foldedInput);
+    initializeWritableTokenizer(&tokenizer, writable, sizeof(foldedInput) - 1);
+    checkFoldedLines(&tokenizer);
+    clearTokenizer(&tokenizer);
+    free(writable);
+
+    //A line handed back is returned again
+    initializeTokenizer(&tokenizer, foldedInput, sizeof(foldedInput) - 1);
+    ContentLine line;
+    ContentLine again;
+    CHECK(nextContentLine(&tokenizer, &line) == TOKEN_LINE);
+    unreadContentLine(&tokenizer, &line);
+    CHECK(nextContentLine(&tokenizer, &again) == TOKEN_LINE);
+    CHECK(viewEquals(again.line, "BEGIN:VCARD"));
+    clearTokenizer(&tokenizer);
+}
+
+/**
+ * testLineBreaks: A \r without \n, or a \n without \r, is an error the tokenizer reads past
+ */
+static void testLineBreaks(void) {
+    const char input[] = "FN:a\nNOTE:b\r\nTEL:c\rd\r\n";
+    Tokenizer tokenizer;
+    ContentLine line;
+
+    initializeTokenizer(&tokenizer, input, sizeof(input) - 1);
+    CHECK(nextContentLine(&tokenizer, &line) == TOKEN_ERROR);
+    CHECK(nextContentLine(&tokenizer, &line) == TOKEN_LINE);
+    CHECK(viewEquals(line.line, "NOTE:b"));
+    CHECK(nextContentLine(&tokenizer, &line) == TOKEN_ERROR);
+    clearTokenizer(&tokenizer);
+
+    //The last line may end without a line break
+    const char unterminated[] = "FN:a\r\nEND:VCARD";
+    initializeTokenizer(&tokenizer, unterminated, sizeof(unterminated) - 1);
+    CHECK(nextContentLine(&tokenizer, &line) == TOKEN_LINE);
+    CHECK(nextContentLine(&tokenizer, &line) == TOKEN_LINE);
+    CHECK(viewEquals(line.line, "END:VCARD"));
+    CHECK(nextContentLine(&tokenizer, &line) == TOKEN_END);
+    clearTokenizer(&tokenizer);
+}
+
+/**
+ * testSplitting: Content lines split into group, name, parameters and values, with quoted sections skipped
+ */
+static void testSplitting(void) {
+    const char input[] = "item1.ADR;TYPE=\"a:b;c\";X=y:;;1 Main\\;St;x\r\nFN;:Jane\r\nTEL;TYPE=work\r\n";
+    Tokenizer tokenizer;
+    ContentLine line;
+    initializeTokenizer(&tokenizer, input, sizeof(input) - 1);
+
+    CHECK(nextContentLine(&tokenizer, &line) == TOKEN_LINE);
+    CHECK(splitContentLine(&line) == OK);
+    CHECK(viewEquals(line.group, "item1"));
+    CHECK(viewEquals(line.name, "ADR"));
+    CHECK(line.hasParameters);
+    CHECK(viewEquals(line.parameters, "TYPE=\"a:b;c\";X=y"));
+    CHECK(viewEquals(line.values, ";;1 Main\\;St;x"));
+
+    //Parameters, with the quoted ';' kept inside its section
+    StringView remaining = line.parameters;
+    StringView section;
+    CHECK(nextViewSection(&remaining, ';', true, &section) && viewEquals(section, "TYPE=\"a:b;c\""));
+    CHECK(nextViewSection(&remaining, ';', true, &section) && viewEquals(section, "X=y"));
+    CHECK(nextViewSection(&remaining, ';', true, &section) == false);
+
+    //Values, with the escaped ';' kept inside its value and empty values kept
+    const char* expectedValues[] = { "", "", "1 Main\\;St", "x" };
+    remaining = line.values;
+    for (size_t i = 0; i < sizeof(expectedValues) / sizeof(expectedValues[0]); i++) {
+        CHECK(nextValueSection(&remaining, &section) && viewEquals(section, expectedValues[i]));
+    }
+    CHECK(nextValueSection(&remaining, &section) == false);
+
+    //An empty parameter section is still a parameter section
+    CHECK(nextContentLine(&tokenizer, &line) == TOKEN_LINE);
+    CHECK(splitContentLine(&line) == OK);
+    CHECK(line.group.length == 0);
+    CHECK(viewEquals(line.name, "FN"));
+    CHECK(line.hasParameters && line.parameters.length == 0);
+    CHECK(viewEquals(line.values, "Jane"));
+
+    //No ':' before the values
+    CHECK(nextContentLine(&tokenizer, &line) == TOKEN_LINE);
+    CHECK(splitContentLine(&line) == INV_PROP);
+
+    clearTokenizer(&tokenizer);
+}
+
+/**
+ * testReader: A file of many folded cards is read card by card across the reader's buffer refills
+ * @param tempFile: const char* File to write the cards to
+ */
+static void testReader(const char* tempFile) {
+    const int cardCount = 2000;
+
+    FILE* file = fopen(tempFile, "wb");
+    CHECK(file != NULL);
+    if (file == NULL) {
+        return;
+    }
+    for (int i = 0; i < cardCount; i++) {
+        //Every card has a broken card after it - The reader skips it and carries on
+        fprintf(file, "BEGIN:VCARD\r\nVERSION:4.0\r\nFN:Card\r\n  %d\r\nNOTE:", i);
+        for (int j = 0; j < 4; j++) {
+            fprintf(file, "%s\r\n ", "A note long enough to be folded over several physical lines");
+        }
+        fprintf(file, "end\r\nEND:VCARD\r\nBEGIN:VCARD\r\nVERSION:4.0\r\nEND:VCARD\r\n");
+    }
+    fclose(file);
+
+    VCardReader* reader = NULL;
+    CHECK(openVCardReader(tempFile, &reader) == OK);
+    if (reader == NULL) {
+        return;
+    }
+
+    int cards = 0;
+    int errors = 0;
+    bool namesMatch = true;
+    while (true) {
+        Card* card = NULL;
+        VCardErrorCode error = nextCard(reader, &card);
+        if (error != OK) {
+            errors++;
+            continue;
+        }
+        if (card == NULL) {
+            break;
+        }
+
+        char expected[32];
+        sprintf(expected, "Card %d", cards);
+        if (strcmp(getFromFront(card->fn->values), expected) != 0) {
+            namesMatch = false;
+        }
+        cards++;
+        deleteCard(card);
+    }
+    closeVCardReader(reader);
+
+    CHECK(cards == cardCount);
+    CHECK(errors == cardCount);
+    CHECK(namesMatch);
+}
+
+int main(void) {
+    char tempFile[64];
+    sprintf(tempFile, "/tmp/VCardTokenizerTest-%d.vcf", (int)(getpid()));
+
+    testUnfolding();
+    testLineBreaks();
+    testSplitting();
+    testReader(tempFile);
+
+    remove(tempFile);
+    return testSummary("VCardTokenizerTest");
+}
@@ -0,0 +1,323 @@
+/**
+ * @file VCardWriterTest.c
+ * @brief This file contains the tests of the multi-card writer and of writeCards (Atomic replacement and cleanup).
+ * @author ADD LATER
+ */
+
+//Needed for mkdtemp, umask and setrlimit under -std=c11
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <signal.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include "VCardParser.h"
+#include "LinkedListAPI.h"
+#include "VCardTest.h"
+
+//Fixtures holding valid cards (Run from the directory of the makefile)
+static const char* validFixtures[] = {
+    "test/fixtures/testCard.vcf",
+    "test/fixtures/folded.vcf",
+    "test/fixtures/escapes.vcf",
+    "test/fixtures/utf8.vcf"
+};
+#define FIXTURE_COUNT (sizeof(validFixtures) / sizeof(validFixtures[0]))
+
+//Copies of each fixture written into one file
+#define COPIES 150
+
+/**
+ * countEntries: Counts the files in a directory
+ * @param directory: const char* Directory to count
+ * @return int: Number of entries, "." and ".." aside
+ */
+static int countEntries(const char* directory) {
+    DIR* dir = opendir(directory);
+    if (dir == NULL) {
+        return -1;
+    }
+
+    int count = 0;
+    struct dirent* entry = NULL;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+            count++;
+        }
+    }
+    closedir(dir);
+    return count;
+}
+
+/**
+ * emptyDirectory: Removes every file in a directory
+ * @param directory: const char* Directory to empty
+ */
+static void emptyDirectory(const char* directory) {
+    DIR* dir = opendir(directory);
+    if (dir == NULL) {
+        return;
+    }
+
+    struct dirent* entry = NULL;
+    char path[512];
+    while ((entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+            snprintf(path, sizeof(path), "%s/%s", directory, entry->d_name);
+            unlink(path);
+        }
+    }
+    closedir(dir);
+}
+
+/**
+ * fileExists: Checks whether a file exists
+ * @param fileName: const char* File to check
+ * @return bool: true if it exists
+ */
+static bool fileExists(const char* fileName) {
+    struct stat fileStats;
+    return stat(fileName, &fileStats) == 0;
+}
+
+/**
+ * fileMode: Grabs the permission bits of a file
+ * @param fileName: const char* File to check
+ * @return int: The permission bits, -1 if the file does not exist
+ */
+static int fileMode(const char* fileName) {
+    struct stat fileStats;
+    return stat(fileName, &fileStats) == 0 ? (int)(fileStats.st_mode & 07777) : -1;
+}
+
+/**
+ * printFileCard: Parses a single card file
+ * @param fileName: const char* File to read
+ * @return char*: printCard of the card, NULL if it is not valid. Must be freed by the caller
+ */
+static char* printFileCard(const char* fileName) {
+    Card* card = NULL;
+    if (createCard((char*)fileName, &card) != OK) {
+        return NULL;
+    }
+    char* printed = printCard(card);
+    deleteCard(card);
+    return printed;
+}
+
+/**
+ * testWriterRoundTrip: Many cards written by a writer (Atomic or not) read back in order through a reader
+ * @param directory: const char* Directory to write in
+ * @param cards: Card** Cards of the fixtures
+ */
+static void testWriterRoundTrip(const char* directory, Card** cards) {
+    char fileName[256];
+    snprintf(fileName, sizeof(fileName), "%s/export.vcf", directory);
+
+    char* expected[FIXTURE_COUNT];
+    for (size_t i = 0; i < FIXTURE_COUNT; i++) {
+        expected[i] = printCard(cards[i]);
+    }
+
+    WriteOptions atomic = { .atomic = true, .sync = true };
+    const WriteOptions* writeOptions[] = { NULL, &atomic };
+    for (size_t option = 0; option < sizeof(writeOptions) / sizeof(writeOptions[0]); option++) {
+        VCardWriter* writer = NULL;
+        CHECK(openVCardWriter(fileName, writeOptions[option], &writer) == OK);
+        if (writer == NULL) {
+            continue;
+        }
+
+        //A NULL card adds nothing, and the writer carries on
+        CHECK(appendCard(writer, NULL) == WRITE_ERROR);
+        for (int i = 0; i < (int)(FIXTURE_COUNT) * COPIES; i++) {
+            CHECK(appendCard(writer, cards[i % FIXTURE_COUNT]) == OK);
+        }
+        CHECK(closeVCardWriter(writer) == OK);
+        CHECK(countEntries(directory) == 1);
+
+        VCardReader* reader = NULL;
+        CHECK(openVCardReader(fileName, &reader) == OK);
+        if (reader == NULL) {
+            continue;
+        }
+        int count = 0;
+        int mismatches = 0;
+        Card* card = NULL;
+        while (nextCard(reader, &card) == OK && card != NULL) {
+            char* printed = printCard(card);
+            if (strcmp(printed, expected[count % FIXTURE_COUNT]) != 0) {
+                mismatches++;
+            }
+            free(printed);
+            deleteCard(card);
+            count++;
+        }
+        closeVCardReader(reader);
+
+        CHECK(count == (int)(FIXTURE_COUNT) * COPIES);
+        CHECK(mismatches == 0);
+    }
+
+    for (size_t i = 0; i < FIXTURE_COUNT; i++) {
+        free(expected[i]);
+    }
+    emptyDirectory(directory);
+}
+
+/**
+ * testWriterFailure: An atomic writer whose writes fail leaves the old file in place, and no temporary file behind
+ * (Writes are made to fail with a file size limit)
+ * @param directory: const char* Directory to write in
+ * @param cards: Card** Cards of the fixtures
+ */
+static void testWriterFailure(const char* directory, Card** cards) {
+    char fileName[256];
+    snprintf(fileName, sizeof(fileName), "%s/existing.vcf", directory);
+    CHECK(writeCard(fileName, cards[0]) == OK);
+    char* original = printFileCard(fileName);
+    CHECK(original != NULL);
+
+    VCardWriter* writer = NULL;
+    CHECK(openVCardWriter(fileName, &(WriteOptions){ .atomic = true }, &writer) == OK);
+    if (writer != NULL) {
+        //Writes past 64 KB fail with EFBIG instead of killing the test
+        struct rlimit oldLimit;
+        getrlimit(RLIMIT_FSIZE, &oldLimit);
+        struct rlimit limit = { 65536, oldLimit.rlim_max };
+        signal(SIGXFSZ, SIG_IGN);
+        setrlimit(RLIMIT_FSIZE, &limit);
+
+        //The writer buffers about 1 MB before writing - Append until that write fails
+        VCardErrorCode error = OK;
+        for (int i = 0; i < 100000 && error == OK; i++) {
+            error = appendCard(writer, cards[i % FIXTURE_COUNT]);
+        }
+        CHECK(error == WRITE_ERROR);
+        CHECK(appendCard(writer, cards[0]) == WRITE_ERROR);
+
+        setrlimit(RLIMIT_FSIZE, &oldLimit);
+        signal(SIGXFSZ, SIG_DFL);
+
+        CHECK(closeVCardWriter(writer) == WRITE_ERROR);
+    }
+
+    //Only the untouched original is left
+    CHECK(countEntries(directory) == 1);
+    char* reread = printFileCard(fileName);
+    CHECK_STRING(reread, original);
+
+    free(reread);
+    free(original);
+    emptyDirectory(directory);
+}
+
+/**
+ * testWriteCards: writeCards writes every card or none of them, and never leaves temporary files behind
+ * @param directory: const char* Directory to write in
+ * @param cards: Card** Cards of the fixtures
+ */
+static void testWriteCards(const char* directory, Card** cards) {
+    char names[3][256];
+    snprintf(names[0], sizeof(names[0]), "%s/first.vcf", directory);
+    snprintf(names[1], sizeof(names[1]), "%s/second.vcf", directory);
+    const Card* batch[3] = { cards[0], cards[1], cards[2] };
+
+    //A bad name anywhere in the batch - Nothing is written
+    snprintf(names[2], sizeof(names[2]), "%s/third.txt", directory);
+    const char* fileNames[3] = { names[0], names[1], names[2] };
+    CHECK(writeCards(fileNames, batch, 3, NULL) == WRITE_ERROR);
+    CHECK(countEntries(directory) == 0);
+
+    //A name that can not be created - The cards written before it are thrown away
+    snprintf(names[2], sizeof(names[2]), "%s/missing/third.vcf", directory);
+    CHECK(writeCards(fileNames, batch, 3, NULL) == WRITE_ERROR);
+    CHECK(countEntries(directory) == 0);
+
+    //Every card is written, and only the cards are left
+    snprintf(names[2], sizeof(names[2]), "%s/third.vcf", directory);
+    CHECK(writeCards(fileNames, batch, 3, &(WriteOptions){ .sync = true }) == OK);
+    CHECK(countEntries(directory) == 3);
+    for (int i = 0; i < 3; i++) {
+        char* expected = printCard(batch[i]);
+        char* reread = printFileCard(fileNames[i]);
+        CHECK_STRING(reread, expected);
+        free(expected);
+        free(reread);
+    }
+
+    CHECK(writeCards(fileNames, batch, -1, NULL) == WRITE_ERROR);
+    CHECK(writeCards(NULL, batch, 3, NULL) == WRITE_ERROR);
+    emptyDirectory(directory);
+}
+
+/**
+ * testModes: An atomic write keeps the mode of the file it replaces, and gives a new file the umask's mode
+ * @param directory: const char* Directory to write in
+ * @param cards: Card** Cards of the fixtures
+ */
+static void testModes(const char* directory, Card** cards) {
+    char fileName[256];
+    snprintf(fileName, sizeof(fileName), "%s/mode.vcf", directory);
+    WriteOptions atomic = { .atomic = true };
+
+    mode_t oldMask = umask(027);
+    CHECK(writeCardWithOptions(fileName, cards[0], &atomic) == OK);
+    CHECK(fileMode(fileName) == 0640);
+
+    chmod(fileName, 0604);
+    CHECK(writeCardWithOptions(fileName, cards[1], &atomic) == OK);
+    CHECK(fileMode(fileName) == 0604);
+
+    VCardWriter* writer = NULL;
+    CHECK(openVCardWriter(fileName, &atomic, &writer) == OK);
+    CHECK(appendCard(writer, cards[2]) == OK);
+    CHECK(closeVCardWriter(writer) == OK);
+    CHECK(fileMode(fileName) == 0604);
+    umask(oldMask);
+
+    //A name as long as a name can be still leaves room for the temporary file
+    char longName[512];
+    int length = snprintf(longName, sizeof(longName), "%s/", directory);
+    memset(longName + length, 'a', 251);
+    strcpy(longName + length + 251, ".vcf");
+    CHECK(writeCardWithOptions(longName, cards[0], &atomic) == OK);
+    CHECK(fileExists(longName));
+
+    CHECK(countEntries(directory) == 2);
+    emptyDirectory(directory);
+}
+
+int main(void) {
+    char directory[64];
+    sprintf(directory, "/tmp/VCardWriterTest-%d-XXXXXX", (int)(getpid()));
+    CHECK(mkdtemp(directory) != NULL);
+
+    Card* cards[FIXTURE_COUNT] = { NULL };
+    bool loaded = true;
+    for (size_t i = 0; i < FIXTURE_COUNT; i++) {
+        if (createCard((char*)validFixtures[i], &cards[i]) != OK) {
+            printf("Could not read %s\n", validFixtures[i]);
+            loaded = false;
+        }
+    }
+    CHECK(loaded);
+
+    if (loaded) {
+        testWriterRoundTrip(directory, cards);
+        testWriterFailure(directory, cards);
+        testWriteCards(directory, cards);
+        testModes(directory, cards);
+    }
+
+    for (size_t i = 0; i < FIXTURE_COUNT; i++) {
+        deleteCard(cards[i]);
+    }
+    emptyDirectory(directory);
+    rmdir(directory);
+    return testSummary("VCardWriterTest");
+}
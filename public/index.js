@@ -49,17 +49,20 @@ $(document).ready(function() {
     $('#back-to-top').tooltip();
 
     /**
-     * Ajax to load all files found in upload directory into card view dropdown
+     * Ajax to load the file logs of all files found in upload directory
+     * The whole directory is parsed in one request (Invalid files are left out by the server)
      */
     $.ajax({
         type: 'get',
 	dataType: 'json',
-	url: '/uploadDirectory',
+	url: '/fileLogs',
 	success: function(data) {
-	    listOfFileNames = data;
+	    listOfFileNames = data.map(function(fileLog) {
+		return fileLog.file;
+	    });
 
-	    if (listOfFileNames.length === 0) {
-                $("#file_log_table tbody").remove();
+            $("#file_log_table tbody").remove();
+	    if (data.length === 0) {
 		//Set tables to "No Data"
                 let newTable = "<tbody><tr>"
 			+ "<td>No Files</td>"
@@ -68,35 +71,20 @@ $(document).ready(function() {
 			+ "</tr></tbody>";
 		$("#file_log_table").append(newTable);
 	    }
-	    for (j = 0; j < listOfFileNames.length; j++) {
-		let currentFile = listOfFileNames[j];
+	    for (let j = 0; j < data.length; j++) {
+		let currentFile = data[j].file;
                 /**
-                 * Use listOfFileNames to create all of the necessary cards from
-                 * upload folder.
-                 * Populate File Log table using file name and returned JSON from 
-                 * dynamic library function
+                 * Populate the card view dropdown and the File Log table using
+                 * the file name and its file log
                  */
-                $("#file_log_table tbody").remove();
-                $.ajax({
-                    type: 'get',
-	            dataType: 'json',
-	            data: {file:currentFile},
-	            url: '/fileLog',
-	            success: function(data) {
-			console.log(data);
-                        $("#card_view_dropdown").append(new Option(currentFile, j));
-			let newTable = "<tbody><tr>"
-			+ "<td><a class=\"file_log_link\" href=\"uploads/" + currentFile + "\">" + currentFile + "</a></td>"
-			+ "<td>" + data.indiname + "</td>"
-			+ "<td>" + data.addiprops + "</td>"
-			+ "</tr></tbody>";
-
-	                $("#file_log_table").append(newTable);
-	            },
-	            fail: function(error) {
-                        console.log(error);
-	            }
-                });
+                $("#card_view_dropdown").append(new Option(currentFile, j));
+		let newTable = "<tbody><tr>"
+		+ "<td><a class=\"file_log_link\" href=\"uploads/" + currentFile + "\">" + currentFile + "</a></td>"
+		+ "<td>" + data[j].indiname + "</td>"
+		+ "<td>" + data[j].addiprops + "</td>"
+		+ "</tr></tbody>";
+
+	        $("#file_log_table").append(newTable);
 	    }
 	},
 	fail: function(error) {